@@ -0,0 +1,359 @@
+/*
+    Decompressor.cpp
+
+    Implementation file for the decompression of compressed input on its own thread.
+*/
+
+#include "Decompressor.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <errno.h>
+#include <sys/types.h>
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#define READ ::read
+#else
+#include <BaseTsd.h>
+#include <io.h>
+typedef SSIZE_T ssize_t;
+#define READ ::_read
+#endif
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// size of a decompressed block
+const std::size_t DECOMPRESSED_BLOCK_SIZE = 256 * 1024;
+
+// number of decompressed blocks in the queue
+const std::size_t QUEUE_SIZE = 8;
+
+// size of a read of the compressed input
+const std::size_t COMPRESSED_READ_SIZE = 128 * 1024;
+
+// size of the fixed part of a zip local file header
+const std::size_t ZIP_HEADER_SIZE = 30;
+
+namespace {
+
+    // little-endian 16-bit value
+    std::uint32_t load16(const char* p) {
+        return static_cast<unsigned char>(p[0]) | (static_cast<unsigned char>(p[1]) << 8);
+    }
+
+    // little-endian 32-bit value
+    std::uint32_t load32(const char* p) {
+        return load16(p) | (load16(p + 2) << 16);
+    }
+}
+
+// format of the input from its first bytes
+Decompressor::Format Decompressor::detect(std::string_view start) {
+    if (start.substr(0, 2) == "\x1F\x8B"sv)
+        return Format::GZIP;
+    if (start.substr(0, 4) == "PK\x03\x04"sv)
+        return Format::ZIP;
+    if (start.substr(0, 4) == "\x28\xB5\x2F\xFD"sv)
+        return Format::ZSTD;
+    return Format::NONE;
+}
+
+// constructor, starting the thread to decompress the input
+// The start of the input has already been read from the file descriptor
+Decompressor::Decompressor(Format format, std::string_view start, int fd)
+    : format(format), fd(fd), input(start.begin(), start.end()), inputPosition(0),
+      block(DECOMPRESSED_BLOCK_SIZE), blockSize(0), readBlockSize(0), readPosition(0),
+      done(false), failed(false), stopped(false) {
+
+    thread = std::thread(&Decompressor::run, this);
+}
+
+// destructor, stopping the thread
+Decompressor::~Decompressor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+// read the next decompressed bytes into the buffer
+// @return Number of bytes read, 0 at the end of the input, or -1 on error
+long Decompressor::read(char* buffer, std::size_t size) {
+    std::size_t bytesRead = 0;
+    while (bytesRead < size) {
+        if (readPosition == readBlockSize) {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            // only wait for a block when nothing has been read yet
+            if (bytesRead > 0 && queue.empty())
+                break;
+            if (!readBlock.empty())
+                freeBlocks.push_back(std::move(readBlock));
+            readBlock = std::vector<char>();
+            readBlockSize = 0;
+            readPosition = 0;
+            changed.wait(lock, [this]() { return !queue.empty() || done; });
+            if (queue.empty()) {
+                if (failed)
+                    return -1;
+                break;
+            }
+            readBlock = std::move(queue.front().first);
+            readBlockSize = queue.front().second;
+            queue.pop_front();
+            changed.notify_all();
+        }
+        const auto count = std::min(size - bytesRead, readBlockSize - readPosition);
+        std::memcpy(buffer + bytesRead, readBlock.data() + readPosition, count);
+        readPosition += count;
+        bytesRead += count;
+    }
+    return static_cast<long>(bytesRead);
+}
+
+// decompress the input, on the thread
+void Decompressor::run() {
+    bool success = false;
+    switch (format) {
+    case Format::GZIP:
+        success = decompressGzip();
+        break;
+    case Format::ZIP:
+        success = decompressZip();
+        break;
+    case Format::ZSTD:
+        success = decompressZstd();
+        break;
+    case Format::NONE:
+        break;
+    }
+
+    // the last block is partial
+    if (success && blockSize > 0)
+        success = queueBlock();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    failed = !success;
+    changed.notify_all();
+}
+
+#ifdef HAVE_ZLIB
+namespace {
+
+    // inflate the input into blocks, with the window bits selecting the zlib format
+    // With multiple members, e.g., concatenated gzip files, inflate continues after the
+    // end of a member until the end of the input
+    template <class FillInput, class QueueBlock>
+    bool inflateInput(int windowBits, bool multipleMembers, std::vector<char>& input, std::size_t& inputPosition,
+                      std::vector<char>& block, std::size_t& blockSize, FillInput fillInput, QueueBlock queueBlock) {
+
+        z_stream stream{};
+        if (inflateInit2(&stream, windowBits) != Z_OK) {
+            std::cerr << "parser error : Unable to start decompression\n";
+            return false;
+        }
+        stream.next_in = reinterpret_cast<Bytef*>(input.data() + inputPosition);
+        stream.avail_in = static_cast<uInt>(input.size() - inputPosition);
+        bool endOfInput = false;
+        bool inMember = true;
+        bool success = true;
+        while (true) {
+            if (stream.avail_in == 0 && !endOfInput) {
+                inputPosition = input.size();
+                endOfInput = !fillInput();
+                stream.next_in = reinterpret_cast<Bytef*>(input.data() + inputPosition);
+                stream.avail_in = static_cast<uInt>(input.size() - inputPosition);
+            }
+            if (!inMember) {
+                if (!multipleMembers || (stream.avail_in == 0 && endOfInput))
+                    break;
+                inflateReset(&stream);
+                inMember = true;
+            }
+            stream.next_out = reinterpret_cast<Bytef*>(block.data() + blockSize);
+            stream.avail_out = static_cast<uInt>(block.size() - blockSize);
+            const int status = inflate(&stream, Z_NO_FLUSH);
+            blockSize = block.size() - stream.avail_out;
+            if (status == Z_STREAM_END) {
+                inMember = false;
+            } else if (status == Z_BUF_ERROR && stream.avail_in == 0 && endOfInput) {
+                std::cerr << "parser error : Truncated compressed input\n";
+                success = false;
+                break;
+            } else if (status != Z_OK && status != Z_BUF_ERROR) {
+                std::cerr << "parser error : Invalid compressed input\n";
+                success = false;
+                break;
+            }
+            if (blockSize == block.size() && !queueBlock()) {
+                success = false;
+                break;
+            }
+        }
+        inflateEnd(&stream);
+        return success;
+    }
+}
+#endif
+
+// decompress a gzip stream, including concatenated members
+bool Decompressor::decompressGzip() {
+#ifdef HAVE_ZLIB
+    // window bits with 16 added is the gzip format
+    return inflateInput(16 + MAX_WBITS, true, input, inputPosition, block, blockSize,
+                        [this]() { return fillInput(); }, [this]() { return queueBlock(); });
+#else
+    std::cerr << "parser error : gzip input is not supported by this build, which has no zlib\n";
+    return false;
+#endif
+}
+
+// decompress the first member of a zip archive
+bool Decompressor::decompressZip() {
+#ifdef HAVE_ZLIB
+    // local file header of the first member
+    while (input.size() - inputPosition < ZIP_HEADER_SIZE) {
+        if (!fillInput()) {
+            std::cerr << "parser error : Truncated zip input\n";
+            return false;
+        }
+    }
+    const char* header = input.data() + inputPosition;
+    const auto flags = load16(header + 6);
+    const auto method = load16(header + 8);
+    const auto compressedSize = load32(header + 18);
+    const auto headerSize = ZIP_HEADER_SIZE + load16(header + 26) + load16(header + 28);
+    while (input.size() - inputPosition < headerSize) {
+        if (!fillInput()) {
+            std::cerr << "parser error : Truncated zip input\n";
+            return false;
+        }
+    }
+    inputPosition += headerSize;
+
+    // deflated member, the end of the deflate stream is the end of the member
+    if (method == 8) {
+        // negative window bits is a raw deflate stream
+        return inflateInput(-MAX_WBITS, false, input, inputPosition, block, blockSize,
+                            [this]() { return fillInput(); }, [this]() { return queueBlock(); });
+    }
+
+    // stored member, with the size in the header
+    // bit 3 of the flags is a size after the data, and 0xFFFFFFFF a size in the zip64 extra field
+    if (method != 0 || (flags & 0x08) || compressedSize == 0xFFFFFFFF) {
+        std::cerr << "parser error : Unsupported zip member, only deflated or stored with a size\n";
+        return false;
+    }
+    std::size_t remaining = compressedSize;
+    while (remaining > 0) {
+        if (inputPosition == input.size() && !fillInput()) {
+            std::cerr << "parser error : Truncated zip input\n";
+            return false;
+        }
+        const auto count = std::min({ remaining, input.size() - inputPosition, block.size() - blockSize });
+        std::memcpy(block.data() + blockSize, input.data() + inputPosition, count);
+        inputPosition += count;
+        blockSize += count;
+        remaining -= count;
+        if (blockSize == block.size() && !queueBlock())
+            return false;
+    }
+    return true;
+#else
+    std::cerr << "parser error : zip input is not supported by this build, which has no zlib\n";
+    return false;
+#endif
+}
+
+// decompress a zstd stream
+bool Decompressor::decompressZstd() {
+#ifdef HAVE_ZSTD
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    ZSTD_initDStream(stream);
+    ZSTD_inBuffer in{ input.data() + inputPosition, input.size() - inputPosition, 0 };
+    bool endOfInput = false;
+    bool success = true;
+
+    // 0 is a complete frame with all of its output flushed
+    std::size_t result = 1;
+    while (true) {
+        if (in.pos == in.size && !endOfInput) {
+            inputPosition = input.size();
+            endOfInput = !fillInput();
+            in = ZSTD_inBuffer{ input.data() + inputPosition, input.size() - inputPosition, 0 };
+        }
+        if (in.pos == in.size && endOfInput && result == 0)
+            break;
+        ZSTD_outBuffer out{ block.data() + blockSize, block.size() - blockSize, 0 };
+        result = ZSTD_decompressStream(stream, &out, &in);
+        if (ZSTD_isError(result)) {
+            std::cerr << "parser error : Invalid zstd input, " << ZSTD_getErrorName(result) << '\n';
+            success = false;
+            break;
+        }
+        blockSize += out.pos;
+        if (blockSize == block.size() && !queueBlock()) {
+            success = false;
+            break;
+        }
+
+        // no progress at the end of the input is an incomplete frame
+        if (in.pos == in.size && endOfInput && result != 0 && out.pos == 0) {
+            std::cerr << "parser error : Truncated compressed input\n";
+            success = false;
+            break;
+        }
+    }
+    ZSTD_freeDStream(stream);
+    return success;
+#else
+    std::cerr << "parser error : zstd input is not supported by this build, which has no zstd\n";
+    return false;
+#endif
+}
+
+// read more compressed input, keeping the unused input
+// @return false at the end of the input
+bool Decompressor::fillInput() {
+    input.erase(input.begin(), input.begin() + inputPosition);
+    inputPosition = 0;
+    const auto used = input.size();
+    input.resize(used + COMPRESSED_READ_SIZE);
+    ssize_t bytesRead = 0;
+    while (((bytesRead = READ(fd, input.data() + used, COMPRESSED_READ_SIZE)) == -1) && (errno == EINTR)) {
+    }
+    input.resize(used + (bytesRead > 0 ? bytesRead : 0));
+    return bytesRead > 0;
+}
+
+// queue a full block for the parser and get an empty block
+bool Decompressor::queueBlock() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return queue.size() < QUEUE_SIZE || stopped; });
+    if (stopped)
+        return false;
+    queue.emplace_back(std::move(block), blockSize);
+    changed.notify_all();
+    if (!freeBlocks.empty()) {
+        block = std::move(freeBlocks.back());
+        freeBlocks.pop_back();
+    } else {
+        block = std::vector<char>(DECOMPRESSED_BLOCK_SIZE);
+    }
+    blockSize = 0;
+    return true;
+}
@@ -0,0 +1,101 @@
+/*
+    Decompressor.hpp
+
+    Header file for the decompression of compressed input on its own thread.
+
+    The thread reads the compressed input, decompresses it into blocks, and
+    queues the blocks for the parser. The queue has a fixed number of blocks,
+    so the thread waits when the parser falls behind. Supported formats are
+    gzip and zip (first member, deflated or stored) with zlib, and zstd, when
+    the libraries are found by the build.
+*/
+
+#ifndef DECOMPRESSOR_HPP
+#define DECOMPRESSOR_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+class Decompressor {
+public:
+    // compression formats
+    enum class Format { NONE, GZIP, ZIP, ZSTD };
+
+    // format of the input from its first bytes
+    static Format detect(std::string_view start);
+
+    // constructor, starting the thread to decompress the input
+    // The start of the input has already been read from the file descriptor
+    Decompressor(Format format, std::string_view start, int fd);
+
+    // no copies of the thread
+    Decompressor(const Decompressor&) = delete;
+    Decompressor& operator=(const Decompressor&) = delete;
+
+    // destructor, stopping the thread
+    ~Decompressor();
+
+    // read the next decompressed bytes into the buffer
+    // @return Number of bytes read, 0 at the end of the input, or -1 on error
+    long read(char* buffer, std::size_t size);
+
+private:
+    // decompress the input, on the thread
+    void run();
+
+    // decompress a gzip stream, including concatenated members
+    bool decompressGzip();
+
+    // decompress the first member of a zip archive
+    bool decompressZip();
+
+    // decompress a zstd stream
+    bool decompressZstd();
+
+    // read more compressed input, keeping the unused input
+    // @return false at the end of the input
+    bool fillInput();
+
+    // queue a full block for the parser and get an empty block
+    bool queueBlock();
+
+    Format format;
+
+    int fd;
+
+    // compressed input, with the unused part starting at inputPosition
+    std::vector<char> input;
+    std::size_t inputPosition;
+
+    // block being decompressed into, with its used size
+    std::vector<char> block;
+    std::size_t blockSize;
+
+    // queue of decompressed blocks for the parser, with their used sizes
+    std::deque<std::pair<std::vector<char>, std::size_t>> queue;
+
+    // empty blocks for reuse
+    std::vector<std::vector<char>> freeBlocks;
+
+    // block being read by the parser, with the read position
+    std::vector<char> readBlock;
+    std::size_t readBlockSize;
+    std::size_t readPosition;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    bool done;
+    bool failed;
+    bool stopped;
+
+    std::thread thread;
+};
+
+#endif
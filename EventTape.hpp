@@ -0,0 +1,88 @@
+/*
+    EventTape.hpp
+
+    Binary format of an event tape, a recording of the XMLParserHandler events
+    of a parse. Replaying the tape calls the same handlers with the same
+    arguments, without tokenizing the XML again.
+
+    Tape file layout, in the byte order of the machine:
+    * Header: magic "SRCFTAPE", version, name count, block count, sizes of the sections
+    * Blocks: the events in order, written during the parse so the writer only
+      holds one block. Each block is the sizes of its pool and events, then:
+      * Pool: the character content, attribute values, and other strings of the
+        events of the block, in event order
+      * Events: an event code followed by its operands as LEB128 variable-length
+        integers. A name is an ID into the names, a string is a length, with the
+        offset implicit as the next bytes of the pool.
+    * Names: each interned qualified name as a length and the characters
+
+    Start tags include the depth of the element, root is 1.
+*/
+
+#ifndef EVENTTAPE_HPP
+#define EVENTTAPE_HPP
+
+#include <cstdint>
+
+namespace event_tape {
+
+    constexpr char MAGIC[8] = { 'S', 'R', 'C', 'F', 'T', 'A', 'P', 'E' };
+
+    constexpr std::uint32_t VERSION = 2;
+
+    // header of the tape file
+    struct TapeHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t nameCount;
+        std::uint64_t inputBytes;
+        std::uint64_t blockCount;
+        std::uint64_t blocksSize;
+        std::uint64_t namesSize;
+    };
+
+    // header of a block of events, followed by its pool and its events
+    // A block ends at the end of an event, so the strings of an event are in its pool
+    struct TapeBlockHeader {
+        std::uint64_t poolSize;
+        std::uint64_t eventsSize;
+    };
+
+    // event codes, with the operands of the event
+    enum class TapeEvent : unsigned char {
+        START_DOCUMENT,           // none
+        XML_DECLARATION,          // flags (1 encoding, 2 standalone), version, [encoding], [standalone]
+        START_TAG,                // name, depth
+        END_TAG,                  // name
+        CHARACTERS,               // characters
+        ATTRIBUTE,                // name, value
+        XML_NAMESPACE,            // prefix, uri
+        XML_COMMENT,              // value
+        CDATA,                    // characters
+        PROCESSING_INSTRUCTION,   // target, data
+        END_DOCUMENT,             // none
+    };
+
+    // append the LEB128 encoding of the value
+    template <class Output>
+    inline void writeVarint(Output& output, std::uint64_t value) {
+        while (value >= 0x80) {
+            output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        output.push_back(static_cast<char>(value));
+    }
+
+    // read the LEB128 encoding of a value, advancing the position
+    inline std::uint64_t readVarint(const unsigned char*& p) {
+        std::uint64_t value = *p & 0x7F;
+        int shift = 7;
+        while (*p++ & 0x80) {
+            value |= static_cast<std::uint64_t>(*p & 0x7F) << shift;
+            shift += 7;
+        }
+        return value;
+    }
+}
+
+#endif
@@ -0,0 +1,314 @@
+/*
+    FilterHandler.cpp
+
+    Implementation file for the handler that filters srcML in one streaming pass.
+*/
+
+#include "FilterHandler.hpp"
+#include "xml_parser.hpp"
+#include <iostream>
+#include <algorithm>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // whether the name is in the names
+    bool contains(const std::vector<std::string>& names, std::string_view name) {
+        return std::find(names.begin(), names.end(), name) != names.end();
+    }
+
+    // start of the attribute or namespace declaration with the value, with the whitespace before it
+    // The name and '=' of a parsed attribute are before the quote of the value
+    const char* attributeBegin(const char* value) {
+        using xml_parser::isClass;
+        using xml_parser::WHITESPACE_CHARACTER;
+
+        auto p = value - "\""sv.size() - 1;
+        while (isClass(*p, WHITESPACE_CHARACTER))
+            --p;
+        p -= "="sv.size();
+        while (isClass(*p, WHITESPACE_CHARACTER))
+            --p;
+        while (!isClass(*p, WHITESPACE_CHARACTER))
+            --p;
+        while (isClass(*p, WHITESPACE_CHARACTER))
+            --p;
+        return p + 1;
+    }
+}
+
+// constructor
+FilterHandler::FilterHandler()
+    : droppingComments(false), droppingWhitespace(false), filteringElements(false), copied(nullptr), attributesEnd(nullptr), depth(0),
+      droppedDepth(0), whitespaceBegin(nullptr), whitespaceEnd(nullptr), holdingWhitespace(false), afterText(false),
+      commentEnd(nullptr), outputBytes(0), dropCount(0) {}
+
+// drop the attribute with the qualified name, e.g., pos:start
+void FilterHandler::dropAttribute(std::string_view qName) {
+    droppedAttributes.emplace_back(qName);
+}
+
+// drop the namespace declaration of the prefix, with the attributes and elements in it
+void FilterHandler::dropNamespace(std::string_view prefix) {
+    droppedNamespaces.emplace_back(prefix);
+    filteringElements = true;
+}
+
+// drop the element with the qualified name, with its content
+void FilterHandler::dropElement(std::string_view qName) {
+    droppedElements.emplace_back(qName);
+    filteringElements = true;
+}
+
+// drop XML comments, and srcML comment elements
+void FilterHandler::dropComments() {
+    droppingComments = true;
+    dropElement("comment"sv);
+}
+
+// drop whitespace-only text, e.g., the indentation of the elements
+// The whitespace is part of the source code, so the source code changes
+void FilterHandler::dropWhitespace() {
+    droppingWhitespace = true;
+}
+
+// rename the element with the qualified name
+void FilterHandler::renameElement(std::string_view qName, std::string_view newQName) {
+    renames.emplace_back(qName, newQName);
+    filteringElements = true;
+}
+
+// get the number of bytes output
+long FilterHandler::getOutputBytes() {
+    return outputBytes;
+}
+
+// get the number of dropped attributes, namespaces, elements, comments, and whitespace
+long FilterHandler::getDropCount() {
+    return dropCount;
+}
+
+// write the input not yet copied up to the position
+void FilterHandler::copyTo(const char* position) {
+    if (position > copied) {
+        write(std::string_view(copied, position - copied));
+    }
+    copied = position;
+}
+
+// write the output, in parts of at least the output buffer size
+void FilterHandler::write(std::string_view text) {
+    outputBytes += static_cast<long>(text.size());
+    if (output.size() + text.size() > OUTPUT_SIZE)
+        flush();
+    if (text.size() >= OUTPUT_SIZE)
+        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+    else
+        output.append(text);
+}
+
+// write the output buffer
+void FilterHandler::flush() {
+    std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+    output.clear();
+}
+
+// drop the input from the begin to the end, after the input before it is copied
+void FilterHandler::drop(const char* begin, const char* end) {
+    copyTo(begin);
+    copied = end;
+    ++dropCount;
+}
+
+// drop the pending whitespace-only text, as the event after it is not text
+void FilterHandler::dropPendingWhitespace() {
+    if (whitespaceBegin) {
+        drop(whitespaceBegin, whitespaceEnd);
+        whitespaceBegin = nullptr;
+    } else if (holdingWhitespace) {
+        holdingWhitespace = false;
+        ++dropCount;
+    }
+    afterText = false;
+}
+
+// keep the pending whitespace-only text, as text follows it
+// The held whitespace is written before the input after it, as none of it is written yet
+void FilterHandler::keepPendingWhitespace() {
+    whitespaceBegin = nullptr;
+    if (holdingWhitespace) {
+        write(heldWhitespace);
+        holdingWhitespace = false;
+    }
+}
+
+// the whitespace after a comment up to the next event is pending whitespace-only text
+void FilterHandler::pendCommentWhitespace(const char* next) {
+    if (next > commentEnd) {
+        whitespaceBegin = commentEnd;
+        whitespaceEnd = next;
+    }
+    commentEnd = nullptr;
+}
+
+// new name of a renamed element, or nullptr
+const std::string* FilterHandler::findRename(std::string_view qName) {
+    for (const auto& [from, to] : renames) {
+        if (from == qName)
+            return &to;
+    }
+    return nullptr;
+}
+
+// Start Tag Handler
+void FilterHandler::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+
+    ++depth;
+    if (commentEnd)
+        pendCommentWhitespace(qName.data() - "<"sv.size());
+    dropPendingWhitespace();
+    attributesEnd = qName.data() + qName.size();
+    if (droppedDepth > 0) {
+        ++droppedDepth;
+        return;
+    }
+    if (!filteringElements)
+        return;
+
+    if (contains(droppedElements, qName) || (!prefix.empty() && contains(droppedNamespaces, prefix))) {
+        // the element starts at the '<' of its start tag
+        drop(qName.data() - "<"sv.size(), qName.data());
+        droppedDepth = 1;
+        return;
+    }
+    if (const auto newQName = findRename(qName)) {
+        copyTo(qName.data());
+        write(*newQName);
+        copied = qName.data() + qName.size();
+    }
+}
+
+// End Tag Handler
+// The end of an empty element has the qName of its start tag, not of an end tag
+void FilterHandler::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+
+    --depth;
+    const bool isEndTag = qName.data()[-1] == '/';
+    if (commentEnd)
+        pendCommentWhitespace(qName.data() - "</"sv.size());
+    dropPendingWhitespace();
+    if (droppedDepth > 0) {
+        if (--droppedDepth > 0)
+            return;
+
+        // the dropped element ends at the '>' of its end tag, or of its empty start tag
+        auto end = isEndTag ? qName.data() + qName.size() : attributesEnd;
+        while (*end != '>')
+            ++end;
+        copied = end + ">"sv.size();
+        return;
+    }
+    if (!filteringElements || !isEndTag)
+        return;
+
+    if (const auto newQName = findRename(qName)) {
+        copyTo(qName.data());
+        write(*newQName);
+        copied = qName.data() + qName.size();
+    }
+}
+
+// Character Handler
+// Whitespace-only text is dropped when neither side of it is text, e.g., the
+// whitespace between a name and an entity reference is kept
+void FilterHandler::handleCharacter(std::string_view characters) {
+
+    if (droppedDepth > 0 || !droppingWhitespace)
+        return;
+
+    if (whitespaceBegin || holdingWhitespace || commentEnd) {
+        // the whitespace is part of this text
+        commentEnd = nullptr;
+        keepPendingWhitespace();
+    } else if (!afterText && xml_parser::findNotClass(characters, xml_parser::WHITESPACE_CHARACTER) == characters.npos) {
+        whitespaceBegin = characters.data();
+        whitespaceEnd = characters.data() + characters.size();
+    }
+    afterText = true;
+}
+
+// attribute Handler
+void FilterHandler::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+
+    attributesEnd = value.data() + value.size() + "\""sv.size();
+    if (droppedDepth > 0)
+        return;
+
+    if (contains(droppedAttributes, qName) || (!prefix.empty() && contains(droppedNamespaces, prefix)))
+        drop(attributeBegin(value.data()), attributesEnd);
+}
+
+// XML Namespace Handler
+void FilterHandler::handleXMLNamespace(std::string_view prefix, std::string_view uri) {
+
+    attributesEnd = uri.data() + uri.size() + "\""sv.size();
+    if (droppedDepth > 0)
+        return;
+
+    if (contains(droppedNamespaces, prefix))
+        drop(attributeBegin(uri.data()), attributesEnd);
+}
+
+// XML Comment Handler
+void FilterHandler::handleXMLComment(std::string_view value) {
+
+    if (commentEnd)
+        pendCommentWhitespace(value.data() - "<!--"sv.size());
+    dropPendingWhitespace();
+    if (droppedDepth > 0)
+        return;
+
+    const auto end = value.data() + value.size() + "-->"sv.size();
+    if (droppingWhitespace && depth > 0)
+        commentEnd = end;
+    if (droppingComments)
+        drop(value.data() - "<!--"sv.size(), end);
+}
+
+// CDATA Handler
+void FilterHandler::handleCDATA(std::string_view characters) {
+
+    if (droppedDepth > 0 || !droppingWhitespace)
+        return;
+
+    // CDATA is text, so the whitespace-only text before it is part of the text
+    commentEnd = nullptr;
+    keepPendingWhitespace();
+    afterText = true;
+}
+
+// input start Handler
+void FilterHandler::handleInputStart(std::string_view input) {
+    copied = input.data();
+}
+
+// input end Handler
+// Whitespace-only text at the end of the input is held, as what follows it is not known yet
+void FilterHandler::handleInputEnd(std::string_view unparsed) {
+
+    if (droppedDepth > 0)
+        return;
+    if (commentEnd)
+        pendCommentWhitespace(unparsed.data());
+    if (whitespaceBegin) {
+        copyTo(whitespaceBegin);
+        heldWhitespace.assign(whitespaceBegin, whitespaceEnd);
+        holdingWhitespace = true;
+        copied = whitespaceEnd;
+        whitespaceBegin = nullptr;
+    }
+    copyTo(unparsed.data());
+    flush();
+}
@@ -0,0 +1,155 @@
+/*
+    FilterHandler.hpp
+
+    Handler that filters srcML in one streaming pass, e.g., to drop the position
+    attributes, comments, and whitespace of an archive shipped between stages.
+
+    Unlike IdentityHandler, the events are not serialized. The input between the
+    changes is copied verbatim, so the output is byte for byte the input when
+    nothing is filtered. Each change writes the input up to it, and continues the
+    copy after it, e.g., a dropped attribute from the whitespace before its name
+    to its closing quote, and a renamed element by writing the new name in place
+    of the name of the start and end tag. The handler finds the bytes of a change
+    from the views of the event, so it requires the events from the parser with
+    the views in the input (see FilterParserPolicy), and is told of each refill
+    (see XMLParserHandler::handleInputEnd()).
+*/
+
+#ifndef FILTERHANDLER_HPP
+#define FILTERHANDLER_HPP
+
+#include "XMLParserHandler.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+class FilterHandler : public XMLParserHandler {
+public:
+    // constructor
+    FilterHandler();
+
+    // drop the attribute with the qualified name, e.g., pos:start
+    void dropAttribute(std::string_view qName);
+
+    // drop the namespace declaration of the prefix, with the attributes and elements in it
+    void dropNamespace(std::string_view prefix);
+
+    // drop the element with the qualified name, with its content
+    void dropElement(std::string_view qName);
+
+    // drop XML comments, and srcML comment elements
+    void dropComments();
+
+    // drop whitespace-only text, e.g., the indentation of the elements
+    // The whitespace is part of the source code, so the source code changes
+    void dropWhitespace();
+
+    // rename the element with the qualified name
+    void renameElement(std::string_view qName, std::string_view newQName);
+
+    // get the number of bytes output
+    long getOutputBytes();
+
+    // get the number of dropped attributes, namespaces, elements, comments, and whitespace
+    long getDropCount();
+
+protected:
+    // Start Tag Handler
+    void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // End Tag Handler
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // Character Handler
+    void handleCharacter(std::string_view characters) override;
+
+    // attribute Handler
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+
+    // XML Namespace Handler
+    void handleXMLNamespace(std::string_view prefix, std::string_view uri) override;
+
+    // XML Comment Handler
+    void handleXMLComment(std::string_view value) override;
+
+    // CDATA Handler
+    void handleCDATA(std::string_view characters) override;
+
+    // input start Handler
+    void handleInputStart(std::string_view input) override;
+
+    // input end Handler
+    void handleInputEnd(std::string_view unparsed) override;
+
+private:
+    // write the output, in parts of at least the output buffer size
+    void write(std::string_view text);
+
+    // write the output buffer
+    void flush();
+
+    // write the input not yet copied up to the position
+    void copyTo(const char* position);
+
+    // drop the input from the begin to the end, after the input before it is copied
+    void drop(const char* begin, const char* end);
+
+    // drop the pending whitespace-only text, as the event after it is not text
+    void dropPendingWhitespace();
+
+    // keep the pending whitespace-only text, as text follows it
+    void keepPendingWhitespace();
+
+    // the whitespace after a comment up to the next event is pending whitespace-only text
+    void pendCommentWhitespace(const char* next);
+
+    // new name of a renamed element, or nullptr
+    const std::string* findRename(std::string_view qName);
+
+    // size of the output buffer, so the small parts between the changes are one write
+    static constexpr std::size_t OUTPUT_SIZE = 64 * 1024;
+
+    // data members
+    std::vector<std::string> droppedAttributes;
+    std::vector<std::string> droppedNamespaces;
+    std::vector<std::string> droppedElements;
+    std::vector<std::pair<std::string, std::string>> renames;
+    bool droppingComments;
+    bool droppingWhitespace;
+
+    // whether any filter is on start and end tags, so the other tags are passed quickly
+    bool filteringElements;
+
+    // start of the input not yet copied or dropped
+    const char* copied;
+
+    // end of the name and attributes of the last start tag, i.e., before its '>' or "/>"
+    const char* attributesEnd;
+
+    // depth of the element in the document, with the root at 1
+    int depth;
+
+    // depth in a dropped element, or 0 when not in one
+    int droppedDepth;
+
+    // whitespace-only text that is dropped unless text follows it
+    const char* whitespaceBegin;
+    const char* whitespaceEnd;
+
+    // whitespace-only text at the end of the input before a refill, held until the next event
+    std::string heldWhitespace;
+    bool holdingWhitespace;
+
+    // whether the last event was text, so whitespace after it is part of that text
+    bool afterText;
+
+    // end of the last comment in an element, as the parser does not report the whitespace after it
+    const char* commentEnd;
+
+    std::string output;
+    long outputBytes;
+    long dropCount;
+};
+
+#endif
@@ -68,6 +68,11 @@ void IdentityHandler::handleStartTag(std::string_view qName, std::string_view pr
 
 // End Tag Handler
 void IdentityHandler::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+    if (unclosedBrackets > 0) {
+            --unclosedBrackets;
+            std::cout << "/>";
+            return;
+    }
     std::cout << "</" <<  qName << ">";
 }
 
@@ -0,0 +1,132 @@
+/*
+    JSONReader.cpp
+
+    Implementation file for the reader of the small JSON files of the
+    applications, and the writing of a JSON string.
+*/
+
+#include "JSONReader.hpp"
+#include "xml_parser.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+// write the string as a JSON string
+void writeJSONString(std::ostream& out, std::string_view value) {
+    out << '"';
+    for (const auto c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// constructor, with the kind of the file for the errors, e.g., "partial"
+JSONReader::JSONReader(std::string_view content, const std::string& filename, std::string_view kind)
+    : content(content), filename(filename), kind(kind) {}
+
+// expect the character, after whitespace
+void JSONReader::expect(char c) {
+    if (!accept(c))
+        error(std::string("Expected '") + c + "'");
+}
+
+// accept the character, after whitespace
+bool JSONReader::accept(char c) {
+    xml_parser::skipWhitespace(content);
+    if (content.empty() || content[0] != c)
+        return false;
+    content.remove_prefix(1);
+    return true;
+}
+
+// the next value is a string
+bool JSONReader::isString() {
+    xml_parser::skipWhitespace(content);
+    return !content.empty() && content[0] == '"';
+}
+
+// read a string
+std::string JSONReader::readString() {
+    expect('"');
+    std::string value;
+    while (!content.empty() && content[0] != '"') {
+        if (content[0] != '\\') {
+            value += content[0];
+            content.remove_prefix(1);
+            continue;
+        }
+        if (content.size() < 2)
+            error("Unterminated string");
+        const auto escaped = content[1];
+        content.remove_prefix(2);
+        switch (escaped) {
+        case '"': case '\\': case '/':
+            value += escaped;
+            break;
+        case 'b': value += '\b'; break;
+        case 'f': value += '\f'; break;
+        case 'n': value += '\n'; break;
+        case 'r': value += '\r'; break;
+        case 't': value += '\t'; break;
+        case 'u': {
+            if (content.size() < 4)
+                error("Invalid escape in string");
+            const auto code = std::stoul(std::string(content.substr(0, 4)), nullptr, 16);
+            content.remove_prefix(4);
+            appendUTF8(value, static_cast<std::uint32_t>(code));
+            break;
+        }
+        default:
+            error("Invalid escape in string");
+        }
+    }
+    expect('"');
+    return value;
+}
+
+// read an integer
+long JSONReader::readInteger() {
+    xml_parser::skipWhitespace(content);
+    std::size_t length = 0;
+    if (length < content.size() && content[length] == '-')
+        ++length;
+    while (length < content.size() && content[length] >= '0' && content[length] <= '9')
+        ++length;
+    if (length == 0 || content[length - 1] == '-')
+        error("Expected an integer");
+    const auto value = std::stol(std::string(content.substr(0, length)));
+    content.remove_prefix(length);
+    return value;
+}
+
+// at the end of the content
+bool JSONReader::atEnd() {
+    xml_parser::skipWhitespace(content);
+    return content.empty();
+}
+
+// report the error, and exit
+void JSONReader::error(const std::string& message) {
+    std::cerr << kind << " error : " << message << " in " << filename << '\n';
+    exit(1);
+}
+
+// append the UTF-8 encoding of the code point in the Basic Multilingual Plane
+void JSONReader::appendUTF8(std::string& value, std::uint32_t code) {
+    if (code < 0x80) {
+        value += static_cast<char>(code);
+    } else if (code < 0x800) {
+        value += static_cast<char>(0xC0 | (code >> 6));
+        value += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        value += static_cast<char>(0xE0 | (code >> 12));
+        value += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        value += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
@@ -0,0 +1,58 @@
+/*
+    JSONReader.hpp
+
+    Header file for the reader of the small JSON files of the applications,
+    e.g., partial results and performance baselines, and the writing of a
+    JSON string.
+
+    The reader is for strings, integers, and objects, read in the order of the
+    file. An error in the file is reported with the kind of the file, and exits.
+*/
+
+#ifndef JSONREADER_HPP
+#define JSONREADER_HPP
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <cstdint>
+
+// write the string as a JSON string
+void writeJSONString(std::ostream& out, std::string_view value);
+
+class JSONReader {
+public:
+    // constructor, with the kind of the file for the errors, e.g., "partial"
+    JSONReader(std::string_view content, const std::string& filename, std::string_view kind);
+
+    // expect the character, after whitespace
+    void expect(char c);
+
+    // accept the character, after whitespace
+    bool accept(char c);
+
+    // the next value is a string
+    bool isString();
+
+    // read a string
+    std::string readString();
+
+    // read an integer
+    long readInteger();
+
+    // at the end of the content
+    bool atEnd();
+
+    // report the error, and exit
+    [[noreturn]] void error(const std::string& message);
+
+private:
+    // append the UTF-8 encoding of the code point in the Basic Multilingual Plane
+    static void appendUTF8(std::string& value, std::uint32_t code);
+
+    std::string_view content;
+    const std::string& filename;
+    std::string_view kind;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+    MappedFile.cpp
+
+    Implementation file for a read-only memory-mapped file.
+*/
+
+#include "MappedFile.hpp"
+#include <iostream>
+
+#if !defined(_MSC_VER)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+// constructor, mapping the whole file
+MappedFile::MappedFile(const std::string& filename)
+    : data(nullptr), size(0) {
+
+#if !defined(_MSC_VER)
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "file error : Unable to open " << filename << '\n';
+        exit(1);
+    }
+    struct stat status;
+    if (fstat(fd, &status) == -1) {
+        std::cerr << "file error : Unable to access " << filename << '\n';
+        exit(1);
+    }
+    size = static_cast<std::size_t>(status.st_size);
+
+    // a zero-length mapping is an error
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "file error : Unable to map " << filename << '\n';
+            exit(1);
+        }
+        data = static_cast<const char*>(mapping);
+    }
+
+    // the mapping stays valid after the file is closed
+    close(fd);
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "file error : Unable to open " << filename << '\n';
+        exit(1);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = std::move(contents).str();
+    data = buffer.data();
+    size = buffer.size();
+#endif
+}
+
+// destructor, unmapping the file
+MappedFile::~MappedFile() {
+#if !defined(_MSC_VER)
+    if (data)
+        munmap(const_cast<char*>(data), size);
+#endif
+}
+
+// get the content of the file
+std::string_view MappedFile::getContent() {
+    return std::string_view(data, size);
+}
@@ -0,0 +1,44 @@
+/*
+    MappedFile.hpp
+
+    Header file for a read-only memory-mapped file.
+
+    The whole file is mapped with mmap(), so any byte range can be accessed
+    without reading the file from the start. Without mmap(), e.g., with MSVC,
+    the file is read into memory.
+*/
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+class MappedFile {
+public:
+    // constructor, mapping the whole file
+    MappedFile(const std::string& filename);
+
+    // no copies of the mapping
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // destructor, unmapping the file
+    ~MappedFile();
+
+    // get the content of the file
+    std::string_view getContent();
+
+private:
+    const char* data;
+
+    std::size_t size;
+
+#if defined(_MSC_VER)
+    // file content read into memory
+    std::string buffer;
+#endif
+};
+
+#endif
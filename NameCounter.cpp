@@ -0,0 +1,269 @@
+/*
+    NameCounter.cpp
+
+    Implementation file for the counts of names.
+*/
+
+#include "NameCounter.hpp"
+#include "xml_parser.hpp"
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <cstring>
+
+namespace {
+
+    // initial number of slots of the table, a power of 2
+    const std::size_t INITIAL_TABLE_SIZE = 1024;
+
+    // bytes of replaced names in the pool, beyond the names in the table, before the pool is compacted
+    const std::size_t COMPACT_SLACK = 1024 * 1024;
+
+    // part of the hash in the slot, as the lower bits are its home slot
+    std::uint32_t hashTag(std::uint64_t hash) {
+        return static_cast<std::uint32_t>(hash >> 32);
+    }
+}
+
+// constructor, with the maximum number of names in the table
+NameCounter::NameCounter(std::size_t maxNames)
+    : maxNames(std::clamp<std::size_t>(maxNames, 1, EMPTY - 1)), slots(INITIAL_TABLE_SIZE, Slot{ 0, EMPTY }),
+      total(0), approximate(false), storedBytes(0), liveBytes(0) {}
+
+// add the count to the name
+void NameCounter::add(std::string_view name, std::uint64_t count) {
+    total += count;
+    add(name, xml_parser::hashName(name), count, 0);
+}
+
+// merge the counts of another counter, e.g., of another thread
+void NameCounter::merge(const NameCounter& other) {
+
+    // a name that is not in an approximate counter may have up to its smallest count there
+    if (other.approximate) {
+        const auto smallest = other.entries[other.heap.front()].count;
+        for (auto& entry : entries) {
+            if (other.find(entryName(entry), entry.hash) == EMPTY) {
+                entry.count += smallest;
+                entry.error += smallest;
+            }
+        }
+        approximate = true;
+        if (!heap.empty())
+            buildHeap();
+    }
+
+    for (const auto& entry : other.entries)
+        add(other.entryName(entry), entry.hash, entry.count, entry.error);
+    total += other.total;
+}
+
+// names with the largest counts, largest first, with the names valid until the next change
+std::vector<NameCounter::NameCount> NameCounter::top(std::size_t k) const {
+
+    // equal counts are in the order of the names, so the report does not depend on the order of the input
+    std::vector<std::uint32_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    k = std::min(k, order.size());
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k), order.end(),
+        [this](std::uint32_t a, std::uint32_t b) {
+            if (entries[a].count != entries[b].count)
+                return entries[a].count > entries[b].count;
+            return entryName(entries[a]) < entryName(entries[b]);
+        });
+
+    std::vector<NameCount> result;
+    result.reserve(k);
+    for (std::size_t i = 0; i < k; ++i) {
+        const auto& entry = entries[order[i]];
+        result.push_back(NameCount{ entryName(entry), entry.count, entry.error });
+    }
+    return result;
+}
+
+// get the number of names in the table
+std::size_t NameCounter::size() const {
+    return entries.size();
+}
+
+// get the total of all the counts added
+std::uint64_t NameCounter::getTotal() const {
+    return total;
+}
+
+// whether names were replaced, so the counts may not be exact
+bool NameCounter::isApproximate() const {
+    return approximate;
+}
+
+// set the name of the entry, with a longer name copied to the pool
+void NameCounter::setName(Entry& entry, std::string_view name) {
+
+    if (entry.size > INLINE_SIZE)
+        liveBytes -= entry.size;
+    entry.size = static_cast<std::uint32_t>(name.size());
+    if (name.size() <= INLINE_SIZE) {
+        std::memcpy(entry.text.inlined, name.data(), name.size());
+        return;
+    }
+    entry.text.stored = names.store(name).data();
+    storedBytes += name.size();
+    liveBytes += name.size();
+}
+
+// add the count and error to the name with the hash
+void NameCounter::add(std::string_view name, std::uint64_t hash, std::uint64_t count, std::uint64_t error) {
+
+    const auto mask = slots.size() - 1;
+    const auto tag = hashTag(hash);
+    auto slot = static_cast<std::size_t>(hash) & mask;
+    for (; slots[slot].entry != EMPTY; slot = (slot + 1) & mask) {
+        if (slots[slot].hashTag != tag)
+            continue;
+        auto& entry = entries[slots[slot].entry];
+        if (entryName(entry) == name) {
+            entry.count += count;
+            entry.error += error;
+            if (!heap.empty())
+                siftDown(entry.heapIndex);
+            return;
+        }
+    }
+
+    if (entries.size() == maxNames) {
+        replaceSmallest(name, hash, count, error);
+        return;
+    }
+
+    // new name, in the unused slot that ended the probe
+    slots[slot] = Slot{ tag, static_cast<std::uint32_t>(entries.size()) };
+    auto& entry = entries.emplace_back();
+    entry.hash = hash;
+    entry.count = count;
+    entry.error = error;
+    entry.heapIndex = 0;
+    entry.size = 0;
+    setName(entry, name);
+    if (entries.size() * 2 > slots.size())
+        grow();
+}
+
+// index of the entry of the name with the hash, or EMPTY
+std::uint32_t NameCounter::find(std::string_view name, std::uint64_t hash) const {
+
+    const auto mask = slots.size() - 1;
+    const auto tag = hashTag(hash);
+    for (auto slot = static_cast<std::size_t>(hash) & mask; slots[slot].entry != EMPTY; slot = (slot + 1) & mask) {
+        if (slots[slot].hashTag == tag && entryName(entries[slots[slot].entry]) == name)
+            return slots[slot].entry;
+    }
+    return EMPTY;
+}
+
+// replace the name with the smallest count with the name
+void NameCounter::replaceSmallest(std::string_view name, std::uint64_t hash, std::uint64_t count, std::uint64_t error) {
+
+    // the heap is built by the first replacement, so a counter that stays exact has none
+    if (heap.empty())
+        buildHeap();
+    approximate = true;
+
+    // the new name may have been any of the names replaced, so it starts with the smallest count as its error
+    const auto smallest = heap.front();
+    auto& entry = entries[smallest];
+    removeSlot(smallest);
+    setName(entry, name);
+    entry.hash = hash;
+    entry.error = entry.count + error;
+    entry.count += count;
+    insertSlot(hash, smallest);
+    siftDown(0);
+
+    // the replaced names stay in the pool until it is compacted
+    if (storedBytes > 2 * liveBytes + COMPACT_SLACK)
+        compact();
+}
+
+// remove the slot of the entry, shifting back the slots after it
+void NameCounter::removeSlot(std::uint32_t entry) {
+
+    const auto mask = slots.size() - 1;
+    auto hole = static_cast<std::size_t>(entries[entry].hash) & mask;
+    while (slots[hole].entry != entry)
+        hole = (hole + 1) & mask;
+
+    // a slot after the hole moves into it when the hole is between the slot and its home,
+    // so every probe still reaches its name without a marker for removed slots
+    for (auto slot = (hole + 1) & mask; slots[slot].entry != EMPTY; slot = (slot + 1) & mask) {
+        const auto home = static_cast<std::size_t>(entries[slots[slot].entry].hash) & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            slots[hole] = slots[slot];
+            hole = slot;
+        }
+    }
+    slots[hole].entry = EMPTY;
+}
+
+// slot for the entry of the name with the hash
+void NameCounter::insertSlot(std::uint64_t hash, std::uint32_t entry) {
+
+    const auto mask = slots.size() - 1;
+    auto slot = static_cast<std::size_t>(hash) & mask;
+    while (slots[slot].entry != EMPTY)
+        slot = (slot + 1) & mask;
+    slots[slot] = Slot{ hashTag(hash), entry };
+}
+
+// double the table
+// The entries are inserted in their order, so the entries are read sequentially
+void NameCounter::grow() {
+
+    slots.assign(slots.size() * 2, Slot{ 0, EMPTY });
+    for (std::uint32_t i = 0; i < entries.size(); ++i)
+        insertSlot(entries[i].hash, i);
+}
+
+// heap of the entries by count, with the smallest count at the top
+void NameCounter::buildHeap() {
+
+    heap.resize(entries.size());
+    std::iota(heap.begin(), heap.end(), 0);
+    for (std::uint32_t i = 0; i < heap.size(); ++i)
+        entries[i].heapIndex = i;
+    for (auto i = static_cast<std::uint32_t>(heap.size() / 2); i-- > 0;)
+        siftDown(i);
+}
+
+// move the entry of the heap down after its count increased
+void NameCounter::siftDown(std::uint32_t heapIndex) {
+
+    const auto entry = heap[heapIndex];
+    const auto count = entries[entry].count;
+    const auto size = heap.size();
+    while (true) {
+        auto child = 2 * static_cast<std::size_t>(heapIndex) + 1;
+        if (child >= size)
+            break;
+        if (child + 1 < size && entries[heap[child + 1]].count < entries[heap[child]].count)
+            ++child;
+        if (entries[heap[child]].count >= count)
+            break;
+        heap[heapIndex] = heap[child];
+        entries[heap[heapIndex]].heapIndex = heapIndex;
+        heapIndex = static_cast<std::uint32_t>(child);
+    }
+    heap[heapIndex] = entry;
+    entries[entry].heapIndex = heapIndex;
+}
+
+// copy the longer names of the entries to a new pool, freeing replaced names
+void NameCounter::compact() {
+
+    StringPool compacted;
+    for (auto& entry : entries) {
+        if (entry.size > INLINE_SIZE)
+            entry.text.stored = compacted.store(entryName(entry)).data();
+    }
+    std::swap(names, compacted);
+    storedBytes = liveBytes;
+}
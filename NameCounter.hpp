@@ -0,0 +1,147 @@
+/*
+    NameCounter.hpp
+
+    Header file for the counts of names, e.g., of the identifiers of srcML.
+
+    The table is open addressing with linear probing, with a slot of only part
+    of the hash of the name and the index of its entry, so a probe is a scan of
+    adjacent 8-byte slots. The hash is computed once for a name, and the name
+    is compared only when the hashes are equal. An entry is a cache line, with
+    a short name, i.e., almost any identifier, in the entry itself, so a name
+    that is found costs the slot and the entry. Longer names are in a string
+    pool (see StringPool.hpp), without a heap allocation for each name.
+
+    The memory is bounded by the maximum number of names. Once the table has
+    that many names, a new name replaces the name with the smallest count, as
+    in the Space-Saving algorithm. The new name takes that count plus its own,
+    with the replaced count as its error. Any name with a true count more than
+    the smallest count is in the table, and the count of a name is at most its
+    error more than its true count. Until then the counts are exact:
+
+        NameCounter counter(1000000);
+        counter.add(name);
+        ...
+        for (const auto& each : counter.top(20))
+            std::cout << each.name << ' ' << each.count << '\n';
+*/
+
+#ifndef NAMECOUNTER_HPP
+#define NAMECOUNTER_HPP
+
+#include "StringPool.hpp"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class NameCounter {
+public:
+    // name with its count, which is at most error more than its true count
+    struct NameCount {
+        std::string_view name;
+        std::uint64_t count;
+        std::uint64_t error;
+    };
+
+    // constructor, with the maximum number of names in the table
+    NameCounter(std::size_t maxNames);
+
+    // add the count to the name
+    void add(std::string_view name, std::uint64_t count = 1);
+
+    // merge the counts of another counter, e.g., of another thread
+    void merge(const NameCounter& other);
+
+    // names with the largest counts, largest first, with the names valid until the next change
+    std::vector<NameCount> top(std::size_t k) const;
+
+    // get the number of names in the table
+    std::size_t size() const;
+
+    // get the total of all the counts added
+    std::uint64_t getTotal() const;
+
+    // whether names were replaced, so the counts may not be exact
+    bool isApproximate() const;
+
+private:
+    // slot of the table, with the upper half of the hash and the index of the entry of its name
+    struct Slot {
+        std::uint32_t hashTag;
+        std::uint32_t entry;
+    };
+
+    // longest name in the entry instead of the pool
+    static constexpr std::size_t INLINE_SIZE = 32;
+
+    // name of the table with its count, in a cache line
+    struct alignas(64) Entry {
+        std::uint64_t hash;
+        std::uint64_t count;
+        std::uint64_t error;
+
+        // position in the heap by count, once names are replaced
+        std::uint32_t heapIndex;
+
+        std::uint32_t size;
+        union {
+            char inlined[INLINE_SIZE];
+            const char* stored;
+        } text;
+    };
+
+    // name of the entry
+    std::string_view entryName(const Entry& entry) const {
+        return std::string_view(entry.size <= INLINE_SIZE ? entry.text.inlined : entry.text.stored, entry.size);
+    }
+
+    // set the name of the entry, with a longer name copied to the pool
+    void setName(Entry& entry, std::string_view name);
+
+    // add the count and error to the name with the hash
+    void add(std::string_view name, std::uint64_t hash, std::uint64_t count, std::uint64_t error);
+
+    // index of the entry of the name with the hash, or EMPTY
+    std::uint32_t find(std::string_view name, std::uint64_t hash) const;
+
+    // replace the name with the smallest count with the name
+    void replaceSmallest(std::string_view name, std::uint64_t hash, std::uint64_t count, std::uint64_t error);
+
+    // remove the slot of the entry, shifting back the slots after it
+    void removeSlot(std::uint32_t entry);
+
+    // slot for the entry of the name with the hash
+    void insertSlot(std::uint64_t hash, std::uint32_t entry);
+
+    // double the table
+    void grow();
+
+    // heap of the entries by count, with the smallest count at the top
+    void buildHeap();
+
+    // move the entry of the heap down after its count increased
+    void siftDown(std::uint32_t heapIndex);
+
+    // copy the longer names of the entries to a new pool, freeing replaced names
+    void compact();
+
+    // unused slot
+    static constexpr std::uint32_t EMPTY = UINT32_MAX;
+
+    // data members
+    std::size_t maxNames;
+
+    std::vector<Slot> slots;
+    std::vector<Entry> entries;
+    std::vector<std::uint32_t> heap;
+
+    std::uint64_t total;
+    bool approximate;
+
+    // pool of the longer names, with the bytes stored, and the bytes of the names in the table
+    StringPool names;
+    std::size_t storedBytes;
+    std::size_t liveBytes;
+};
+
+#endif
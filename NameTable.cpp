@@ -0,0 +1,76 @@
+/*
+    NameTable.cpp
+
+    Implementation file for a table of names with a number for each.
+*/
+
+#include "NameTable.hpp"
+#include "xml_parser.hpp"
+
+namespace {
+
+    // initial number of slots of the table, a power of 2
+    const std::size_t INITIAL_TABLE_SIZE = 256;
+
+    // part of the hash in the slot, as the lower bits are its home slot
+    std::uint32_t hashTag(std::uint64_t hash) {
+        return static_cast<std::uint32_t>(hash >> 32);
+    }
+}
+
+// constructor
+NameTable::NameTable() : slots(INITIAL_TABLE_SIZE, Slot{ 0, NONE }) {}
+
+// number of the name, with a new number for a new name
+std::uint32_t NameTable::intern(std::string_view name) {
+
+    const auto hash = xml_parser::hashName(name);
+    const auto tag = hashTag(hash);
+    const auto mask = slots.size() - 1;
+    auto slot = static_cast<std::size_t>(hash) & mask;
+    for (; slots[slot].number != NONE; slot = (slot + 1) & mask) {
+        if (slots[slot].hashTag == tag && names[slots[slot].number] == name)
+            return slots[slot].number;
+    }
+
+    // at most half full, so a lookup always ends at an unused slot
+    const auto number = static_cast<std::uint32_t>(names.size());
+    slots[slot] = Slot{ tag, number };
+    names.push_back(pool.store(name));
+    hashes.push_back(hash);
+    if (names.size() * 2 > slots.size())
+        grow();
+
+    return number;
+}
+
+// number of the name, or NONE for a name not in the table
+std::uint32_t NameTable::find(std::string_view name) const {
+
+    const auto hash = xml_parser::hashName(name);
+    const auto tag = hashTag(hash);
+    const auto mask = slots.size() - 1;
+    for (auto slot = static_cast<std::size_t>(hash) & mask; slots[slot].number != NONE; slot = (slot + 1) & mask) {
+        if (slots[slot].hashTag == tag && names[slots[slot].number] == name)
+            return slots[slot].number;
+    }
+    return NONE;
+}
+
+// get the number of names
+std::size_t NameTable::size() const {
+    return names.size();
+}
+
+// double the table
+void NameTable::grow() {
+
+    slots.assign(slots.size() * 2, Slot{ 0, NONE });
+    const auto mask = slots.size() - 1;
+    for (std::uint32_t number = 0; number < hashes.size(); ++number) {
+        auto slot = static_cast<std::size_t>(hashes[number]) & mask;
+        while (slots[slot].number != NONE)
+            slot = (slot + 1) & mask;
+        slots[slot] = Slot{ hashTag(hashes[number]), number };
+    }
+}
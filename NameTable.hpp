@@ -0,0 +1,65 @@
+/*
+    NameTable.hpp
+
+    Header file for a table of names with a number for each, e.g., of the
+    element and attribute names of a unit tree (see UnitTree.hpp).
+
+    A name is compared as a number, instead of as a string, and an analysis
+    gets the numbers of the names it looks for once, before the parse:
+
+        const auto functionName = names.intern("function"sv);
+        ...
+        if (node.name == functionName)
+
+    The table is open addressing with linear probing, with 8-byte slots of part
+    of the hash and the number of the name. The names are in a string pool.
+*/
+
+#ifndef NAMETABLE_HPP
+#define NAMETABLE_HPP
+
+#include "StringPool.hpp"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+class NameTable {
+public:
+    // number of no name
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    // constructor
+    NameTable();
+
+    // number of the name, with a new number for a new name
+    std::uint32_t intern(std::string_view name);
+
+    // number of the name, or NONE for a name not in the table
+    std::uint32_t find(std::string_view name) const;
+
+    // name of the number
+    std::string_view getName(std::uint32_t number) const {
+        return names[number];
+    }
+
+    // get the number of names
+    std::size_t size() const;
+
+private:
+    // slot of the table, with the upper half of the hash and the number of its name
+    struct Slot {
+        std::uint32_t hashTag;
+        std::uint32_t number;
+    };
+
+    // double the table
+    void grow();
+
+    // data members
+    std::vector<Slot> slots;
+    std::vector<std::string_view> names;
+    std::vector<std::uint64_t> hashes;
+    StringPool pool;
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+    ParseProfile.cpp
+
+    Implementation file for the profile of a parse.
+*/
+
+#include "ParseProfile.hpp"
+#include <iomanip>
+#include <string_view>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // names of the events, in the order of ParseProfile::Event
+    constexpr std::array<std::string_view, ParseProfile::EVENT_COUNT> EVENT_NAMES = {
+        "Start tag"sv, "End tag"sv, "Attribute"sv, "Namespace"sv, "Characters"sv, "Entity ref"sv,
+        "Comment"sv, "CDATA"sv, "PI"sv, "XML decl"sv, "DOCTYPE"sv,
+    };
+}
+
+// start of a parse
+void ParseProfile::startParse() {
+    ++parseCount;
+    startTime = std::chrono::steady_clock::now();
+    startTicks = ticks();
+}
+
+// end of a parse, adding its ticks and time to the total
+void ParseProfile::endParse() {
+    parseTicks += ticks() - startTicks;
+    parseTime += std::chrono::steady_clock::now() - startTime;
+}
+
+// output the markdown table of the profile
+void ParseProfile::report(std::ostream& out) {
+
+    // time of the ticks, from the ticks and time of the parses
+    const auto seconds = std::chrono::duration<double>(parseTime).count();
+    const auto secondsPerTick = parseTicks ? seconds / parseTicks : 0;
+    const auto percent = [this](std::uint64_t partTicks) {
+        return parseTicks ? 100.0 * partTicks / parseTicks : 0;
+    };
+
+    out << "\n# Parse Profile\n";
+    out << "| Event        |        Count |        Bytes |      Ticks/event |    Time ms |      % |\n";
+    out << "|:-------------|-------------:|-------------:|-----------------:|-----------:|-------:|\n";
+    out << std::fixed;
+    std::uint64_t measuredTicks = totalRefillTicks;
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+        if (counts[event] == 0)
+            continue;
+        measuredTicks += totalEventTicks[event];
+        out << "| " << std::setw(12) << std::left << EVENT_NAMES[event] << std::right
+            << " | " << std::setw(12) << counts[event]
+            << " | " << std::setw(12) << eventBytes[event]
+            << " | " << std::setw(16) << std::setprecision(1) << static_cast<double>(totalEventTicks[event]) / counts[event]
+            << " | " << std::setw(10) << std::setprecision(3) << totalEventTicks[event] * secondsPerTick * 1000
+            << " | " << std::setw(6) << std::setprecision(1) << percent(totalEventTicks[event]) << " |\n";
+    }
+    if (refillCount) {
+        out << "| " << std::setw(12) << std::left << "Refill" << std::right
+            << " | " << std::setw(12) << refillCount
+            << " | " << std::setw(12) << refillBytes
+            << " | " << std::setw(16) << std::setprecision(1) << static_cast<double>(totalRefillTicks) / refillCount
+            << " | " << std::setw(10) << std::setprecision(3) << totalRefillTicks * secondsPerTick * 1000
+            << " | " << std::setw(6) << std::setprecision(1) << percent(totalRefillTicks) << " |\n";
+    }
+
+    // the rest of the parse is the dispatch on the tokens and the handler
+    const auto otherTicks = parseTicks > measuredTicks ? parseTicks - measuredTicks : 0;
+    out << "| " << std::setw(12) << std::left << "Other" << std::right
+        << " | " << std::setw(12) << ""
+        << " | " << std::setw(12) << ""
+        << " | " << std::setw(16) << ""
+        << " | " << std::setw(10) << std::setprecision(3) << otherTicks * secondsPerTick * 1000
+        << " | " << std::setw(6) << std::setprecision(1) << percent(otherTicks) << " |\n";
+    out << "\nOther is the dispatch on tokens and the handler callbacks.\n";
+    out << parseCount << " parses, " << parseTicks << " ticks, " << std::setprecision(3) << seconds * 1000 << " ms\n";
+    out << refillCount << " refills, " << movedBytes << " bytes moved by refill\n";
+    out << std::defaultfloat;
+}
@@ -0,0 +1,109 @@
+/*
+    ParseProfile.hpp
+
+    Header file for the profile of a parse.
+
+    The parser records each event kind with its count, the bytes consumed, and
+    the ticks of the time in its parse function, and each refill with the bytes
+    read and the bytes of unprocessed content moved to the front of the buffer.
+    Ticks are from the time-stamp counter on x86-64, otherwise from the steady clock.
+
+    Recording is compiled into the parser with PROFILE (see CMakeLists.txt), and
+    only happens for a parser with a profile. The parse loop is compiled with and
+    without profiling, and the parse checks for a profile once before the loop,
+    so the loop of a parse without a profile has no checks for one.
+*/
+
+#ifndef PARSEPROFILE_HPP
+#define PARSEPROFILE_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+class ParseProfile {
+public:
+    // profiling is compiled into the parser
+#ifdef PROFILE
+    static constexpr bool compiledIn = true;
+#else
+    static constexpr bool compiledIn = false;
+#endif
+
+    // kinds of events, in the order of the report
+    enum Event {
+        START_TAG,
+        END_TAG,
+        ATTRIBUTE,
+        NAMESPACE,
+        CHARACTERS,
+        ENTITY_REFERENCE,
+        COMMENT,
+        CDATA,
+        PROCESSING_INSTRUCTION,
+        XML_DECLARATION,
+        DOCTYPE,
+        EVENT_COUNT
+    };
+
+    // current ticks
+    static std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // record the event, with the bytes consumed and the ticks in its parse function
+    void record(Event event, long bytes, std::uint64_t eventTicks) {
+        ++counts[event];
+        eventBytes[event] += bytes;
+        totalEventTicks[event] += eventTicks;
+    }
+
+    // record a refill, with the bytes read and the unprocessed bytes moved
+    void recordRefill(long bytesRead, long bytesMoved, std::uint64_t refillTicks) {
+        ++refillCount;
+        refillBytes += bytesRead;
+        movedBytes += bytesMoved;
+        totalRefillTicks += refillTicks;
+    }
+
+    // start of a parse
+    void startParse();
+
+    // end of a parse, adding its ticks and time to the total
+    void endParse();
+
+    // output the markdown table of the profile
+    void report(std::ostream& out);
+
+private:
+    std::array<long, EVENT_COUNT> counts{};
+    std::array<long, EVENT_COUNT> eventBytes{};
+    std::array<std::uint64_t, EVENT_COUNT> totalEventTicks{};
+
+    long refillCount = 0;
+    long refillBytes = 0;
+    long movedBytes = 0;
+    std::uint64_t totalRefillTicks = 0;
+
+    // parses, with their total ticks and time for the rate of ticks
+    long parseCount = 0;
+    std::uint64_t parseTicks = 0;
+    std::uint64_t startTicks = 0;
+    std::chrono::steady_clock::duration parseTime{};
+    std::chrono::steady_clock::time_point startTime;
+};
+
+#endif
@@ -0,0 +1,170 @@
+/*
+    PerfCounters.cpp
+
+    Implementation file for the hardware performance counters of phases of a run.
+*/
+
+#include "PerfCounters.hpp"
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // names of the counters, in the order of PerfCounters::Counter
+    constexpr std::array<std::string_view, PerfCounters::COUNTER_COUNT> COUNTER_NAMES = {
+        "Cycles"sv, "Instructions"sv, "Branch misses"sv, "L1D misses"sv, "LLC misses"sv,
+    };
+
+#if defined(__linux__)
+    // open the counter for this process and the threads it starts, disabled
+    int openCounter(std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    // configuration of a read miss of the cache
+    constexpr std::uint64_t cacheReadMiss(std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+}
+
+// constructor, opening the counters
+PerfCounters::PerfCounters() {
+
+    fds.fill(-1);
+#if defined(__linux__)
+    fds[CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    const int cyclesError = errno;
+    fds[INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[BRANCH_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds[L1D_MISSES] = openCounter(PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_L1D));
+    fds[LLC_MISSES] = openCounter(PERF_TYPE_HW_CACHE, cacheReadMiss(PERF_COUNT_HW_CACHE_LL));
+    if (fds[CYCLES] == -1 && fds[INSTRUCTIONS] == -1 && fds[BRANCH_MISSES] == -1
+        && fds[L1D_MISSES] == -1 && fds[LLC_MISSES] == -1) {
+        if (cyclesError == EACCES || cyclesError == EPERM)
+            unavailableReason = "not permitted, see /proc/sys/kernel/perf_event_paranoid";
+        else if (cyclesError == ENOENT || cyclesError == EOPNOTSUPP)
+            unavailableReason = "not supported by the processor, e.g., in a virtual machine";
+        else
+            unavailableReason = strerror(cyclesError);
+    }
+#else
+    unavailableReason = "perf_event_open() is only on Linux";
+#endif
+}
+
+// destructor, closing the counters
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (const auto fd : fds) {
+        if (fd != -1)
+            close(fd);
+    }
+#endif
+}
+
+// start counting a phase
+void PerfCounters::start() {
+#if defined(__linux__)
+    for (const auto fd : fds) {
+        if (fd != -1) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+// stop counting the phase, and record it with the bytes it processed
+void PerfCounters::stop(std::string_view phase, long bytes) {
+#if defined(__linux__)
+    for (const auto fd : fds) {
+        if (fd != -1)
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+    Phase result{ std::string(phase), bytes, {} };
+    for (int counter = 0; counter < COUNTER_COUNT; ++counter)
+        result.values[counter] = read(counter);
+    phases.push_back(result);
+}
+
+// read the counter, scaled for the time it was multiplexed
+std::uint64_t PerfCounters::read(int counter) {
+#if defined(__linux__)
+    if (fds[counter] == -1)
+        return 0;
+
+    // value, time enabled, and time running
+    std::uint64_t values[3] = {};
+    if (::read(fds[counter], values, sizeof(values)) != sizeof(values) || values[2] == 0)
+        return 0;
+    if (values[2] < values[1])
+        return static_cast<std::uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+    return values[0];
+#else
+    return 0;
+#endif
+}
+
+// output the counters of the phases, with IPC and rates per MB
+void PerfCounters::report(std::ostream& out) {
+
+    out << "\n# Performance Counters\n";
+    if (!unavailableReason.empty()) {
+        out << "Performance counters are not available: " << unavailableReason << '\n';
+        return;
+    }
+
+    out << "| Phase        | Counter       |              Value |         Per MB |\n";
+    out << "|:-------------|:--------------|-------------------:|---------------:|\n";
+    out << std::fixed << std::setprecision(0);
+    for (const auto& phase : phases) {
+        const auto megabytes = phase.bytes / 1e6;
+        for (int counter = 0; counter < COUNTER_COUNT; ++counter) {
+            if (fds[counter] == -1)
+                continue;
+            out << "| " << std::setw(12) << std::left << phase.name
+                << " | " << std::setw(13) << COUNTER_NAMES[counter] << std::right
+                << " | " << std::setw(18) << phase.values[counter]
+                << " | " << std::setw(14);
+            if (megabytes > 0)
+                out << phase.values[counter] / megabytes;
+            else
+                out << "";
+            out << " |\n";
+        }
+        if (fds[CYCLES] != -1 && fds[INSTRUCTIONS] != -1 && phase.values[CYCLES] > 0) {
+            out << "| " << std::setw(12) << std::left << phase.name
+                << " | " << std::setw(13) << "IPC" << std::right
+                << " | " << std::setw(18) << std::setprecision(2) << static_cast<double>(phase.values[INSTRUCTIONS]) / phase.values[CYCLES]
+                << " | " << std::setw(14) << "" << " |\n" << std::setprecision(0);
+        }
+    }
+    for (int counter = 0; counter < COUNTER_COUNT; ++counter) {
+        if (fds[counter] == -1)
+            out << COUNTER_NAMES[counter] << " is not available\n";
+    }
+    out << std::defaultfloat;
+}
@@ -0,0 +1,75 @@
+/*
+    PerfCounters.hpp
+
+    Header file for the hardware performance counters of phases of a run.
+
+    The counters are cycles, instructions, branch misses, L1 data cache read
+    misses, and last-level cache misses, from Linux perf_event_open() for this
+    process and the threads it starts, in user space only. A counter that cannot
+    be opened, e.g., in a virtual machine or with a restrictive
+    /proc/sys/kernel/perf_event_paranoid, is left out of the report. Without
+    any counters, or on other systems, the report says why.
+*/
+
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+class PerfCounters {
+public:
+    // kinds of counters, in the order of the report
+    enum Counter {
+        CYCLES,
+        INSTRUCTIONS,
+        BRANCH_MISSES,
+        L1D_MISSES,
+        LLC_MISSES,
+        COUNTER_COUNT
+    };
+
+    // constructor, opening the counters
+    PerfCounters();
+
+    // no copies of the counters
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // destructor, closing the counters
+    ~PerfCounters();
+
+    // start counting a phase
+    void start();
+
+    // stop counting the phase, and record it with the bytes it processed
+    void stop(std::string_view phase, long bytes);
+
+    // output the counters of the phases, with IPC and rates per MB
+    void report(std::ostream& out);
+
+private:
+    // read the counter, scaled for the time it was multiplexed
+    std::uint64_t read(int counter);
+
+    // file descriptors of the counters, -1 for a counter that is not available
+    std::array<int, COUNTER_COUNT> fds;
+
+    // reason none of the counters are available
+    std::string unavailableReason;
+
+    // recorded phases
+    struct Phase {
+        std::string name;
+        long bytes;
+        std::array<std::uint64_t, COUNTER_COUNT> values;
+    };
+
+    std::vector<Phase> phases;
+};
+
+#endif
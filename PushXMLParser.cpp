@@ -0,0 +1,538 @@
+/*
+    PushXMLParser.cpp
+
+    Implementation file for the push XML parser.
+*/
+
+#include "PushXMLParser.hpp"
+#include "xml_parser.hpp"
+#include <iostream>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+using namespace xml_parser;
+
+namespace {
+
+    const auto npos = std::string_view::npos;
+}
+
+// constructor
+template <class Policy>
+BasicPushXMLParser<Policy>::BasicPushXMLParser(XMLParserHandler& handler)
+    : parser(std::string_view(), handler), phase(Phase::PROLOG), state(Scan::PROLOG), prologStage(PrologStage::BEFORE_DECLARATION),
+      depth(0), rootClosed(false), started(false), literalMatched(0), matched(0), quote('"'), previous('\0'),
+      doctypeDepth(0), doctypeSingleQuote(false), doctypeDoubleQuote(false), doctypeComment(false), doctypeCommentStart(0),
+      doctypeCounted(false), safeBoundary(npos), partialOffset(0), totalBytes(0) {
+
+    // the parser only sees complete tokens, so it never reads more input
+    parser.inMemory = true;
+}
+
+// parse the next chunk of the input, with the events of the tokens it completes
+template <class Policy>
+void BasicPushXMLParser<Policy>::feed(std::string_view chunk) {
+
+    if (chunk.empty())
+        return;
+    if (parser.validateUTF8)
+        parser.validatePushed(chunk);
+    const auto chunkOffset = totalBytes;
+    totalBytes += static_cast<long>(chunk.size());
+
+    // complete the partial token with the front of the chunk
+    std::size_t pos = 0;
+    if (!partial.empty()) {
+        const auto regionPhase = phase;
+        const auto boundary = scan(chunk, 0, true);
+        if (boundary == npos) {
+            partial.append(chunk);
+            return;
+        }
+        partial.append(chunk.substr(0, boundary));
+        parsePartial(regionPhase);
+        pos = boundary;
+    }
+
+    // parse the complete tokens in place, in a region for each phase
+    while (pos < chunk.size()) {
+        const auto regionPhase = phase;
+        const auto boundary = scan(chunk, pos, false);
+        if (boundary != npos) {
+            if (safeBoundary != npos && safeBoundary > pos) {
+                parseRegion(chunk.substr(pos, safeBoundary - pos), chunkOffset + static_cast<long>(pos), regionPhase);
+                pos = safeBoundary;
+            }
+
+            // the parser may read past the tokens at the end of the chunk, so they are parsed from a copy
+            if (boundary > pos) {
+                partial.assign(chunk.substr(pos, boundary - pos));
+                partialOffset = chunkOffset + static_cast<long>(pos);
+                parsePartial(regionPhase);
+                pos = boundary;
+            }
+        }
+        if (!rootClosed)
+            break;
+    }
+
+    // the partial token at the end of the chunk waits for the next chunk
+    partial.assign(chunk.substr(pos));
+    partialOffset = chunkOffset + static_cast<long>(pos);
+}
+
+// parse the end of the input, with the rest of the tokens and the end of the document
+template <class Policy>
+void BasicPushXMLParser<Policy>::finish() {
+
+    if (totalBytes == 0) {
+        std::cerr << "parser error : Empty file\n";
+        exit(1);
+    }
+    if (parser.validateUTF8)
+        parser.validatePushed(std::string_view());
+
+    // the rest of the input is parsed as it is, as at the end of the input of a parse
+    if (!partial.empty() || !started)
+        parsePartial(phase);
+
+    parser.finishPushed();
+}
+
+// get totalBytes
+template <class Policy>
+long BasicPushXMLParser<Policy>::getTotalBytes() {
+    return totalBytes;
+}
+
+// validate that the content is UTF-8 as it is fed
+template <class Policy>
+void BasicPushXMLParser<Policy>::setValidateUTF8(bool validate) {
+    parser.setValidateUTF8(validate);
+}
+
+// check that the document is well-formed, i.e., that end tags match start tags
+// and that attributes are unique
+template <class Policy>
+void BasicPushXMLParser<Policy>::setCheckWellFormed(bool check) {
+    parser.setCheckWellFormed(check);
+}
+
+// record the events of the parse in the profile
+template <class Policy>
+void BasicPushXMLParser<Policy>::setProfile(ParseProfile* profile) {
+    parser.setProfile(profile);
+}
+
+// scan the data from pos for token boundaries, until the end of the data, the end of the
+// root element, or the first boundary when stopAtFirst
+// The tokens are the tokens of the parser, e.g., an XML comment includes the whitespace after it
+template <class Policy>
+std::size_t BasicPushXMLParser<Policy>::scan(std::string_view data, std::size_t pos, bool stopAtFirst) {
+
+    std::size_t boundary = npos;
+    safeBoundary = npos;
+    rootClosed = false;
+    while (pos < data.size()) {
+        bool atBoundary = false;
+        switch (state) {
+        case Scan::PROLOG: {
+            // whitespace before the XML declaration, the DOCTYPE, or the first token of the root element
+            const auto end = findNotClass(data, WHITESPACE_CHARACTER, pos);
+            if (end == npos) {
+                pos = data.size();
+                break;
+            }
+            pos = end;
+            if (data[pos] == '<' && prologStage != PrologStage::AFTER_DOCTYPE) {
+                ++pos;
+                literal = std::string_view();
+                state = Scan::PROLOG_MARKUP;
+            } else {
+                phase = Phase::ROOT;
+                state = Scan::TOKEN;
+            }
+            break;
+        }
+        case Scan::PROLOG_MARKUP:
+            // match "<?xml " or "<!DOCTYPE ", otherwise the markup is in the root element
+            if (literal.empty()) {
+                if (data[pos] == '?' && prologStage == PrologStage::BEFORE_DECLARATION) {
+                    literal = "?xml "sv;
+                } else if (data[pos] == '!') {
+                    literal = "!DOCTYPE "sv;
+                } else {
+                    phase = Phase::ROOT;
+                    state = Scan::MARKUP;
+                    break;
+                }
+                literalMatched = 0;
+            }
+            if (data[pos] == literal[literalMatched]) {
+                ++pos;
+                if (++literalMatched == literal.size()) {
+                    matched = 0;
+                    doctypeDepth = 1;
+                    state = literal[0] == '?' ? Scan::XML_DECLARATION : Scan::DOCTYPE;
+                }
+                break;
+            }
+            phase = Phase::ROOT;
+            if (literal[0] == '?') {
+                // processing instruction, e.g., <?xml-stylesheet
+                matched = 0;
+                state = Scan::PROCESSING_INSTRUCTION;
+            } else if (literalMatched == 1) {
+                // comment or CDATA
+                state = Scan::DECLARATION_START;
+            } else {
+                // invalid declaration, an error when parsed
+                ++pos;
+                state = Scan::TOKEN;
+                atBoundary = true;
+            }
+            break;
+        case Scan::XML_DECLARATION:
+            if (findTerminator(data, pos, "?>"sv)) {
+                prologStage = PrologStage::BEFORE_DOCTYPE;
+                state = Scan::PROLOG;
+            }
+            break;
+        case Scan::DOCTYPE:
+            if (findDOCTYPEEnd(data, pos)) {
+                prologStage = PrologStage::AFTER_DOCTYPE;
+                state = Scan::PROLOG;
+            }
+            break;
+        case Scan::TOKEN:
+            // kind of token by the first character
+            if (phase == Phase::EPILOG) {
+                // after the root element, whitespace and comments
+                const auto end = findNotClass(data, WHITESPACE_CHARACTER, pos);
+                if (end != pos) {
+                    pos = end == npos ? data.size() : end;
+                } else if (data[pos] == '<') {
+                    ++pos;
+                    state = Scan::MARKUP;
+                    break;
+                } else {
+                    // extra content, an error when parsed
+                    ++pos;
+                }
+                atBoundary = true;
+                break;
+            }
+            if (data[pos] == '&') {
+                ++pos;
+                state = Scan::ENTITY_START;
+                break;
+            }
+            if (data[pos] != '<') {
+                state = Scan::TEXT;
+                break;
+            }
+            ++pos;
+            state = Scan::MARKUP;
+            if (pos == data.size())
+                break;
+            [[fallthrough]];
+        case Scan::MARKUP:
+            // kind of markup by the character after the '<'
+            if (phase == Phase::EPILOG && data[pos] != '!') {
+                // extra content, an error when parsed
+                ++pos;
+                state = Scan::TOKEN;
+                atBoundary = true;
+                break;
+            }
+            if (data[pos] == '/') {
+                ++pos;
+                state = Scan::END_TAG;
+                break;
+            }
+            if (data[pos] == '?') {
+                ++pos;
+                matched = 0;
+                state = Scan::PROCESSING_INSTRUCTION;
+                break;
+            }
+            if (data[pos] == '!') {
+                ++pos;
+                state = Scan::DECLARATION_START;
+                break;
+            }
+            state = Scan::START_TAG;
+            [[fallthrough]];
+        case Scan::START_TAG: {
+            // the end of the start tag is the first '>' outside of an attribute value
+            const auto end = findTagDelimiter(data, pos);
+            if (end == npos) {
+                pos = data.size();
+                break;
+            }
+            if (data[end] != '>') {
+                quote = data[end];
+                pos = end + 1;
+                state = Scan::ATTRIBUTE_VALUE;
+                break;
+            }
+            const auto before = end > 0 ? data[end - 1] : previous;
+            pos = end + 1;
+            if (before != '/')
+                ++depth;
+            else if (depth == 0)
+                rootClosed = true;
+            state = Scan::TOKEN;
+            atBoundary = true;
+            break;
+        }
+        case Scan::TEXT: {
+            const auto end = findTextEnd(data.substr(pos));
+            if (end == npos) {
+                pos = data.size();
+                break;
+            }
+            pos += end;
+            state = Scan::TOKEN;
+            atBoundary = true;
+            break;
+        }
+        case Scan::ENTITY_START:
+            // the parser replaces &lt;, &gt;, and &amp;, and otherwise the '&' is a token by itself
+            literal = data[pos] == 'l' ? "lt;"sv : data[pos] == 'g' ? "gt;"sv : data[pos] == 'a' ? "amp;"sv : std::string_view();
+            literalMatched = 0;
+            if (literal.empty()) {
+                state = Scan::TOKEN;
+                atBoundary = true;
+            } else {
+                state = Scan::ENTITY;
+            }
+            break;
+        case Scan::ENTITY:
+            if (data[pos] != literal[literalMatched]) {
+                // not an entity reference, so the letters after the '&' are characters
+                state = Scan::TEXT;
+                break;
+            }
+            ++pos;
+            if (++literalMatched == literal.size()) {
+                state = Scan::TOKEN;
+                atBoundary = true;
+            }
+            break;
+        case Scan::ATTRIBUTE_VALUE: {
+            const auto end = data.find(quote, pos);
+            if (end == npos) {
+                pos = data.size();
+                break;
+            }
+            pos = end + 1;
+            state = Scan::START_TAG;
+            break;
+        }
+        case Scan::END_TAG: {
+            const auto end = data.find('>', pos);
+            if (end == npos) {
+                pos = data.size();
+                break;
+            }
+            pos = end + 1;
+            --depth;
+            if (depth == 0)
+                rootClosed = true;
+            state = Scan::TOKEN;
+            atBoundary = true;
+            break;
+        }
+        case Scan::PROCESSING_INSTRUCTION:
+            if (findTerminator(data, pos, "?>"sv)) {
+                state = Scan::TOKEN;
+                atBoundary = true;
+            }
+            break;
+        case Scan::DECLARATION_START:
+            // comment or CDATA by the character after the "<!"
+            literalMatched = 0;
+            if (data[pos] == '-') {
+                literal = "--"sv;
+                state = Scan::DECLARATION;
+            } else if (data[pos] == '[' && phase != Phase::EPILOG) {
+                literal = "[CDATA["sv;
+                state = Scan::DECLARATION;
+            } else {
+                // invalid declaration, an error when parsed
+                ++pos;
+                state = Scan::TOKEN;
+                atBoundary = true;
+            }
+            break;
+        case Scan::DECLARATION:
+            if (data[pos] != literal[literalMatched]) {
+                // invalid declaration, an error when parsed
+                ++pos;
+                state = Scan::TOKEN;
+                atBoundary = true;
+                break;
+            }
+            ++pos;
+            if (++literalMatched == literal.size()) {
+                matched = 0;
+                state = literal[0] == '-' ? Scan::COMMENT : Scan::CDATA;
+            }
+            break;
+        case Scan::COMMENT:
+            if (findTerminator(data, pos, "-->"sv))
+                state = Scan::COMMENT_WHITESPACE;
+            break;
+        case Scan::COMMENT_WHITESPACE: {
+            // the parser removes the whitespace after a comment
+            const auto end = findNotClass(data, WHITESPACE_CHARACTER, pos);
+            if (end == npos) {
+                pos = data.size();
+                break;
+            }
+            pos = end;
+            state = Scan::TOKEN;
+            atBoundary = true;
+            break;
+        }
+        case Scan::CDATA:
+            if (findTerminator(data, pos, "]]>"sv)) {
+                state = Scan::TOKEN;
+                atBoundary = true;
+            }
+            break;
+        }
+
+        if (atBoundary) {
+            boundary = pos;
+            if (pos + PADDING <= data.size())
+                safeBoundary = pos;
+            if (rootClosed) {
+                phase = Phase::EPILOG;
+                break;
+            }
+            if (stopAtFirst)
+                break;
+        }
+    }
+    if (pos == data.size())
+        previous = data.back();
+
+    return boundary;
+}
+
+// find the end of the terminator from pos, continuing a match at the end of the previous data
+// The terminators, "?>", "-->", and "]]>", repeat their first character up to the last
+template <class Policy>
+bool BasicPushXMLParser<Policy>::findTerminator(std::string_view data, std::size_t& pos, std::string_view terminator) {
+
+    // continue the match from the previous data
+    while (matched > 0 && pos < data.size()) {
+        if (data[pos] == terminator[matched]) {
+            ++pos;
+            if (++matched == terminator.size()) {
+                matched = 0;
+                return true;
+            }
+        } else if (data[pos] == terminator[0]) {
+            // still the front of the terminator, e.g., "--" of "-->" in "--->"
+            ++pos;
+        } else {
+            matched = 0;
+        }
+    }
+    if (pos == data.size())
+        return false;
+
+    const auto end = data.find(terminator, pos);
+    if (end != npos) {
+        pos = end + terminator.size();
+        return true;
+    }
+
+    // the front of the terminator at the end of the data continues in the next data
+    for (auto length = terminator.size() - 1; length > 0; --length) {
+        if (data.size() - pos >= length && data.substr(data.size() - length) == terminator.substr(0, length)) {
+            matched = length;
+            break;
+        }
+    }
+    pos = data.size();
+    return false;
+}
+
+// find the end of the DOCTYPE from pos, as the parser does
+// The markup in the DOCTYPE nests, except in quotes and comments
+template <class Policy>
+bool BasicPushXMLParser<Policy>::findDOCTYPEEnd(std::string_view data, std::size_t& pos) {
+
+    while (pos < data.size()) {
+        if (doctypeComment) {
+            if (findTerminator(data, pos, "-->"sv))
+                doctypeComment = false;
+            continue;
+        }
+        const auto c = data[pos];
+        ++pos;
+        if (doctypeCommentStart > 0) {
+            // the start of a comment, "<!--", is not markup
+            if (c == "<!--"[doctypeCommentStart]) {
+                if (++doctypeCommentStart == 4) {
+                    doctypeCommentStart = 0;
+                    doctypeComment = true;
+                    matched = 0;
+                    if (doctypeCounted)
+                        --doctypeDepth;
+                }
+                continue;
+            }
+            doctypeCommentStart = 0;
+        }
+        const auto inQuote = doctypeSingleQuote || doctypeDoubleQuote;
+        if (c == '<') {
+            doctypeCommentStart = 1;
+            doctypeCounted = !inQuote;
+            if (!inQuote)
+                ++doctypeDepth;
+        } else if (c == '>' && !inQuote) {
+            if (--doctypeDepth == 0)
+                return true;
+        } else if (c == '\'') {
+            doctypeSingleQuote = !doctypeSingleQuote;
+        } else if (c == '"') {
+            doctypeDoubleQuote = !doctypeDoubleQuote;
+        }
+    }
+    return false;
+}
+
+// parse the complete tokens of the region of the input at the offset, in the phase
+// The region is followed by at least PADDING readable bytes
+template <class Policy>
+void BasicPushXMLParser<Policy>::parseRegion(std::string_view region, long offset, Phase regionPhase) {
+
+    if (regionPhase == Phase::EPILOG) {
+        parser.parsePushedEpilog(region, offset);
+        return;
+    }
+    parser.parsePushedElements(region, offset, !started);
+    started = true;
+}
+
+// parse the partial tokens as complete tokens, with padding after them
+template <class Policy>
+void BasicPushXMLParser<Policy>::parsePartial(Phase regionPhase) {
+
+    const auto size = partial.size();
+    partial.append(PADDING, '\0');
+    parseRegion(std::string_view(partial.data(), size), partialOffset, regionPhase);
+    partial.clear();
+}
+
+// push parser with all features
+template class BasicPushXMLParser<FullParserPolicy>;
+
+// push parser with only the features needed for srcFacts
+template class BasicPushXMLParser<FactsParserPolicy>;
@@ -0,0 +1,139 @@
+/*
+    PushXMLParser.hpp
+
+    Header file for the push XML parser.
+
+    The input is given to the parser in chunks of any size, e.g., as it is
+    received from a socket or a pipe from a srcml process, and the parser
+    calls the handler for each token completed by the chunk. A token may be
+    split anywhere, e.g., in a tag, an attribute value, or a comment.
+
+    A resumable scanner finds the end of the last complete token in the chunk.
+    It keeps its state, e.g., inside an attribute value, at the end of the
+    chunk, and continues from there with the next chunk, so no byte is scanned
+    twice for a token boundary. The complete tokens are parsed in place by
+    BasicXMLParser, so the events are the same as for the whole document in
+    memory. Only the partial token at the end of a chunk, and the tokens in
+    the last PADDING bytes that the parser may read past, are copied.
+*/
+
+#ifndef PUSHXMLPARSER_HPP
+#define PUSHXMLPARSER_HPP
+
+#include "XMLParser.hpp"
+#include <string>
+#include <string_view>
+
+template <class Policy>
+class BasicPushXMLParser {
+public:
+    // constructor
+    BasicPushXMLParser(XMLParserHandler& handler);
+
+    // parse the next chunk of the input, with the events of the tokens it completes
+    void feed(std::string_view chunk);
+
+    // parse the end of the input, with the rest of the tokens and the end of the document
+    void finish();
+
+    // get totalBytes
+    long getTotalBytes();
+
+    // validate that the content is UTF-8 as it is fed
+    void setValidateUTF8(bool validate);
+
+    // check that the document is well-formed, i.e., that end tags match start tags
+    // and that attributes are unique
+    void setCheckWellFormed(bool check);
+
+    // record the events of the parse in the profile
+    void setProfile(ParseProfile* profile);
+
+private:
+    // part of the document
+    enum class Phase : unsigned char { PROLOG, ROOT, EPILOG };
+
+    // state of the scanner, in a token or between tokens
+    enum class Scan : unsigned char {
+        PROLOG, PROLOG_MARKUP, XML_DECLARATION, DOCTYPE,
+        TOKEN, TEXT, ENTITY_START, ENTITY, MARKUP, START_TAG, ATTRIBUTE_VALUE, END_TAG,
+        PROCESSING_INSTRUCTION, DECLARATION_START, DECLARATION, COMMENT, COMMENT_WHITESPACE, CDATA
+    };
+
+    // part of the prolog that is next
+    enum class PrologStage : unsigned char { BEFORE_DECLARATION, BEFORE_DOCTYPE, AFTER_DOCTYPE };
+
+    // scan the data from pos for token boundaries, until the end of the data, the end of the
+    // root element, or the first boundary when stopAtFirst
+    // @return Position of the last token boundary, or npos when the data is all in one token
+    std::size_t scan(std::string_view data, std::size_t pos, bool stopAtFirst);
+
+    // find the end of the terminator from pos, continuing a match at the end of the previous data
+    bool findTerminator(std::string_view data, std::size_t& pos, std::string_view terminator);
+
+    // find the end of the DOCTYPE from pos, as the parser does
+    bool findDOCTYPEEnd(std::string_view data, std::size_t& pos);
+
+    // parse the complete tokens of the region of the input at the offset, in the phase
+    // The region is followed by at least PADDING readable bytes
+    void parseRegion(std::string_view region, long offset, Phase regionPhase);
+
+    // parse the partial tokens as complete tokens, with padding after them
+    void parsePartial(Phase regionPhase);
+
+    // data members
+    BasicXMLParser<Policy> parser;
+
+    Phase phase;
+
+    Scan state;
+
+    PrologStage prologStage;
+
+    // depth of the element, as counted by the parser
+    int depth;
+
+    // the last token completed the root element
+    bool rootClosed;
+
+    // first part, with the start of the document, is parsed
+    bool started;
+
+    // literal being matched, e.g., "?xml " of the XML declaration, and its bytes matched so far
+    std::string_view literal;
+    std::size_t literalMatched;
+
+    // bytes of a terminator, e.g., "-->", matched at the end of the previous data
+    std::size_t matched;
+
+    // delimiter of the attribute value
+    char quote;
+
+    // byte before the data, to find "/>" split between chunks
+    char previous;
+
+    // DOCTYPE, with the nesting of its markup, quotes, comments, and the match of "<!--"
+    int doctypeDepth;
+    bool doctypeSingleQuote;
+    bool doctypeDoubleQuote;
+    bool doctypeComment;
+    int doctypeCommentStart;
+    bool doctypeCounted;
+
+    // the last token boundary that PADDING bytes of the data follow
+    std::size_t safeBoundary;
+
+    // bytes after the last parsed token boundary, with its input offset
+    std::string partial;
+    long partialOffset;
+
+    long totalBytes;
+};
+
+// push XML parser with all features
+using PushXMLParser = BasicPushXMLParser<FullParserPolicy>;
+
+// push XML parser with only the features needed for srcFacts
+using FactsPushXMLParser = BasicPushXMLParser<FactsParserPolicy>;
+
+#endif
@@ -0,0 +1,113 @@
+/*
+    StringPool.cpp
+
+    Implementation file for a pool of strings that a handler keeps after the
+    handler returns.
+*/
+
+#include "StringPool.hpp"
+#include "xml_parser.hpp"
+#include <algorithm>
+
+namespace {
+
+    // initial number of slots of the intern table, a power of 2
+    const std::size_t INITIAL_TABLE_SIZE = 64;
+}
+
+// constructor, with the size of a block of the pool
+StringPool::StringPool(std::size_t blockSize)
+    : blockSize(blockSize), block(0), next(nullptr), end(nullptr) {}
+
+// copy of the string in the pool, the same view for equal strings
+std::string_view StringPool::intern(std::string_view s) {
+
+    // an empty view marks an unused slot, so the empty string is not stored
+    if (s.empty())
+        return std::string_view();
+
+    // the table is created by the first intern, so a pool only for store() has none
+    if (table.empty())
+        table.resize(INITIAL_TABLE_SIZE);
+
+    const auto hash = xml_parser::hashName(s);
+    const auto mask = table.size() - 1;
+    auto slot = static_cast<std::size_t>(hash) & mask;
+    while (!table[slot].s.empty()) {
+        if (table[slot].hash == hash && table[slot].s == s)
+            return table[slot].s;
+        slot = (slot + 1) & mask;
+    }
+
+    // at most half full, so a lookup always ends at an unused slot
+    const auto stored = store(s);
+    table[slot] = Entry{ hash, stored };
+    internOrder.push_back(slot);
+    if (internOrder.size() * 2 > table.size())
+        growTable();
+
+    return stored;
+}
+
+// position of the pool, e.g., at the start of a unit
+StringPool::Mark StringPool::mark() const {
+    return Mark{ block, next, internOrder.size() };
+}
+
+// free the strings stored and interned after the mark, e.g., at the end of the unit
+void StringPool::release(const Mark& mark) {
+
+    // the entries are removed latest first, so no entry that remains was
+    // placed after a removed one in its probe sequence
+    while (internOrder.size() > mark.internCount) {
+        table[internOrder.back()] = Entry{};
+        internOrder.pop_back();
+    }
+
+    // without a next, e.g., a mark of the empty pool, the next store starts at the block
+    block = mark.block;
+    next = mark.next;
+    end = next ? blocks[block].data.get() + blocks[block].size : nullptr;
+}
+
+// free all the strings
+void StringPool::clear() {
+    release(Mark{ 0, blocks.empty() ? nullptr : blocks[0].data.get(), 0 });
+}
+
+// get the number of bytes of the blocks
+std::size_t StringPool::getCapacity() const {
+    std::size_t capacity = 0;
+    for (const auto& each : blocks)
+        capacity += each.size;
+    return capacity;
+}
+
+// move to the next block with room for the size, reusing a released block
+void StringPool::nextBlock(std::size_t size) {
+
+    if (next)
+        ++block;
+    if (block == blocks.size() || blocks[block].size < size) {
+        const auto newSize = std::max(blockSize, size);
+        blocks.insert(blocks.begin() + static_cast<std::ptrdiff_t>(block), Block{ std::make_unique<char[]>(newSize), newSize });
+    }
+    next = blocks[block].data.get();
+    end = next + blocks[block].size;
+}
+
+// double the intern table, inserting the entries in their order
+void StringPool::growTable() {
+
+    std::vector<Entry> oldTable(table.size() * 2);
+    oldTable.swap(table);
+    const auto mask = table.size() - 1;
+    for (auto& slot : internOrder) {
+        const auto& entry = oldTable[slot];
+        auto newSlot = static_cast<std::size_t>(entry.hash) & mask;
+        while (!table[newSlot].s.empty())
+            newSlot = (newSlot + 1) & mask;
+        table[newSlot] = entry;
+        slot = newSlot;
+    }
+}
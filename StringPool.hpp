@@ -0,0 +1,107 @@
+/*
+    StringPool.hpp
+
+    Header file for a pool of strings that a handler keeps after the handler
+    returns. The views that a handler receives are into the input buffer, and
+    are invalid after the next refill, so a kept name or value has to be copied.
+
+    A copy into the pool is a bump of a pointer in a block of the pool, without
+    a heap allocation for each string. An interned string is stored once, and
+    equal strings intern to the same view. The strings are freed in bulk, e.g.,
+    the strings of a unit when the unit ends:
+
+        // start tag of a unit
+        unitMark = pool.mark();
+        ...
+        identifiers.push_back(pool.intern(name));
+        ...
+        // end tag of the unit, with all the strings of the unit freed
+        identifiers.clear();
+        pool.release(unitMark);
+
+    The blocks are kept for reuse, so the pool allocates only as it grows past
+    its largest size so far.
+*/
+
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+
+class StringPool {
+public:
+    // position of the pool, with the strings stored and interned before it
+    struct Mark {
+        std::size_t block;
+        char* next;
+        std::size_t internCount;
+    };
+
+    // constructor, with the size of a block of the pool
+    StringPool(std::size_t blockSize = 64 * 1024);
+
+    // copy of the string in the pool, valid until it is released
+    std::string_view store(std::string_view s) {
+        if (s.size() > static_cast<std::size_t>(end - next))
+            nextBlock(s.size());
+        char* const copy = next;
+        if (!s.empty())
+            std::memcpy(copy, s.data(), s.size());
+        next += s.size();
+        return std::string_view(copy, s.size());
+    }
+
+    // copy of the string in the pool, the same view for equal strings
+    std::string_view intern(std::string_view s);
+
+    // position of the pool, e.g., at the start of a unit
+    Mark mark() const;
+
+    // free the strings stored and interned after the mark, e.g., at the end of the unit
+    void release(const Mark& mark);
+
+    // free all the strings
+    void clear();
+
+    // get the number of bytes of the blocks
+    std::size_t getCapacity() const;
+
+private:
+    // block of the pool
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    // entry of the intern table, with an empty view for an unused slot
+    struct Entry {
+        std::uint64_t hash;
+        std::string_view s;
+    };
+
+    // move to the next block with room for the size, reusing a released block
+    void nextBlock(std::size_t size);
+
+    // double the intern table, inserting the entries in their order
+    void growTable();
+
+    // data members
+    std::size_t blockSize;
+
+    std::vector<Block> blocks;
+    std::size_t block;
+
+    // free part of the current block
+    char* next;
+    char* end;
+
+    // open-addressing intern table, and its slots in the order of interning
+    std::vector<Entry> table;
+    std::vector<std::size_t> internOrder;
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+    TapeReplayer.cpp
+
+    Implementation file for replaying an event tape to any XMLParserHandler
+*/
+
+#include "TapeReplayer.hpp"
+#include "EventTape.hpp"
+#include <iostream>
+#include <optional>
+#include <cstring>
+#include <cassert>
+
+using namespace event_tape;
+
+// constructor, mapping the tape file
+TapeReplayer::TapeReplayer(const std::string& filename)
+    : tape(filename), totalBytes(0) {
+
+    const auto content = tape.getContent();
+    TapeHeader header;
+    if (content.size() < sizeof(header)) {
+        std::cerr << "tape error : Invalid tape file " << filename << '\n';
+        exit(1);
+    }
+    std::memcpy(&header, content.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.version != VERSION
+        || sizeof(header) + header.blocksSize + header.namesSize != content.size()) {
+        std::cerr << "tape error : Invalid tape file " << filename << '\n';
+        exit(1);
+    }
+    totalBytes = static_cast<long>(header.inputBytes);
+
+    // locate the pool and events of each block, which exactly fill the blocks section
+    auto blocksSection = content.substr(sizeof(header), header.blocksSize);
+    blocks.reserve(header.blockCount);
+    for (std::uint64_t i = 0; i < header.blockCount; ++i) {
+        TapeBlockHeader blockHeader;
+        if (blocksSection.size() < sizeof(blockHeader)) {
+            std::cerr << "tape error : Invalid tape file " << filename << '\n';
+            exit(1);
+        }
+        std::memcpy(&blockHeader, blocksSection.data(), sizeof(blockHeader));
+        blocksSection.remove_prefix(sizeof(blockHeader));
+        if (blockHeader.poolSize > blocksSection.size() || blockHeader.eventsSize > blocksSection.size() - blockHeader.poolSize) {
+            std::cerr << "tape error : Invalid tape file " << filename << '\n';
+            exit(1);
+        }
+        blocks.push_back(Block{ blocksSection.substr(0, blockHeader.poolSize), blocksSection.substr(blockHeader.poolSize, blockHeader.eventsSize) });
+        blocksSection.remove_prefix(blockHeader.poolSize + blockHeader.eventsSize);
+    }
+    if (!blocksSection.empty()) {
+        std::cerr << "tape error : Invalid tape file " << filename << '\n';
+        exit(1);
+    }
+
+    // split the names once, instead of on every event
+    auto p = reinterpret_cast<const unsigned char*>(content.data() + sizeof(header) + header.blocksSize);
+    names.reserve(header.nameCount);
+    for (std::uint32_t i = 0; i < header.nameCount; ++i) {
+        const auto length = readVarint(p);
+        const std::string_view qName(reinterpret_cast<const char*>(p), length);
+        p += length;
+        const auto colonPosition = qName.find(':');
+        if (colonPosition == qName.npos)
+            names.push_back(Name{ qName, std::string_view(), qName });
+        else
+            names.push_back(Name{ qName, qName.substr(0, colonPosition), qName.substr(colonPosition + 1) });
+    }
+}
+
+// call the handler for each event on the tape
+void TapeReplayer::replay(XMLParserHandler& handler) {
+
+    std::uint64_t currentDepth = 0;
+    for (const auto& block : blocks)
+        replayBlock(handler, block, currentDepth);
+}
+
+// call the handler for each event of the block
+void TapeReplayer::replayBlock(XMLParserHandler& handler, const Block& block, std::uint64_t& currentDepth) {
+
+    auto p = reinterpret_cast<const unsigned char*>(block.events.data());
+    const auto end = p + block.events.size();
+    const char* poolPosition = block.pool.data();
+    const auto nextString = [&p, &poolPosition]() {
+        const auto length = readVarint(p);
+        const std::string_view s(poolPosition, length);
+        poolPosition += length;
+        return s;
+    };
+    while (p < end) {
+        switch (static_cast<TapeEvent>(*p++)) {
+        case TapeEvent::START_DOCUMENT:
+            handler.handleStartDocument();
+            break;
+        case TapeEvent::XML_DECLARATION: {
+            const auto flags = *p++;
+            const auto version = nextString();
+            std::optional<std::string_view> encoding;
+            std::optional<std::string_view> standalone;
+            if (flags & 1)
+                encoding = nextString();
+            if (flags & 2)
+                standalone = nextString();
+            handler.handleXMLDeclaration(version, encoding, standalone);
+            break;
+        }
+        case TapeEvent::START_TAG: {
+            const auto& name = names[readVarint(p)];
+            [[maybe_unused]] const auto depth = readVarint(p);
+            ++currentDepth;
+            assert(depth == currentDepth);
+            handler.handleStartTag(name.qName, name.prefix, name.localName);
+            break;
+        }
+        case TapeEvent::END_TAG: {
+            const auto& name = names[readVarint(p)];
+            assert(currentDepth > 0);
+            --currentDepth;
+            handler.handleEndTag(name.qName, name.prefix, name.localName);
+            break;
+        }
+        case TapeEvent::CHARACTERS:
+            handler.handleCharacter(nextString());
+            break;
+        case TapeEvent::ATTRIBUTE: {
+            const auto& name = names[readVarint(p)];
+            handler.handleAttribute(name.qName, name.prefix, name.localName, nextString());
+            break;
+        }
+        case TapeEvent::XML_NAMESPACE: {
+            const auto prefix = nextString();
+            handler.handleXMLNamespace(prefix, nextString());
+            break;
+        }
+        case TapeEvent::XML_COMMENT:
+            handler.handleXMLComment(nextString());
+            break;
+        case TapeEvent::CDATA:
+            handler.handleCDATA(nextString());
+            break;
+        case TapeEvent::PROCESSING_INSTRUCTION: {
+            const auto target = nextString();
+            handler.handleProcessingInstruction(target, nextString());
+            break;
+        }
+        case TapeEvent::END_DOCUMENT:
+            handler.handleEndDocument();
+            break;
+        default:
+            std::cerr << "tape error : Invalid event on the tape\n";
+            exit(1);
+        }
+    }
+}
+
+// get the number of bytes of the input recorded on the tape
+long TapeReplayer::getTotalBytes() {
+    return totalBytes;
+}
@@ -0,0 +1,56 @@
+/*
+    TapeReplayer.hpp
+
+    Header file for replaying an event tape (see EventTape.hpp) to any
+    XMLParserHandler. The tape file is mapped, and the strings passed to the
+    handler are views of the mapped pool.
+*/
+
+#ifndef TAPEREPLAYER_HPP
+#define TAPEREPLAYER_HPP
+
+#include "MappedFile.hpp"
+#include "XMLParserHandler.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+class TapeReplayer {
+public:
+    // constructor, mapping the tape file
+    TapeReplayer(const std::string& filename);
+
+    // call the handler for each event on the tape
+    void replay(XMLParserHandler& handler);
+
+    // get the number of bytes of the input recorded on the tape
+    long getTotalBytes();
+
+private:
+    // interned name split into prefix and localName
+    struct Name {
+        std::string_view qName;
+        std::string_view prefix;
+        std::string_view localName;
+    };
+
+    // pool and events of a block of the tape
+    struct Block {
+        std::string_view pool;
+        std::string_view events;
+    };
+
+    // call the handler for each event of the block
+    void replayBlock(XMLParserHandler& handler, const Block& block, std::uint64_t& currentDepth);
+
+    MappedFile tape;
+
+    long totalBytes;
+
+    std::vector<Block> blocks;
+
+    std::vector<Name> names;
+};
+
+#endif
@@ -0,0 +1,178 @@
+/*
+    TapeWriterHandler.cpp
+
+    Implementation file for the class that records the events of a parse to an
+    event tape file
+*/
+
+#include "TapeWriterHandler.hpp"
+#include "EventTape.hpp"
+#include <iostream>
+#include <cstring>
+
+using namespace event_tape;
+
+// size of the pool or the events of a block written to the file at once
+const std::size_t BLOCK_FLUSH_SIZE = 1024 * 1024;
+
+// constructor, creating the tape file
+TapeWriterHandler::TapeWriterHandler(const std::string& filename)
+    : filename(filename), out(filename, std::ios::binary | std::ios::trunc), blockCount(0), blocksSize(0), depth(0), eventCount(0) {
+
+    if (!out) {
+        std::cerr << "tape error : Unable to create " << filename << '\n';
+        exit(1);
+    }
+
+    // the header is written on close, when the sizes are known
+    const TapeHeader header{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pool.reserve(BLOCK_FLUSH_SIZE + 4096);
+    events.reserve(BLOCK_FLUSH_SIZE + 4096);
+}
+
+// write the rest of the tape file, after the parse
+void TapeWriterHandler::close(long inputBytes) {
+
+    if (!events.empty())
+        writeBlock();
+    std::string namesSection;
+    for (const auto& name : names) {
+        writeVarint(namesSection, name.size());
+        namesSection += name;
+    }
+    out.write(namesSection.data(), namesSection.size());
+
+    TapeHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.nameCount = static_cast<std::uint32_t>(names.size());
+    header.inputBytes = static_cast<std::uint64_t>(inputBytes);
+    header.blockCount = blockCount;
+    header.blocksSize = blocksSize;
+    header.namesSize = namesSection.size();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        std::cerr << "tape error : Unable to write " << filename << '\n';
+        exit(1);
+    }
+}
+
+// get eventCount
+long TapeWriterHandler::getEventCount() {
+    return eventCount;
+}
+
+// write the pool and the events of the block to the file, and start the next block
+void TapeWriterHandler::writeBlock() {
+    const TapeBlockHeader blockHeader{ pool.size(), events.size() };
+    out.write(reinterpret_cast<const char*>(&blockHeader), sizeof(blockHeader));
+    out.write(pool.data(), pool.size());
+    out.write(events.data(), events.size());
+    ++blockCount;
+    blocksSize += sizeof(blockHeader) + pool.size() + events.size();
+    pool.clear();
+    events.clear();
+}
+
+// append the event code
+// A block ends before an event, so the strings of an event are in the pool of its block
+void TapeWriterHandler::writeEvent(unsigned char event) {
+    if (pool.size() >= BLOCK_FLUSH_SIZE || events.size() >= BLOCK_FLUSH_SIZE)
+        writeBlock();
+    events.push_back(static_cast<char>(event));
+    ++eventCount;
+}
+
+// append the ID of the interned name
+void TapeWriterHandler::writeName(std::string_view qName) {
+    auto found = nameIDs.find(qName);
+    if (found == nameIDs.end()) {
+        names.push_back(namePool.store(qName));
+        found = nameIDs.emplace(names.back(), static_cast<std::uint32_t>(names.size() - 1)).first;
+    }
+    writeVarint(events, found->second);
+}
+
+// append the length of the string to the events, and the string to the pool
+void TapeWriterHandler::writeString(std::string_view s) {
+    writeVarint(events, s.size());
+    pool += s;
+}
+
+// start Document Handler
+void TapeWriterHandler::handleStartDocument() {
+    writeEvent(static_cast<unsigned char>(TapeEvent::START_DOCUMENT));
+}
+
+// XML Declaration Handler
+void TapeWriterHandler::handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::XML_DECLARATION));
+    events.push_back(static_cast<char>((encoding ? 1 : 0) | (standalone ? 2 : 0)));
+    writeString(version);
+    if (encoding)
+        writeString(*encoding);
+    if (standalone)
+        writeString(*standalone);
+}
+
+// Start Tag Handler
+void TapeWriterHandler::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::START_TAG));
+    writeName(qName);
+    ++depth;
+    writeVarint(events, static_cast<std::uint64_t>(depth));
+}
+
+// End Tag Handler
+void TapeWriterHandler::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::END_TAG));
+    writeName(qName);
+    --depth;
+}
+
+// Character Handler
+void TapeWriterHandler::handleCharacter(std::string_view characters) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::CHARACTERS));
+    writeString(characters);
+}
+
+// attribute Handler
+void TapeWriterHandler::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::ATTRIBUTE));
+    writeName(qName);
+    writeString(value);
+}
+
+// XML Namespace Handler
+void TapeWriterHandler::handleXMLNamespace(std::string_view prefix, std::string_view uri) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::XML_NAMESPACE));
+    writeString(prefix);
+    writeString(uri);
+}
+
+// XML Comment Handler
+void TapeWriterHandler::handleXMLComment(std::string_view value) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::XML_COMMENT));
+    writeString(value);
+}
+
+// CDATA Handler
+void TapeWriterHandler::handleCDATA(std::string_view characters) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::CDATA));
+    writeString(characters);
+}
+
+// processing Instruction Handler
+void TapeWriterHandler::handleProcessingInstruction(std::string_view target, std::string_view data) {
+    writeEvent(static_cast<unsigned char>(TapeEvent::PROCESSING_INSTRUCTION));
+    writeString(target);
+    writeString(data);
+}
+
+// end Document Handler
+void TapeWriterHandler::handleEndDocument() {
+    writeEvent(static_cast<unsigned char>(TapeEvent::END_DOCUMENT));
+}
@@ -0,0 +1,101 @@
+/*
+    TapeWriterHandler.hpp
+
+    Concrete class that records the events of a parse to an event tape file
+    (see EventTape.hpp), inheriting from the abstract class XMLParserHandler
+*/
+
+#ifndef TAPEWRITERHANDLER_HPP
+#define TAPEWRITERHANDLER_HPP
+
+#include "XMLParserHandler.hpp"
+#include "StringPool.hpp"
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+class TapeWriterHandler : public XMLParserHandler {
+public:
+    // constructor, creating the tape file
+    TapeWriterHandler(const std::string& filename);
+
+    // write the rest of the tape file, after the parse
+    void close(long inputBytes);
+
+    // get eventCount
+    long getEventCount();
+
+protected:
+    // start Document Handler
+    void handleStartDocument() override;
+
+    // XML Declaration Handler
+    void handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) override;
+
+    // Start Tag Handler
+    void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // End Tag Handler
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // Character Handler
+    void handleCharacter(std::string_view characters) override;
+
+    // attribute Handler
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+
+    // XML Namespace Handler
+    void handleXMLNamespace(std::string_view prefix, std::string_view uri) override;
+
+    // XML Comment Handler
+    void handleXMLComment(std::string_view value) override;
+
+    // CDATA Handler
+    void handleCDATA(std::string_view characters) override;
+
+    // processing Instruction Handler
+    void handleProcessingInstruction(std::string_view target, std::string_view data) override;
+
+    // end Document Handler
+    void handleEndDocument() override;
+
+private:
+    // write the pool and the events of the block to the file, and start the next block
+    void writeBlock();
+
+    // append the event code
+    void writeEvent(unsigned char event);
+
+    // append the ID of the interned name
+    void writeName(std::string_view qName);
+
+    // append the length of the string to the events, and the string to the pool
+    void writeString(std::string_view s);
+
+    std::string filename;
+
+    std::ofstream out;
+
+    // pool and events of the block not yet written to the file
+    std::string pool;
+
+    std::string events;
+
+    std::uint64_t blockCount;
+
+    std::uint64_t blocksSize;
+
+    // interned names, with the map keys viewing the names in the pool
+    StringPool namePool;
+    std::vector<std::string_view> names;
+    std::unordered_map<std::string_view, std::uint32_t> nameIDs;
+
+    int depth;
+
+    long eventCount;
+};
+
+#endif
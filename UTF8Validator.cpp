@@ -0,0 +1,286 @@
+/*
+    UTF8Validator.cpp
+
+    Implementation file for a streaming UTF-8 validator.
+*/
+
+#include "UTF8Validator.hpp"
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define UTF8_SSSE3
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define UTF8_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+    // length of the sequence from the lead byte, or 0 for an invalid lead byte
+    int sequenceLength(unsigned char lead) {
+        if (lead < 0x80)
+            return 1;
+        if (lead < 0xC2)
+            return 0;
+        if (lead < 0xE0)
+            return 2;
+        if (lead < 0xF0)
+            return 3;
+        if (lead < 0xF5)
+            return 4;
+        return 0;
+    }
+
+    // valid range of the second byte of a sequence from the lead byte
+    bool isValidSecond(unsigned char lead, unsigned char second) {
+        switch (lead) {
+        case 0xE0: return second >= 0xA0 && second <= 0xBF;
+        case 0xED: return second >= 0x80 && second <= 0x9F;
+        case 0xF0: return second >= 0x90 && second <= 0xBF;
+        case 0xF4: return second >= 0x80 && second <= 0x8F;
+        default:   return second >= 0x80 && second <= 0xBF;
+        }
+    }
+
+    // scalar validation of complete sequences
+    // @return Position of the first invalid sequence, or npos
+    std::size_t validateScalar(const unsigned char* data, std::size_t size) {
+        std::size_t pos = 0;
+        while (pos < size) {
+            // skip 8 ASCII bytes at a time
+            if (pos + 8 <= size) {
+                std::uint64_t word;
+                std::memcpy(&word, data + pos, sizeof(word));
+                if ((word & 0x8080808080808080ULL) == 0) {
+                    pos += 8;
+                    continue;
+                }
+            }
+            const auto length = sequenceLength(data[pos]);
+            if (length == 0 || pos + length > size)
+                return pos;
+            if (length > 1 && !isValidSecond(data[pos], data[pos + 1]))
+                return pos;
+            for (int i = 2; i < length; ++i) {
+                if ((data[pos + i] & 0xC0) != 0x80)
+                    return pos;
+            }
+            pos += length;
+        }
+        return std::string_view::npos;
+    }
+
+    // error bits of the lookup tables for a pair of bytes
+    constexpr std::uint8_t TOO_SHORT = 1 << 0;
+    constexpr std::uint8_t TOO_LONG = 1 << 1;
+    constexpr std::uint8_t OVERLONG_3 = 1 << 2;
+    constexpr std::uint8_t TOO_LARGE = 1 << 3;
+    constexpr std::uint8_t SURROGATE = 1 << 4;
+    constexpr std::uint8_t OVERLONG_2 = 1 << 5;
+    constexpr std::uint8_t TOO_LARGE_1000 = 1 << 6;
+    constexpr std::uint8_t OVERLONG_4 = 1 << 6;
+    constexpr std::uint8_t TWO_CONTS = 1 << 7;
+    constexpr std::uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    // error bits by the high nibble of the first byte
+    alignas(16) constexpr std::uint8_t BYTE_1_HIGH[16] = {
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+    };
+
+    // error bits by the low nibble of the first byte
+    alignas(16) constexpr std::uint8_t BYTE_1_LOW[16] = {
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000
+    };
+
+    // error bits by the high nibble of the second byte
+    alignas(16) constexpr std::uint8_t BYTE_2_HIGH[16] = {
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+    };
+
+#if defined(UTF8_SSSE3)
+
+    // vector validation of complete sequences, 16 bytes at a time
+    // @return If all sequences are valid
+    __attribute__((target("ssse3")))
+    bool validateVector(const unsigned char* data, std::size_t size) {
+        const auto byte1HighTable = _mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_1_HIGH));
+        const auto byte1LowTable = _mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_1_LOW));
+        const auto byte2HighTable = _mm_load_si128(reinterpret_cast<const __m128i*>(BYTE_2_HIGH));
+        const auto lowNibble = _mm_set1_epi8(0x0F);
+        auto previous = _mm_setzero_si128();
+        auto error = _mm_setzero_si128();
+        // the last chunk is partial, or all padding, so that a lead byte at the end is checked
+        for (std::size_t pos = 0; pos <= size; pos += 16) {
+            __m128i input;
+            if (pos + 16 <= size) {
+                input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            } else {
+                // the range ends on a sequence boundary, so pad with ASCII
+                alignas(16) unsigned char last[16] = {};
+                std::memcpy(last, data + pos, size - pos);
+                input = _mm_load_si128(reinterpret_cast<const __m128i*>(last));
+            }
+            if (_mm_movemask_epi8(input) != 0 || _mm_movemask_epi8(previous) != 0) {
+                const auto previous1 = _mm_alignr_epi8(input, previous, 15);
+                const auto byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(previous1, 4), lowNibble));
+                const auto byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(previous1, lowNibble));
+                const auto byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble));
+                const auto specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+                const auto previous2 = _mm_alignr_epi8(input, previous, 14);
+                const auto previous3 = _mm_alignr_epi8(input, previous, 13);
+                const auto isThirdByte = _mm_subs_epu8(previous2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+                const auto isFourthByte = _mm_subs_epu8(previous3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+                const auto must23 = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte), _mm_set1_epi8(static_cast<char>(0x80)));
+                error = _mm_or_si128(error, _mm_xor_si128(must23, specialCases));
+            }
+            previous = input;
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+    }
+
+    // SSSE3 is available at runtime
+    const bool hasVector = __builtin_cpu_supports("ssse3");
+
+#elif defined(UTF8_NEON)
+
+    // vector validation of complete sequences, 16 bytes at a time
+    // @return If all sequences are valid
+    bool validateVector(const unsigned char* data, std::size_t size) {
+        const auto byte1HighTable = vld1q_u8(BYTE_1_HIGH);
+        const auto byte1LowTable = vld1q_u8(BYTE_1_LOW);
+        const auto byte2HighTable = vld1q_u8(BYTE_2_HIGH);
+        const auto lowNibble = vdupq_n_u8(0x0F);
+        auto previous = vdupq_n_u8(0);
+        auto error = vdupq_n_u8(0);
+        // the last chunk is partial, or all padding, so that a lead byte at the end is checked
+        for (std::size_t pos = 0; pos <= size; pos += 16) {
+            uint8x16_t input;
+            if (pos + 16 <= size) {
+                input = vld1q_u8(data + pos);
+            } else {
+                // the range ends on a sequence boundary, so pad with ASCII
+                unsigned char last[16] = {};
+                std::memcpy(last, data + pos, size - pos);
+                input = vld1q_u8(last);
+            }
+            if (vmaxvq_u8(vorrq_u8(input, previous)) >= 0x80) {
+                const auto previous1 = vextq_u8(previous, input, 15);
+                const auto byte1High = vqtbl1q_u8(byte1HighTable, vshrq_n_u8(previous1, 4));
+                const auto byte1Low = vqtbl1q_u8(byte1LowTable, vandq_u8(previous1, lowNibble));
+                const auto byte2High = vqtbl1q_u8(byte2HighTable, vshrq_n_u8(input, 4));
+                const auto specialCases = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+                const auto previous2 = vextq_u8(previous, input, 14);
+                const auto previous3 = vextq_u8(previous, input, 13);
+                const auto isThirdByte = vqsubq_u8(previous2, vdupq_n_u8(0xE0 - 0x80));
+                const auto isFourthByte = vqsubq_u8(previous3, vdupq_n_u8(0xF0 - 0x80));
+                const auto must23 = vandq_u8(vorrq_u8(isThirdByte, isFourthByte), vdupq_n_u8(0x80));
+                error = vorrq_u8(error, veorq_u8(must23, specialCases));
+            }
+            previous = input;
+        }
+        return vmaxvq_u8(error) == 0;
+    }
+
+    // NEON is always available on AArch64
+    const bool hasVector = true;
+
+#endif
+
+    // validate complete sequences with the fastest available method
+    // @return Position of the first invalid sequence, or npos
+    std::size_t validateSequences(const unsigned char* data, std::size_t size) {
+#if defined(UTF8_SSSE3) || defined(UTF8_NEON)
+        // the vector check only finds if there is an error, the scalar check finds where
+        if (hasVector && validateVector(data, size))
+            return std::string_view::npos;
+#endif
+        return validateScalar(data, size);
+    }
+}
+
+// constructor
+UTF8Validator::UTF8Validator()
+    : carrySize(0), carryOffset(0), totalBytes(0)
+    {}
+
+// validate the next block of the stream
+long UTF8Validator::validate(std::string_view block) {
+    const auto data = reinterpret_cast<const unsigned char*>(block.data());
+    const auto blockOffset = totalBytes;
+    totalBytes += static_cast<long>(block.size());
+    std::size_t pos = 0;
+
+    // complete the sequence carried over from the previous block
+    if (carrySize > 0) {
+        const auto length = static_cast<std::size_t>(sequenceLength(carry[0]));
+        while (carrySize < length && pos < block.size())
+            carry[carrySize++] = data[pos++];
+        if (carrySize < length)
+            return -1;
+        carrySize = 0;
+        if (validateScalar(carry, length) != std::string_view::npos)
+            return carryOffset;
+    }
+
+    // hold back an incomplete sequence at the end of the block
+    auto end = block.size();
+    for (std::size_t back = 1; back <= 3 && back <= end - pos; ++back) {
+        const auto c = data[end - back];
+        if ((c & 0xC0) == 0x80)
+            continue;
+        const auto length = static_cast<std::size_t>(sequenceLength(c));
+        if (length > back) {
+            end -= back;
+            std::memcpy(carry, data + end, back);
+            carrySize = back;
+            carryOffset = blockOffset + static_cast<long>(end);
+        }
+        break;
+    }
+
+    const auto invalidPosition = validateSequences(data + pos, end - pos);
+    if (invalidPosition != std::string_view::npos)
+        return blockOffset + static_cast<long>(pos + invalidPosition);
+
+    return -1;
+}
+
+// validate the end of the stream, i.e., no incomplete sequence is left
+long UTF8Validator::finish() {
+    if (carrySize > 0)
+        return carryOffset;
+
+    return -1;
+}
+
+// get the number of bytes validated
+long UTF8Validator::getTotalBytes() {
+    return totalBytes;
+}
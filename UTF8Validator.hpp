@@ -0,0 +1,48 @@
+/*
+    UTF8Validator.hpp
+
+    Header file for a streaming UTF-8 validator.
+
+    The content is validated block by block as it is read, so a multi-byte
+    sequence may be split between blocks. Validation uses the lookup-table
+    algorithm of Keiser and Lemire with SSSE3 (x86-64, checked at runtime)
+    or NEON (AArch64), with a scalar fallback.
+*/
+
+#ifndef UTF8VALIDATOR_HPP
+#define UTF8VALIDATOR_HPP
+
+#include <string_view>
+#include <cstddef>
+
+class UTF8Validator {
+public:
+    // constructor
+    UTF8Validator();
+
+    // validate the next block of the stream
+    // @return Stream offset of the first invalid byte, or -1 if valid so far
+    long validate(std::string_view block);
+
+    // validate the end of the stream, i.e., no incomplete sequence is left
+    // @return Stream offset of the incomplete sequence, or -1 if valid
+    long finish();
+
+    // get the number of bytes validated
+    long getTotalBytes();
+
+private:
+    // number of bytes in the incomplete sequence at the end of the previous block
+    std::size_t carrySize;
+
+    // incomplete sequence at the end of the previous block
+    unsigned char carry[4];
+
+    // offset in the stream of the incomplete sequence
+    long carryOffset;
+
+    // offset in the stream of the start of the next block
+    long totalBytes;
+};
+
+#endif
@@ -0,0 +1,239 @@
+/*
+    UnitChunker.cpp
+
+    Implementation file for cutting a srcML document read from standard input
+    into chunks of complete top-level units.
+*/
+
+#include "UnitChunker.hpp"
+#include "refillContent.hpp"
+#include "xml_parser.hpp"
+#include <iostream>
+#include <string_view>
+#include <algorithm>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+using namespace xml_parser;
+
+namespace {
+
+    // position of the '>' at the end of the start tag at pos, or npos if the tag is not complete
+    std::size_t findCompleteTagEnd(std::string_view buffer, std::size_t pos) {
+        while (true) {
+            pos = buffer.find_first_of("\"'>"sv, pos);
+            if (pos == buffer.npos || buffer[pos] == '>')
+                return pos;
+            pos = buffer.find(buffer[pos], pos + 1);
+            if (pos == buffer.npos)
+                return pos;
+            ++pos;
+        }
+    }
+
+    // unit start tag at pos, i.e., not a longer name that starts with "unit"
+    // The character after the name must be in the buffer
+    bool isUnitStartTag(std::string_view buffer, std::size_t pos) {
+        const auto after = buffer[pos + "<unit"sv.size()];
+        return isClass(after, WHITESPACE_CHARACTER) || after == '>' || after == '/';
+    }
+
+    // earliest start of a unit literal that ends at or after the position, i.e., that
+    // may be split there, and not before the start of the buffer
+    std::size_t splitLiteralStart(std::size_t position) {
+        return position > "</unit>"sv.size() ? position - "</unit>"sv.size() : 0;
+    }
+
+    // content before the root element is only the XML declaration, processing instructions, DOCTYPE, and comments
+    bool isProlog(std::string_view content) {
+        skipWhitespace(content);
+        while (!content.empty()) {
+            if (isComment(content)) {
+                if (!parseComment(content))
+                    return false;
+            } else if (isCharacter(content, 0, '<') && isCharacter(content, 1, '?')) {
+                skipProcessing(content);
+            } else if (isDOCTYPE(content)) {
+                parseDOCTYPE(content);
+            } else {
+                return false;
+            }
+            skipWhitespace(content);
+        }
+        return true;
+    }
+}
+
+// constructor, with the size of the units in a chunk before it is complete
+UnitChunker::UnitChunker(std::size_t chunkSize)
+    : chunkSize(chunkSize), searchPosition(0), gapStart(0), unitStart(0), tagEnd(std::string::npos),
+      state(State::PROLOG), foundUnit(false), totalBytes(0), endOfInput(false) {}
+
+// cut the next chunk of complete units
+// @return false at the end of the input, with no more units
+bool UnitChunker::next(UnitChunk& chunk) {
+
+    chunk.units.clear();
+    std::size_t unitsEnd = 0;
+    while (true) {
+        // a search that does not find its literal, or a tag that is not complete, needs more input
+        bool needInput = false;
+        switch (state) {
+        case State::PROLOG: {
+            // root unit start tag, after the XML declaration
+            const auto rootStart = findLiteral(buffer, "<unit"sv, 0);
+            if (rootStart == buffer.npos || rootStart + "<unit"sv.size() >= buffer.size()) {
+                needInput = true;
+                break;
+            }
+            if (!isUnitStartTag(buffer, rootStart) || !isProlog(std::string_view(buffer).substr(0, rootStart))) {
+                std::cerr << "parser error : Root element is not a srcML unit\n";
+                exit(1);
+            }
+            const auto rootTagEnd = findCompleteTagEnd(buffer, rootStart);
+            if (rootTagEnd == buffer.npos) {
+                needInput = true;
+                break;
+            }
+            gapStart = rootTagEnd + ">"sv.size();
+            envelope.append(buffer, 0, gapStart);
+            searchPosition = gapStart;
+            state = buffer[rootTagEnd - 1] == '/' ? State::EPILOG : State::BETWEEN_UNITS;
+            break;
+        }
+        case State::BETWEEN_UNITS: {
+            // the next unit, or the end of the root unit in the content before it
+            const auto nextUnit = findLiteral(buffer, "<unit"sv, searchPosition);
+            const auto gapEnd = nextUnit == buffer.npos ? buffer.size() : nextUnit;
+            if (findLiteral(std::string_view(buffer).substr(0, gapEnd), "</unit>"sv, searchPosition) != buffer.npos) {
+                state = State::EPILOG;
+                break;
+            }
+            if (nextUnit == buffer.npos || nextUnit + "<unit"sv.size() >= buffer.size()) {
+                // a literal may be split at the end of the buffer, e.g., of the short rest after a chunk
+                searchPosition = std::max(searchPosition, splitLiteralStart(std::min(nextUnit, buffer.size())));
+                needInput = true;
+                break;
+            }
+            if (!isUnitStartTag(buffer, nextUnit)) {
+                searchPosition = nextUnit + "<unit"sv.size();
+                break;
+            }
+
+            // each unit is replaced by an empty CDATA section in the envelope
+            envelope.append(buffer, gapStart, nextUnit - gapStart);
+            envelope += "<![CDATA[]]>"sv;
+            unitStart = nextUnit;
+            tagEnd = buffer.npos;
+            foundUnit = true;
+            state = State::IN_UNIT;
+            break;
+        }
+        case State::IN_UNIT: {
+            std::size_t unitEnd = 0;
+            if (tagEnd == buffer.npos) {
+                tagEnd = findCompleteTagEnd(buffer, unitStart);
+                if (tagEnd == buffer.npos) {
+                    needInput = true;
+                    break;
+                }
+                searchPosition = tagEnd;
+            }
+            if (buffer[tagEnd - 1] == '/') {
+                unitEnd = tagEnd + ">"sv.size();
+            } else {
+                const auto endTag = findLiteral(buffer, "</unit>"sv, searchPosition);
+                if (endTag == buffer.npos) {
+                    // a literal may be split at the end of the buffer
+                    searchPosition = std::max(searchPosition, splitLiteralStart(buffer.size()));
+                    needInput = true;
+                    break;
+                }
+                unitEnd = endTag + "</unit>"sv.size();
+            }
+            chunk.units.push_back(UnitRange{ unitStart, unitEnd - unitStart });
+            unitsEnd = unitEnd;
+            gapStart = unitEnd;
+            searchPosition = unitEnd;
+            state = State::BETWEEN_UNITS;
+
+            // the chunk is complete, with the rest of the buffer kept for the next chunk
+            if (unitsEnd >= chunkSize) {
+                chunk.offset = totalBytes - static_cast<long>(buffer.size());
+                std::string rest(buffer, unitsEnd);
+                buffer.resize(unitsEnd);
+                chunk.content = std::move(buffer);
+                buffer = std::move(rest);
+                gapStart = 0;
+                searchPosition = 0;
+                return true;
+            }
+            break;
+        }
+        case State::EPILOG:
+            // the rest of the input is the end of the root unit
+            while (readInput()) {
+            }
+
+            // without units the whole document is the envelope, so there is no copy
+            if (!foundUnit) {
+                envelope = std::move(buffer);
+                buffer = std::string();
+                return false;
+            }
+            envelope.append(buffer, gapStart);
+            chunk.offset = totalBytes - static_cast<long>(buffer.size());
+            buffer.resize(unitsEnd);
+            gapStart = 0;
+            searchPosition = 0;
+            if (chunk.units.empty()) {
+                buffer.clear();
+                return false;
+            }
+            chunk.content = std::move(buffer);
+            buffer = std::string();
+            return true;
+        }
+
+        if (needInput && !readInput()) {
+            if (state == State::PROLOG) {
+                std::cerr << "parser error : No srcML unit in the input\n";
+            } else {
+                std::cerr << "parser error : Unterminated srcML unit\n";
+            }
+            exit(1);
+        }
+    }
+}
+
+// get the document without the units, complete after the end of the input
+// Each unit is replaced by an empty CDATA section, as in unitEnvelope()
+const std::string& UnitChunker::getEnvelope() {
+    return envelope;
+}
+
+// get totalBytes
+long UnitChunker::getTotalBytes() {
+    return totalBytes;
+}
+
+// read more input into the buffer
+// @return false at the end of the input
+bool UnitChunker::readInput() {
+    if (endOfInput)
+        return false;
+    std::string_view content;
+    const int bytesRead = refillContent(content);
+    if (bytesRead < 0) {
+        std::cerr << "parser error : File input error\n";
+        exit(1);
+    }
+    if (bytesRead == 0) {
+        endOfInput = true;
+        return false;
+    }
+    buffer.append(content.data(), bytesRead);
+    totalBytes += bytesRead;
+    return true;
+}
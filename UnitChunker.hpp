@@ -0,0 +1,83 @@
+/*
+    UnitChunker.hpp
+
+    Header file for cutting a srcML document read from standard input into
+    chunks of complete top-level units, without reading the whole document.
+
+    Each chunk is one or more complete units of a srcML archive, so the units
+    of a chunk can be parsed separately from the rest of the document. What is
+    not in a unit, e.g., the XML declaration, the root unit tags, and the
+    newlines between the units, is collected as the envelope. For a single unit,
+    not an archive, the whole document is the envelope.
+*/
+
+#ifndef UNITCHUNKER_HPP
+#define UNITCHUNKER_HPP
+
+#include "findUnits.hpp"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// chunk of complete units, with the ranges of the units in the content,
+// and the offset in the document of the start of the content
+struct UnitChunk {
+    std::string content;
+    std::vector<UnitRange> units;
+    long offset = 0;
+};
+
+class UnitChunker {
+public:
+    // constructor, with the size of the units in a chunk before it is complete
+    UnitChunker(std::size_t chunkSize);
+
+    // cut the next chunk of complete units
+    // @return false at the end of the input, with no more units
+    bool next(UnitChunk& chunk);
+
+    // get the document without the units, complete after the end of the input
+    // Each unit is replaced by an empty CDATA section, as in unitEnvelope()
+    const std::string& getEnvelope();
+
+    // get totalBytes
+    long getTotalBytes();
+
+private:
+    // read more input into the buffer
+    // @return false at the end of the input
+    bool readInput();
+
+    // scan state
+    enum class State { PROLOG, BETWEEN_UNITS, IN_UNIT, EPILOG };
+
+    std::size_t chunkSize;
+
+    // input not yet in a chunk or in the envelope, starting with the current unit
+    std::string buffer;
+
+    // position in the buffer to continue a search, so input is not scanned twice
+    std::size_t searchPosition;
+
+    // start of the content after the last unit, not yet in the envelope
+    std::size_t gapStart;
+
+    // start of the current unit
+    std::size_t unitStart;
+
+    // end of the start tag of the current unit, or npos when not yet found
+    std::size_t tagEnd;
+
+    State state;
+
+    // a unit was found in the root unit, so the document is an archive
+    bool foundUnit;
+
+    std::string envelope;
+
+    long totalBytes;
+
+    bool endOfInput;
+};
+
+#endif
@@ -0,0 +1,202 @@
+/*
+    UnitIndex.cpp
+
+    Implementation file for the sidecar unit index of a srcML archive.
+*/
+
+#include "UnitIndex.hpp"
+#include "findUnits.hpp"
+#include "hashContent.hpp"
+#include "xml_parser.hpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    const char MAGIC[8] = "SRCFIDX";
+
+    const std::uint32_t VERSION = 1;
+
+    // header of the index file
+    struct IndexHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t unitCount;
+        std::uint64_t archiveSize;
+        std::uint64_t stringsOffset;
+    };
+
+    // record of a unit in the index file
+    // Strings are an offset and a length in the strings of the index file
+    struct IndexRecord {
+        std::uint64_t offset;
+        std::uint64_t length;
+        std::uint64_t hash;
+        std::uint32_t filenameOffset;
+        std::uint32_t filenameLength;
+        std::uint32_t languageOffset;
+        std::uint32_t languageLength;
+    };
+
+    static_assert(sizeof(IndexHeader) == 32 && sizeof(IndexRecord) == 40, "index file layout has no padding");
+
+    // get the filename and language attributes from the unit start tag
+    void parseUnitAttributes(std::string_view content, std::string_view& filename, std::string_view& language) {
+        using namespace xml_parser;
+        std::string_view qName;
+        std::string_view prefix;
+        std::string_view localName;
+        parseStartTag(content, qName, prefix, localName);
+        skipWhitespace(content);
+        while (!content.empty() && isClass(content[0], NAME_CHARACTER)) {
+            if (isNamespace(content)) {
+                parseNamespace(content);
+                continue;
+            }
+            const auto value = parseAttribute(content, qName, prefix, localName);
+            if (localName == "filename"sv)
+                filename = value;
+            else if (localName == "language"sv)
+                language = value;
+            content.remove_prefix("\""sv.size());
+            skipWhitespace(content);
+        }
+    }
+
+    // record of the unit at the position
+    const IndexRecord& getRecord(std::string_view index, std::size_t position) {
+        return reinterpret_cast<const IndexRecord*>(index.data() + sizeof(IndexHeader))[position];
+    }
+}
+
+// build the index of the srcML archive and write it to the index file
+// @return Number of units in the index
+std::size_t UnitIndex::build(const std::string& archiveFilename, const std::string& indexFilename) {
+
+    MappedFile archive(archiveFilename);
+    const auto document = archive.getContent();
+    const auto units = findUnits(document);
+
+    std::vector<IndexRecord> records;
+    records.reserve(units.size());
+    std::string strings;
+    const auto addString = [&strings](std::string_view s, std::uint32_t& offset, std::uint32_t& length) {
+        offset = static_cast<std::uint32_t>(strings.size());
+        length = static_cast<std::uint32_t>(s.size());
+        strings += s;
+    };
+    for (const auto& unit : units) {
+        const auto content = document.substr(unit.offset, unit.length);
+        std::string_view filename;
+        std::string_view language;
+        parseUnitAttributes(content, filename, language);
+        IndexRecord record{ unit.offset, unit.length, hashContent(content), 0, 0, 0, 0 };
+        addString(filename, record.filenameOffset, record.filenameLength);
+        addString(language, record.languageOffset, record.languageLength);
+        records.push_back(record);
+    }
+
+    IndexHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.unitCount = static_cast<std::uint32_t>(records.size());
+    header.archiveSize = document.size();
+    header.stringsOffset = sizeof(IndexHeader) + records.size() * sizeof(IndexRecord);
+
+    std::ofstream out(indexFilename, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(IndexRecord));
+    out.write(strings.data(), strings.size());
+    out.close();
+    if (!out) {
+        std::cerr << "index error : Unable to write " << indexFilename << '\n';
+        exit(1);
+    }
+
+    return records.size();
+}
+
+// default index filename for the srcML archive
+std::string UnitIndex::indexFilename(const std::string& archiveFilename) {
+    return archiveFilename + ".idx";
+}
+
+// constructor, mapping the srcML archive and its index file
+UnitIndex::UnitIndex(const std::string& archiveFilename, const std::string& indexFilename)
+    : archiveName(archiveFilename), indexName(indexFilename), archive(archiveFilename), index(indexFilename), unitCount(0) {
+
+    const auto content = index.getContent();
+    IndexHeader header;
+    if (content.size() < sizeof(header)) {
+        std::cerr << "index error : Invalid index file " << indexFilename << '\n';
+        exit(1);
+    }
+    std::memcpy(&header, content.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.version != VERSION
+        || header.stringsOffset != sizeof(IndexHeader) + header.unitCount * sizeof(IndexRecord)
+        || header.stringsOffset > content.size()) {
+        std::cerr << "index error : Invalid index file " << indexFilename << '\n';
+        exit(1);
+    }
+    if (header.archiveSize != archive.getContent().size()) {
+        std::cerr << "index error : Index file " << indexFilename << " is out of date for " << archiveFilename << '\n';
+        exit(1);
+    }
+    unitCount = header.unitCount;
+    strings = content.substr(header.stringsOffset);
+}
+
+// get the number of units
+std::size_t UnitIndex::getUnitCount() {
+    return unitCount;
+}
+
+// get the unit at the position in the archive
+UnitIndex::Unit UnitIndex::getUnit(std::size_t position) {
+    const auto& record = getRecord(index.getContent(), position);
+    return Unit{ record.offset, record.length, record.hash,
+                 strings.substr(record.filenameOffset, record.filenameLength),
+                 strings.substr(record.languageOffset, record.languageLength) };
+}
+
+// find the position of the first unit with the filename
+std::optional<std::size_t> UnitIndex::findUnit(std::string_view filename) {
+    for (std::size_t position = 0; position < unitCount; ++position) {
+        const auto& record = getRecord(index.getContent(), position);
+        if (strings.substr(record.filenameOffset, record.filenameLength) == filename)
+            return position;
+    }
+    return std::nullopt;
+}
+
+// whether the content of the unit at the position differs from its hash in the index
+bool UnitIndex::hasChanged(std::size_t position) {
+    return hashContent(getRange(position)) != getRecord(index.getContent(), position).hash;
+}
+
+// get the srcML of the unit at the position in the archive
+// A unit that has changed since the index was built is an error
+std::string_view UnitIndex::getUnitContent(std::size_t position) {
+    if (hasChanged(position)) {
+        std::cerr << "index error : Unit " << position << " " << getUnit(position).filename << " of " << archiveName
+                  << " has changed since " << indexName << " was built, rebuild the index\n";
+        exit(1);
+    }
+    return getRange(position);
+}
+
+// srcML of the unit at the position, as recorded in the index
+std::string_view UnitIndex::getRange(std::size_t position) {
+    const auto& record = getRecord(index.getContent(), position);
+    const auto content = archive.getContent();
+    if (record.offset > content.size()) {
+        std::cerr << "index error : Invalid index file " << indexName << '\n';
+        exit(1);
+    }
+    return content.substr(record.offset, record.length);
+}
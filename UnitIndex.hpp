@@ -0,0 +1,93 @@
+/*
+    UnitIndex.hpp
+
+    Header file for the sidecar unit index of a srcML archive.
+
+    The index records, for every top-level unit of the archive, its byte offset
+    and length, the filename and language attributes, and a hash of its content.
+    The index file is compact and is mapped directly, so opening the index and
+    going to a unit does not read the archive from the start. The content of a
+    unit is checked against its hash before it is used, so an archive changed
+    in place, with the same size, is not parsed with the ranges of the old one.
+
+    Index file layout, in the byte order of the machine:
+    * Header: magic "SRCFIDX", version, unit count, archive size, offset of the strings
+    * Records: one fixed-size record per unit
+    * Strings: filename and language attribute values referenced by the records
+*/
+
+#ifndef UNITINDEX_HPP
+#define UNITINDEX_HPP
+
+#include "MappedFile.hpp"
+#include "XMLParser.hpp"
+#include "XMLParserHandler.hpp"
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+class UnitIndex {
+public:
+    // unit of the archive
+    struct Unit {
+        std::uint64_t offset;
+        std::uint64_t length;
+        std::uint64_t hash;
+        std::string_view filename;
+        std::string_view language;
+    };
+
+    // build the index of the srcML archive and write it to the index file
+    // @return Number of units in the index
+    static std::size_t build(const std::string& archiveFilename, const std::string& indexFilename);
+
+    // default index filename for the srcML archive
+    static std::string indexFilename(const std::string& archiveFilename);
+
+    // constructor, mapping the srcML archive and its index file
+    UnitIndex(const std::string& archiveFilename, const std::string& indexFilename);
+
+    // get the number of units
+    std::size_t getUnitCount();
+
+    // get the unit at the position in the archive
+    Unit getUnit(std::size_t position);
+
+    // find the position of the first unit with the filename
+    std::optional<std::size_t> findUnit(std::string_view filename);
+
+    // whether the content of the unit at the position differs from its hash in the index
+    bool hasChanged(std::size_t position);
+
+    // get the srcML of the unit at the position in the archive
+    // A unit that has changed since the index was built is an error
+    std::string_view getUnitContent(std::size_t position);
+
+    // parse only the unit at the position in the archive
+    template <class Parser = XMLParser>
+    void parseUnit(std::size_t position, XMLParserHandler& handler) {
+        Parser parser(getUnitContent(position), handler);
+        parser.setBaseOffset(static_cast<long>(getUnit(position).offset));
+        parser.parse();
+    }
+
+private:
+    // srcML of the unit at the position, as recorded in the index
+    std::string_view getRange(std::size_t position);
+
+    std::string archiveName;
+
+    std::string indexName;
+
+    MappedFile archive;
+
+    MappedFile index;
+
+    std::size_t unitCount;
+
+    std::string_view strings;
+};
+
+#endif
@@ -0,0 +1,54 @@
+/*
+    UnitTree.cpp
+
+    Implementation file for a compact tree of a srcML unit.
+*/
+
+#include "UnitTree.hpp"
+
+// constructor, with the names of the nodes
+UnitTree::UnitTree(const NameTable& names) : names(names) {}
+
+// get the number of nodes
+std::uint32_t UnitTree::size() const {
+    return static_cast<std::uint32_t>(nodes.size());
+}
+
+// get the name of the node
+std::string_view UnitTree::getName(const UnitNode& node) const {
+    return node.name == NameTable::NONE ? std::string_view() : names.getName(node.name);
+}
+
+// get the text of a text node, or the value of an attribute
+std::string_view UnitTree::getText(const UnitNode& node) const {
+    return std::string_view(text).substr(node.textOffset, node.textSize);
+}
+
+// value of the attribute of the element with the name, e.g., the filename of the unit
+std::optional<std::string_view> UnitTree::getAttribute(std::uint32_t element, std::uint32_t name) const {
+
+    // the attributes are the first children
+    for (auto child = nodes[element].firstChild; child != NONE && nodes[child].kind == UnitNodeKind::ATTRIBUTE; child = nodes[child].nextSibling) {
+        if (nodes[child].name == name)
+            return getText(nodes[child]);
+    }
+    return std::nullopt;
+}
+
+// all the text in the element, e.g., of a name with other names in it
+std::string UnitTree::getAllText(std::uint32_t element) const {
+
+    // the nodes of the element are the nodes after it, up to the next sibling of
+    // the element or of one of its ancestors
+    auto end = element;
+    while (end != NONE && nodes[end].nextSibling == NONE)
+        end = nodes[end].parent;
+    const auto last = end == NONE ? size() : nodes[end].nextSibling;
+
+    std::string all;
+    for (auto node = element + 1; node < last; ++node) {
+        if (nodes[node].kind == UnitNodeKind::TEXT)
+            all += getText(nodes[node]);
+    }
+    return all;
+}
@@ -0,0 +1,94 @@
+/*
+    UnitTree.hpp
+
+    Header file for a compact tree of a srcML unit, e.g., for an analysis with
+    parent and child navigation, such as the returns of each function, that
+    the flat callbacks of a handler make hard.
+
+    The nodes are in an array in document order, with the root at 0, and each
+    node refers to its parent, first child, and next sibling by index. The
+    attributes of an element are its first children. Names are numbers in a
+    name table (see NameTable.hpp), and text is a span of the text of the tree:
+
+        for (auto child = tree[node].firstChild; child != UnitTree::NONE; child = tree[child].nextSibling) {
+            if (tree[child].kind == UnitNodeKind::ELEMENT && tree[child].name == returnName)
+                ++returnCount;
+        }
+
+    The tree is built a unit at a time (see UnitTreeBuilder.hpp), and its
+    arrays are reused for the next unit, so the memory is of the largest unit,
+    not of the archive.
+*/
+
+#ifndef UNITTREE_HPP
+#define UNITTREE_HPP
+
+#include "NameTable.hpp"
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <cstdint>
+
+// kind of a node of a unit tree
+enum class UnitNodeKind : std::uint8_t {
+    ELEMENT,
+    ATTRIBUTE,
+    TEXT,
+};
+
+// node of a unit tree, with the related nodes as indices in the tree
+struct UnitNode {
+    UnitNodeKind kind;
+
+    // name of an element or attribute in the name table
+    std::uint32_t name;
+
+    std::uint32_t parent;
+    std::uint32_t firstChild;
+    std::uint32_t nextSibling;
+
+    // text, or value of an attribute, in the text of the tree
+    std::uint32_t textOffset;
+    std::uint32_t textSize;
+};
+
+class UnitTree {
+public:
+    // index of no node, e.g., the parent of the root
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    // constructor, with the names of the nodes
+    UnitTree(const NameTable& names);
+
+    // node at the index
+    const UnitNode& operator[](std::uint32_t index) const {
+        return nodes[index];
+    }
+
+    // get the number of nodes
+    std::uint32_t size() const;
+
+    // get the name of the node
+    std::string_view getName(const UnitNode& node) const;
+
+    // get the text of a text node, or the value of an attribute
+    std::string_view getText(const UnitNode& node) const;
+
+    // value of the attribute of the element with the name, e.g., the filename of the unit
+    std::optional<std::string_view> getAttribute(std::uint32_t element, std::uint32_t name) const;
+
+    // all the text in the element, e.g., of a name with other names in it
+    std::string getAllText(std::uint32_t element) const;
+
+private:
+    friend class UnitTreeBuilder;
+
+    // data members
+    const NameTable& names;
+
+    std::vector<UnitNode> nodes;
+    std::string text;
+};
+
+#endif
@@ -0,0 +1,151 @@
+/*
+    UnitTreeBuilder.cpp
+
+    Implementation file for the handler that builds the tree of each srcML unit.
+*/
+
+#include "UnitTreeBuilder.hpp"
+#include <iostream>
+#include <cstdlib>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// constructor
+UnitTreeBuilder::UnitTreeBuilder()
+    : tree(names), depth(0), building(false), unitCount(0), unitName(names.intern("unit"sv)) {}
+
+// get the names of the trees, e.g., to number the names of an analysis
+NameTable& UnitTreeBuilder::getNames() {
+    return names;
+}
+
+// get the number of units
+long UnitTreeBuilder::getUnitCount() {
+    return unitCount;
+}
+
+// add the node as the last child of the innermost open element
+std::uint32_t UnitTreeBuilder::addNode(UnitNodeKind kind, std::uint32_t name) {
+
+    const auto node = static_cast<std::uint32_t>(tree.nodes.size());
+    auto& parent = open.back();
+    tree.nodes.push_back(UnitNode{ kind, name, parent.node, UnitTree::NONE, UnitTree::NONE, 0, 0 });
+    if (parent.lastChild == UnitTree::NONE)
+        tree.nodes[parent.node].firstChild = node;
+    else
+        tree.nodes[parent.lastChild].nextSibling = node;
+    parent.lastChild = node;
+
+    return node;
+}
+
+// append to the text of the tree
+// @return Offset of the text
+std::uint32_t UnitTreeBuilder::appendText(std::string_view text) {
+
+    const auto offset = tree.text.size();
+    if (offset + text.size() > UINT32_MAX) {
+        std::cerr << "parser error : Text of a unit larger than 4 GB\n";
+        exit(1);
+    }
+    tree.text.append(text);
+
+    return static_cast<std::uint32_t>(offset);
+}
+
+// start Document Handler
+void UnitTreeBuilder::handleStartDocument() {
+    depth = 0;
+    building = false;
+}
+
+// XML Declaration Handler
+void UnitTreeBuilder::handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) {}
+
+// Start Tag Handler
+void UnitTreeBuilder::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+
+    ++depth;
+    const auto name = names.intern(qName);
+
+    // the tree starts at the root, and starts over at a unit in the root, i.e., of an archive
+    if (depth == 1 || (depth == 2 && name == unitName)) {
+        tree.nodes.clear();
+        tree.text.clear();
+        open.clear();
+        tree.nodes.push_back(UnitNode{ UnitNodeKind::ELEMENT, name, UnitTree::NONE, UnitTree::NONE, UnitTree::NONE, 0, 0 });
+        open.push_back(OpenElement{ 0, UnitTree::NONE });
+        building = true;
+        return;
+    }
+    if (!building)
+        return;
+
+    const auto node = addNode(UnitNodeKind::ELEMENT, name);
+    open.push_back(OpenElement{ node, UnitTree::NONE });
+}
+
+// End Tag Handler
+void UnitTreeBuilder::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+
+    --depth;
+    if (!building)
+        return;
+
+    open.pop_back();
+    if (open.empty()) {
+        ++unitCount;
+        handleUnit(tree);
+        building = false;
+    }
+}
+
+// Character Handler
+// Adjacent characters, e.g., with an entity reference, are one text node
+void UnitTreeBuilder::handleCharacter(std::string_view characters) {
+
+    if (!building)
+        return;
+
+    const auto last = open.back().lastChild;
+    if (last != UnitTree::NONE && tree.nodes[last].kind == UnitNodeKind::TEXT) {
+        appendText(characters);
+        tree.nodes[last].textSize += static_cast<std::uint32_t>(characters.size());
+        return;
+    }
+
+    const auto offset = appendText(characters);
+    const auto node = addNode(UnitNodeKind::TEXT, NameTable::NONE);
+    tree.nodes[node].textOffset = offset;
+    tree.nodes[node].textSize = static_cast<std::uint32_t>(characters.size());
+}
+
+// attribute Handler
+void UnitTreeBuilder::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+
+    if (!building)
+        return;
+
+    const auto offset = appendText(value);
+    const auto node = addNode(UnitNodeKind::ATTRIBUTE, names.intern(qName));
+    tree.nodes[node].textOffset = offset;
+    tree.nodes[node].textSize = static_cast<std::uint32_t>(value.size());
+}
+
+// XML Namespace Handler
+void UnitTreeBuilder::handleXMLNamespace(std::string_view prefix, std::string_view uri) {}
+
+// XML Comment Handler
+void UnitTreeBuilder::handleXMLComment(std::string_view value) {}
+
+// CDATA Handler
+void UnitTreeBuilder::handleCDATA(std::string_view characters) {
+    handleCharacter(characters);
+}
+
+// processing Instruction Handler
+void UnitTreeBuilder::handleProcessingInstruction(std::string_view target, std::string_view data) {}
+
+// end Document Handler
+void UnitTreeBuilder::handleEndDocument() {}
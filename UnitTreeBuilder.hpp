@@ -0,0 +1,103 @@
+/*
+    UnitTreeBuilder.hpp
+
+    Handler that builds the tree of each srcML unit (see UnitTree.hpp), and
+    passes it to handleUnit() of an analysis that inherits from it.
+
+    For a srcML archive, the tree is of each unit in the root unit, and the
+    root unit itself is not built. For a single unit, the tree is of the root
+    unit. Only the tree of one unit is in memory, and its arrays are reused for
+    the next unit, so a parse of an archive does not allocate after the largest
+    unit. Element and attribute names are numbers in the name table of the
+    builder, the same for all units.
+*/
+
+#ifndef UNITTREEBUILDER_HPP
+#define UNITTREEBUILDER_HPP
+
+#include "XMLParserHandler.hpp"
+#include "NameTable.hpp"
+#include "UnitTree.hpp"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+class UnitTreeBuilder : public XMLParserHandler {
+public:
+    // constructor
+    UnitTreeBuilder();
+
+    // get the names of the trees, e.g., to number the names of an analysis
+    NameTable& getNames();
+
+    // get the number of units
+    long getUnitCount();
+
+protected:
+    // handle the tree of a unit, valid until the handler returns
+    virtual void handleUnit(const UnitTree& tree) = 0;
+
+    // start Document Handler
+    void handleStartDocument() override;
+
+    // XML Declaration Handler
+    void handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) override;
+
+    // Start Tag Handler
+    void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // End Tag Handler
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // Character Handler
+    void handleCharacter(std::string_view characters) override;
+
+    // attribute Handler
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+
+    // XML Namespace Handler
+    void handleXMLNamespace(std::string_view prefix, std::string_view uri) override;
+
+    // XML Comment Handler
+    void handleXMLComment(std::string_view value) override;
+
+    // CDATA Handler
+    void handleCDATA(std::string_view characters) override;
+
+    // processing Instruction Handler
+    void handleProcessingInstruction(std::string_view target, std::string_view data) override;
+
+    // end Document Handler
+    void handleEndDocument() override;
+
+private:
+    // element of the tree with its end tag still to come, and its last child so far
+    struct OpenElement {
+        std::uint32_t node;
+        std::uint32_t lastChild;
+    };
+
+    // add the node as the last child of the innermost open element
+    std::uint32_t addNode(UnitNodeKind kind, std::uint32_t name);
+
+    // append to the text of the tree
+    std::uint32_t appendText(std::string_view text);
+
+    // data members
+    NameTable names;
+    UnitTree tree;
+
+    std::vector<OpenElement> open;
+
+    // depth of the element in the document, with the root at 1
+    int depth;
+
+    // whether the events are of the tree of a unit
+    bool building;
+
+    long unitCount;
+
+    std::uint32_t unitName;
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*
+    XMLCursor.cpp
+
+    Implementation file for the pull XML cursor.
+*/
+
+#include "XMLCursor.hpp"
+#include <iostream>
+#include <algorithm>
+#include <functional>
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#define READ read
+#else
+#include <BaseTsd.h>
+#include <io.h>
+typedef SSIZE_T ssize_t;
+#define READ _read
+#define STDIN_FILENO 0
+#endif
+
+namespace {
+
+    // size of a chunk pushed to the parser, so the events of a chunk stay in cache
+    const std::size_t CHUNK_SIZE = 16 * 1024;
+}
+
+// constructor
+template <class Policy>
+BasicXMLCursor<Policy>::BasicXMLCursor(std::string_view content)
+    : content(content), inMemory(!content.empty()), pushed(0), buffer(inMemory ? 0 : CHUNK_SIZE),
+      stable(content), nextEvent(0), finished(false), queue(*this), parser(queue) {}
+
+// first event of the next chunk with events, or no event after the end of the document
+template <class Policy>
+std::optional<XMLEvent> BasicXMLCursor<Policy>::nextChunk() {
+
+    // the events of the previous chunk are all returned, so their strings are no longer needed
+    while (nextEvent == events.size()) {
+        if (finished)
+            return std::nullopt;
+        events.clear();
+        nextEvent = 0;
+        copies.clear();
+        pushChunk();
+    }
+
+    return events[nextEvent++];
+}
+
+// get totalBytes
+template <class Policy>
+long BasicXMLCursor<Policy>::getTotalBytes() {
+    return parser.getTotalBytes();
+}
+
+// get the encoding of the XML declaration
+template <class Policy>
+std::optional<std::string_view> BasicXMLCursor<Policy>::getEncoding() {
+    if (!encoding)
+        return std::nullopt;
+    return *encoding;
+}
+
+// get the standalone of the XML declaration
+template <class Policy>
+std::optional<std::string_view> BasicXMLCursor<Policy>::getStandalone() {
+    if (!standalone)
+        return std::nullopt;
+    return *standalone;
+}
+
+// validate that the content is UTF-8 as it is read
+template <class Policy>
+void BasicXMLCursor<Policy>::setValidateUTF8(bool validate) {
+    parser.setValidateUTF8(validate);
+}
+
+// check that the document is well-formed, i.e., that end tags match start tags
+// and that attributes are unique
+template <class Policy>
+void BasicXMLCursor<Policy>::setCheckWellFormed(bool check) {
+    parser.setCheckWellFormed(check);
+}
+
+// push the next chunk of the input to the parser, or finish the parse at the end of the input
+template <class Policy>
+void BasicXMLCursor<Policy>::pushChunk() {
+
+    if (inMemory) {
+        if (pushed == content.size()) {
+            parser.finish();
+            finished = true;
+            return;
+        }
+        const auto size = std::min(CHUNK_SIZE, content.size() - pushed);
+        parser.feed(content.substr(pushed, size));
+        pushed += size;
+        return;
+    }
+
+    const auto bytesRead = READ(STDIN_FILENO, buffer.data(), buffer.size());
+    if (bytesRead < 0) {
+        std::cerr << "parser error : File input error\n";
+        exit(1);
+    }
+    if (bytesRead == 0) {
+        parser.finish();
+        finished = true;
+        return;
+    }
+    stable = std::string_view(buffer.data(), static_cast<std::size_t>(bytesRead));
+    parser.feed(stable);
+}
+
+// the string, or a copy when it is not in the input that stays until the queue is empty
+template <class Policy>
+std::string_view BasicXMLCursor<Policy>::keep(std::string_view s) {
+
+    // unrelated pointers are compared with std::less, which is a total order
+    const std::less<const char*> before;
+    if (!before(s.data(), stable.data()) && !before(stable.data() + stable.size(), s.data() + s.size()))
+        return s;
+
+    return copies.store(s);
+}
+
+// constructor
+template <class Policy>
+BasicXMLCursor<Policy>::EventQueue::EventQueue(BasicXMLCursor& cursor) : cursor(cursor) {}
+
+// start Document Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleStartDocument() {
+    cursor.events.push_back(XMLEvent{ XMLEventKind::START_DOCUMENT, {}, {}, {}, {} });
+}
+
+// XML Declaration Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) {
+    if (encoding)
+        cursor.encoding = std::string(*encoding);
+    if (standalone)
+        cursor.standalone = std::string(*standalone);
+    cursor.events.push_back(XMLEvent{ XMLEventKind::XML_DECLARATION, {}, {}, {}, cursor.keep(version) });
+}
+
+// start Tag Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+    qName = cursor.keep(qName);
+    cursor.events.push_back(XMLEvent{ XMLEventKind::START_TAG, qName, qName.substr(0, prefix.size()),
+                                      qName.substr(qName.size() - localName.size()), {} });
+}
+
+// end Tag Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+    qName = cursor.keep(qName);
+    cursor.events.push_back(XMLEvent{ XMLEventKind::END_TAG, qName, qName.substr(0, prefix.size()),
+                                      qName.substr(qName.size() - localName.size()), {} });
+}
+
+// character Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleCharacter(std::string_view characters) {
+    cursor.events.push_back(XMLEvent{ XMLEventKind::CHARACTERS, {}, {}, {}, cursor.keep(characters) });
+}
+
+// attribute Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+    qName = cursor.keep(qName);
+    cursor.events.push_back(XMLEvent{ XMLEventKind::ATTRIBUTE, qName, qName.substr(0, prefix.size()),
+                                      qName.substr(qName.size() - localName.size()), cursor.keep(value) });
+}
+
+// XML Namespace Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleXMLNamespace(std::string_view prefix, std::string_view uri) {
+    cursor.events.push_back(XMLEvent{ XMLEventKind::XML_NAMESPACE, {}, cursor.keep(prefix), {}, cursor.keep(uri) });
+}
+
+// XML Comment Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleXMLComment(std::string_view value) {
+    cursor.events.push_back(XMLEvent{ XMLEventKind::XML_COMMENT, {}, {}, {}, cursor.keep(value) });
+}
+
+// CDATA Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleCDATA(std::string_view characters) {
+    cursor.events.push_back(XMLEvent{ XMLEventKind::CDATA, {}, {}, {}, cursor.keep(characters) });
+}
+
+// processing Instruction Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleProcessingInstruction(std::string_view target, std::string_view data) {
+    cursor.events.push_back(XMLEvent{ XMLEventKind::PROCESSING_INSTRUCTION, cursor.keep(target), {}, {}, cursor.keep(data) });
+}
+
+// end Document Handler
+template <class Policy>
+void BasicXMLCursor<Policy>::EventQueue::handleEndDocument() {
+    cursor.events.push_back(XMLEvent{ XMLEventKind::END_DOCUMENT, {}, {}, {}, {} });
+}
+
+// cursor with all features
+template class BasicXMLCursor<FullParserPolicy>;
+
+// cursor with only the features needed for srcFacts
+template class BasicXMLCursor<FactsParserPolicy>;
@@ -0,0 +1,166 @@
+/*
+    XMLCursor.hpp
+
+    Header file for the pull XML cursor.
+
+    Instead of a handler with callbacks, the consumer calls next() for each
+    event, so an analysis is a loop over the events with its state in local
+    variables:
+
+        FactsXMLCursor cursor(content);
+        while (const auto event = cursor.next()) {
+            if (event->kind == XMLEventKind::START_TAG && event->localName == "function"sv)
+                ++functionCount;
+        }
+
+    The cursor pushes the input to a push parser (see PushXMLParser.hpp) a
+    chunk at a time, and queues the events of the chunk. The strings of an
+    event are views of the input, and are valid until the next call of next().
+*/
+
+#ifndef XMLCURSOR_HPP
+#define XMLCURSOR_HPP
+
+#include "PushXMLParser.hpp"
+#include "XMLParserHandler.hpp"
+#include "StringPool.hpp"
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+
+// kind of an event, with a handler in XMLParserHandler for each
+enum class XMLEventKind : unsigned char {
+    START_DOCUMENT,
+    XML_DECLARATION,
+    START_TAG,
+    END_TAG,
+    CHARACTERS,
+    ATTRIBUTE,
+    XML_NAMESPACE,
+    XML_COMMENT,
+    CDATA,
+    PROCESSING_INSTRUCTION,
+    END_DOCUMENT,
+};
+
+// event of the parse, with the arguments of its handler
+struct XMLEvent {
+    XMLEventKind kind;
+
+    // name of a tag or attribute, target of a processing instruction
+    std::string_view qName;
+    std::string_view prefix;
+    std::string_view localName;
+
+    // characters, CDATA, comment, attribute value, namespace uri, processing
+    // instruction data, or XML declaration version, with the encoding and
+    // standalone of the declaration from the cursor
+    std::string_view value;
+};
+
+template <class Policy>
+class BasicXMLCursor {
+public:
+    // constructor
+    // Empty content is read from standard input. Otherwise, the content is the
+    // complete document in memory
+    BasicXMLCursor(std::string_view content);
+
+    // next event of the parse, or no event after the end of the document
+    // The events of a chunk are returned inline, without a call
+    std::optional<XMLEvent> next() {
+        if (nextEvent < events.size())
+            return events[nextEvent++];
+        return nextChunk();
+    }
+
+    // get totalBytes
+    long getTotalBytes();
+
+    // get the encoding of the XML declaration
+    std::optional<std::string_view> getEncoding();
+
+    // get the standalone of the XML declaration
+    std::optional<std::string_view> getStandalone();
+
+    // validate that the content is UTF-8 as it is read
+    void setValidateUTF8(bool validate);
+
+    // check that the document is well-formed, i.e., that end tags match start tags
+    // and that attributes are unique
+    void setCheckWellFormed(bool check);
+
+private:
+    // handler that queues the events of the parser
+    class EventQueue : public XMLParserHandler {
+    public:
+        // constructor
+        EventQueue(BasicXMLCursor& cursor);
+
+        // handlers, each queues its event
+        void handleStartDocument() override;
+        void handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) override;
+        void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+        void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+        void handleCharacter(std::string_view characters) override;
+        void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+        void handleXMLNamespace(std::string_view prefix, std::string_view uri) override;
+        void handleXMLComment(std::string_view value) override;
+        void handleCDATA(std::string_view characters) override;
+        void handleProcessingInstruction(std::string_view target, std::string_view data) override;
+        void handleEndDocument() override;
+
+    private:
+        BasicXMLCursor& cursor;
+    };
+
+    // first event of the next chunk with events, or no event after the end of the document
+    std::optional<XMLEvent> nextChunk();
+
+    // push the next chunk of the input to the parser, or finish the parse at the end of the input
+    void pushChunk();
+
+    // the string, or a copy when it is not in the input that stays until the queue is empty
+    std::string_view keep(std::string_view s);
+
+    // data members
+    std::string_view content;
+
+    bool inMemory;
+
+    // bytes of the in-memory content pushed so far
+    std::size_t pushed;
+
+    // chunk read from standard input
+    std::vector<char> buffer;
+
+    // input that the strings of the queued events may view
+    std::string_view stable;
+
+    // queued events, and the next one to return
+    std::vector<XMLEvent> events;
+    std::size_t nextEvent;
+
+    // copies of the strings of queued events that are not in the input, e.g.,
+    // of a token split between chunks
+    StringPool copies;
+
+    bool finished;
+
+    // XML declaration
+    std::optional<std::string> encoding;
+    std::optional<std::string> standalone;
+
+    EventQueue queue;
+
+    BasicPushXMLParser<Policy> parser;
+};
+
+// XML cursor with all features
+using XMLCursor = BasicXMLCursor<FullParserPolicy>;
+
+// XML cursor with only the features needed for srcFacts
+using FactsXMLCursor = BasicXMLCursor<FactsParserPolicy>;
+
+#endif
@@ -0,0 +1,120 @@
+/*
+    XMLEventGenerator.hpp
+
+    C++20 generator of the events of an XML cursor (see XMLCursor.hpp), so the
+    stages of an analysis are coroutines that compose as a pipeline, e.g., a
+    stage that filters the events of another stage:
+
+        Generator<const XMLEvent&> startTags(Generator<const XMLEvent&> events) {
+            for (const auto& event : events)
+                if (event.kind == XMLEventKind::START_TAG)
+                    co_yield event;
+        }
+
+        for (const auto& event : startTags(xmlEvents(cursor)))
+            ...
+
+    A stage is resumed for each event it yields, and no event is copied between
+    the stages. Requires C++20 coroutines.
+*/
+
+#ifndef XMLEVENTGENERATOR_HPP
+#define XMLEVENTGENERATOR_HPP
+
+#include "XMLCursor.hpp"
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// generator of references to the values yielded by a coroutine, as an input range
+template <class Reference>
+class Generator {
+public:
+    using Value = std::remove_cvref_t<Reference>;
+
+    // state of the coroutine, with the address of the value it yielded
+    struct promise_type {
+        const Value* current = nullptr;
+
+        Generator get_return_object() {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // the value lives in the coroutine until it is resumed
+        std::suspend_always yield_value(const Value& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() { throw; }
+    };
+
+    // iterator that resumes the coroutine on increment
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Value;
+
+        iterator() = default;
+
+        explicit iterator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+        const Value& operator*() const { return *coroutine.promise().current; }
+
+        iterator& operator++() {
+            coroutine.resume();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return !coroutine || coroutine.done(); }
+
+    private:
+        std::coroutine_handle<promise_type> coroutine;
+    };
+
+    // constructor
+    explicit Generator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+    Generator(Generator&& other) noexcept : coroutine(std::exchange(other.coroutine, {})) {}
+
+    Generator(const Generator&) = delete;
+
+    Generator& operator=(const Generator&) = delete;
+
+    // destructor
+    ~Generator() {
+        if (coroutine)
+            coroutine.destroy();
+    }
+
+    // start the coroutine, up to its first value
+    iterator begin() {
+        coroutine.resume();
+        return iterator(coroutine);
+    }
+
+    std::default_sentinel_t end() { return std::default_sentinel; }
+
+private:
+    std::coroutine_handle<promise_type> coroutine;
+};
+
+// events of the cursor, to the end of the document
+template <class Cursor>
+Generator<const XMLEvent&> xmlEvents(Cursor& cursor) {
+    while (const auto event = cursor.next())
+        co_yield *event;
+}
+
+#endif
@@ -7,69 +7,232 @@
 #include "XMLParser.hpp"
 #include "refillContent.hpp"
 #include "XMLParserHandler.hpp"
-#include <bitset>
+#include "xml_parser.hpp"
 #include <cassert>
 #include <iostream>
-#include <iomanip>
-
-// trace parsing
-#ifdef TRACE
-#undef TRACE
-#define HEADER(m) std::clog << "\033[1m" << std::setw(10) << std::left << m << "\u001b[0m" << '\t'
-#define TRACE0() ""
-#define TRACE1(l1, n1)                         "\033[1m" << l1 << "\u001b[0m" << "|" << "\u001b[31;1m" << n1 << "\u001b[0m" << "| "
-#define TRACE2(l1, n1, l2, n2)                 TRACE1(l1,n1)             << TRACE1(l2,n2)
-#define TRACE3(l1, n1, l2, n2, l3, n3)         TRACE2(l1,n1,l2,n2)       << TRACE1(l3,n3)
-#define TRACE4(l1, n1, l2, n2, l3, n3, l4, n4) TRACE3(l1,n1,l2,n2,l3,n3) << TRACE1(l4,n4)
-#define GET_TRACE(_2,_3,_4,_5,_6,_7,_8,_9,NAME,...) NAME
-#define TRACE(m,...) HEADER(m) << GET_TRACE(__VA_ARGS__, TRACE4, _UNUSED, TRACE3, _UNUSED, TRACE2, _UNUSED, TRACE1, TRACE0, TRACE0)(__VA_ARGS__) << '\n';
+#include <algorithm>
+
+// profile parsing, with the events and refills recorded when the parser has a profile
+// The mark of the start of an event is only for a profile when enabled, e.g., at compile time
+#ifdef PROFILE
+#define PROFILE_START() if (profile) profile->startParse()
+#define PROFILE_END() if (profile) profile->endParse()
+#define PROFILE_MARK(mark, enabled) [[maybe_unused]] const auto mark = (enabled) && profile ? ProfileMark{ profile, getOffset(), ParseProfile::ticks() } : ProfileMark{ nullptr, 0, 0 }
+#define PROFILE_EVENT(event, mark) if (mark.profile) mark.profile->record(ParseProfile::event, getOffset() - mark.offset, ParseProfile::ticks() - mark.ticks)
+#define PROFILE_REFILL(bytesRead, bytesMoved, mark) if (mark.profile) mark.profile->recordRefill(bytesRead, bytesMoved, ParseProfile::ticks() - mark.ticks)
 #else
-#define TRACE(...)
+#define PROFILE_START()
+#define PROFILE_END()
+#define PROFILE_MARK(mark, enabled)
+#define PROFILE_EVENT(event, mark)
+#define PROFILE_REFILL(bytesRead, bytesMoved, mark)
 #endif
 
 // provides literal string operator""sv
 using namespace std::literals::string_view_literals;
 
-constexpr auto WHITESPACE = " \n\t\r"sv;
-constexpr auto NAMEEND = "> /\":=\n\t\r"sv;
+using namespace xml_parser;
+
 const int BLOCK_SIZE = 4096;
-const std::bitset<128> xmlNameMask("00000111111111111111111111111110100001111111111111111111111111100000001111111111011000000000000000000000000000000000000000000000");
 
 
 // constructor
-XMLParser::XMLParser(std::string_view content, XMLParserHandler& handler)
-    : content(content), totalBytes(0), handler(handler)
+template <class Policy>
+BasicXMLParser<Policy>::BasicXMLParser(std::string_view content, XMLParserHandler& handler)
+    : content(content), totalBytes(0), baseOffset(0), inMemory(!content.empty()), validateUTF8(false), checkWellFormed(false), multipleDocuments(false), attributeCount(0),
+      fragmentDepth(0), fragmentMinDepth(0), profile(nullptr), handler(handler)
     {}
 
+
 // parse XML
-void XMLParser::parse() {
+template <class Policy>
+void BasicXMLParser<Policy>::parse() {
 
     // parse file from the start
     parseBegin();
     handler.handleStartDocument();
+    bool doneReading = false;
+    parseProlog(doneReading);
+
+    while (true) {
+
+        // parse the root element
+        if (ParseProfile::compiledIn && profile)
+            parseElements<true>(doneReading, false);
+        else
+            parseElements<false>(doneReading, false);
+
+        if (checkWellFormed && !openElements.empty()) {
+            std::cerr << "parser error : Unclosed start tag at byte offset " << openElements.back().offset << '\n';
+            exit(1);
+        }
+
+        parseEpilog(doneReading);
+        if (content.empty())
+            break;
+
+        // next document of the stream, with the same buffer
+        handler.handleEndDocument();
+        handler.handleStartDocument();
+        if (!doneReading && content.size() < BLOCK_SIZE)
+            refillPreserve(doneReading);
+        parseProlog(doneReading);
+    }
+    handler.handleInputEnd(content);
+    PROFILE_END();
+    handler.handleEndDocument();
+}
+
+// parse the XML declaration and DOCTYPE at the front of the document
+template <class Policy>
+void BasicXMLParser<Policy>::parseProlog(bool& doneReading) {
 
     std::string_view version;
     std::optional<std::string_view> encoding;
     std::optional<std::string_view> standalone;
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    if (isXML()) {
+    skipWhitespace(content);
+    if (isXML(content)) {
         // parse XML Declaration
-        parseXMLDeclaration(version, encoding, standalone);
+        PROFILE_MARK(declarationMark, true);
+        parseXMLDeclaration(content, version, encoding, standalone);
+        PROFILE_EVENT(XML_DECLARATION, declarationMark);
         handler.handleXMLDeclaration(version, encoding, standalone);
     }
-    if (isDOCTYPE()) {
+    if (isDOCTYPE(content)) {
         // parse DOCTYPE
-        parseDOCTYPE();
+        refillToken(doneReading, findDOCTYPEEnd);
+        PROFILE_MARK(doctypeMark, true);
+        [[maybe_unused]] const auto contents = parseDOCTYPE(content);
+        PROFILE_EVENT(DOCTYPE, doctypeMark);
+    }
+}
+
+// parse the comments after the root element, with nothing else after them,
+// or in a stream of documents, up to the next document
+template <class Policy>
+void BasicXMLParser<Policy>::parseEpilog(bool& doneReading) {
+
+    skipEpilogWhitespace(doneReading);
+    while (isComment(content)) {
+        // parse XML comment
+        PROFILE_MARK(commentMark, true);
+        const auto value = parseComment(doneReading);
+        PROFILE_EVENT(COMMENT, commentMark);
+        if constexpr (Policy::comments)
+            handler.handleXMLComment(value);
+        skipEpilogWhitespace(doneReading);
+    }
+    if (content.size() != 0 && (!multipleDocuments || content[0] != '<' || content[1] == '/')) {
+        std::cerr << "parser error : extra content at end of document\n";
+        exit(1);
     }
+}
+
+// skip whitespace, in a stream of documents reading until there is content
+// to decide what follows, or the end of the input
+template <class Policy>
+void BasicXMLParser<Policy>::skipEpilogWhitespace(bool& doneReading) {
+
+    skipWhitespace(content);
+    while (multipleDocuments && !doneReading && content.size() < "<!--"sv.size()) {
+        refillPreserve(doneReading);
+        skipWhitespace(content);
+    }
+}
+
+// parse a part of a pushed document, from the input offset, that ends at a token boundary
+// The first part starts with the prolog, and a part ends at or before the end of the root element
+template <class Policy>
+void BasicXMLParser<Policy>::parsePushedElements(std::string_view part, long offset, bool first) {
+
+    content = part;
+    totalBytes = offset + static_cast<long>(part.size());
+    bool doneReading = true;
+    if (first) {
+        PROFILE_START();
+        handler.handleStartDocument();
+        parseProlog(doneReading);
+    }
+    if (ParseProfile::compiledIn && profile)
+        parseElements<true>(doneReading, true);
+    else
+        parseElements<false>(doneReading, true);
+}
+
+// parse a part of a pushed document after the root element, from the input offset
+template <class Policy>
+void BasicXMLParser<Policy>::parsePushedEpilog(std::string_view part, long offset) {
+
+    content = part;
+    totalBytes = offset + static_cast<long>(part.size());
+    bool doneReading = true;
+    parseEpilog(doneReading);
+}
+
+// validate the UTF-8 of a chunk of a pushed document, or the end of the document when empty
+template <class Policy>
+void BasicXMLParser<Policy>::validatePushed(std::string_view chunk) {
+
+    content = chunk;
+    validateRead(static_cast<long>(chunk.size()));
+}
+
+// end of a pushed document
+template <class Policy>
+void BasicXMLParser<Policy>::finishPushed() {
+
+    if (checkWellFormed && !openElements.empty()) {
+        std::cerr << "parser error : Unclosed start tag at byte offset " << openElements.back().offset << '\n';
+        exit(1);
+    }
+    PROFILE_END();
+    handler.handleEndDocument();
+}
+
+// parse a fragment of the content of the root element, e.g., part of a large unit
+// The fragment starts and ends at markup boundaries. There is no XML declaration
+// and no start or end of the document, and the depth is relative to the start
+template <class Policy>
+void BasicXMLParser<Policy>::parseFragment() {
+
+    parseBegin();
+    bool doneReading = true;
+    if (ParseProfile::compiledIn && profile)
+        parseElements<true>(doneReading, true);
+    else
+        parseElements<false>(doneReading, true);
+    handler.handleInputEnd(content);
+    PROFILE_END();
+}
+
+// get the depth at the end of the fragment, relative to its start
+template <class Policy>
+int BasicXMLParser<Policy>::getFragmentDepth() {
+    return fragmentDepth;
+}
+
+// get the lowest depth after an end tag in the fragment, relative to its start
+template <class Policy>
+int BasicXMLParser<Policy>::getFragmentMinDepth() {
+    return fragmentMinDepth;
+}
+
+// parse elements and their content until the end of the root element
+// In a fragment, the parse continues to the end of the content. Without
+// profiling, the loop has no checks for a profile
+template <class Policy>
+template <bool profiling>
+void BasicXMLParser<Policy>::parseElements(bool& doneReading, bool fragment) {
 
     int depth = 0;
-    bool doneReading = false;
+    int minDepth = 0;
+    bool inRoot = true;
     std::string_view qName;
     std::string_view prefix;
     std::string_view localName;
     std::string_view value;
     std::string_view characters;
-    while (true) {
+    while (inRoot) {
         if (doneReading) {
             if (content.size() == 0)
                 break;
@@ -77,283 +240,271 @@ void XMLParser::parse() {
             // refill content preserving unprocessed
             refillPreserve(doneReading);
         }
-        if (isCharacter(0, '&')) {
+        PROFILE_MARK(eventMark, profiling);
+        // dispatch on the first two characters of the token
+        switch (tokenKind(content)) {
+        case Token::ENTITY_REFERENCE:
             // parse character entity references
-            characters = parseCharacterEntityReference();
+            characters = parseCharacterEntityReference(content);
+            PROFILE_EVENT(ENTITY_REFERENCE, eventMark);
             handler.handleCharacter(characters);
-        } else if (!isCharacter(0 ,'<')) {
+            break;
+        case Token::CHARACTERS:
             // parse character non-entity references
-            characters = parseCharacterNotEntityReference();
+            characters = parseCharacterNotEntityReference(content);
+            PROFILE_EVENT(CHARACTERS, eventMark);
             handler.handleCharacter(characters);
-        } else if (isComment()) {
-            // parse XML comment
-            value = parseComment(doneReading);
-            content.remove_prefix("-->"sv.size());
-            handler.handleXMLComment(value);
-        } else if (isCDATA()) {
-            // parse CDATA
-            parseCDATA(doneReading, characters);
-            handler.handleCDATA(characters);
-        } else if (isCharacter(1, '?') /* && isCharacter(0, '<') */) {
-            // parse processing instruction
-            auto result = parseProcessing();
-            auto target = result.first;
-            auto data = result.second;
-            handler.handleProcessingInstruction(target, data);
-        } else if (isCharacter(1, '/') /* && isCharacter(0, '<') */) {
-            // parse end tag
-            parseEndTag(qName, prefix, localName);
-            handler.handleEndTag(qName, prefix, localName);
+            break;
+        case Token::DECLARATION:
+            if (isComment(content)) {
+                // parse XML comment
+                value = parseComment(doneReading);
+                PROFILE_EVENT(COMMENT, eventMark);
+                if constexpr (Policy::comments)
+                    handler.handleXMLComment(value);
+            } else if (isCDATA(content)) {
+                // parse CDATA
+                characters = parseCDATA(doneReading);
+                PROFILE_EVENT(CDATA, eventMark);
+                handler.handleCDATA(characters);
+            } else {
+                std::cerr << "parser error : invalid XML document\n";
+                exit(1);
+            }
+            break;
+        case Token::PROCESSING_INSTRUCTION:
+            refillToken(doneReading, findProcessingEnd);
+            if constexpr (Policy::processingInstructions) {
+                // parse processing instruction
+                const auto [target, data] = parseProcessing(content);
+                PROFILE_EVENT(PROCESSING_INSTRUCTION, eventMark);
+                handler.handleProcessingInstruction(target, data);
+            } else {
+                skipProcessing(content);
+                PROFILE_EVENT(PROCESSING_INSTRUCTION, eventMark);
+            }
+            break;
+        case Token::END_TAG:
+            if (Policy::endTags || checkWellFormed) {
+                // parse end tag
+                const auto offset = getOffset();
+                parseEndTag<Policy::qualifiedNames>(content, qName, prefix, localName);
+                if (checkWellFormed)
+                    checkEndTag(qName, offset);
+                PROFILE_EVENT(END_TAG, eventMark);
+                if constexpr (Policy::endTags)
+                    handler.handleEndTag(qName, prefix, localName);
+            } else {
+                skipEndTag(content);
+                PROFILE_EVENT(END_TAG, eventMark);
+            }
             --depth;
-            if (depth == 0)
-                break;
-        } else if (isCharacter(0, '<')) {
+            if (depth == 0 && !fragment)
+                inRoot = false;
+            if (depth < minDepth)
+                minDepth = depth;
+            break;
+        case Token::START_TAG: {
             // parse start tag
-            parseStartTag(qName, prefix, localName);
+            const auto offset = getOffset();
+            const auto tag = content;
+            parseStartTag<Policy::qualifiedNames>(content, qName, prefix, localName);
+            if (content[0] != '>' && !doneReading && findStartTagEnd(tag) == tag.npos) {
+                // parse again with all of the attributes in the content, for a start tag larger than the rest of the content
+                content = tag;
+                refillToken(doneReading, findStartTagEnd);
+                parseStartTag<Policy::qualifiedNames>(content, qName, prefix, localName);
+            }
+            PROFILE_EVENT(START_TAG, eventMark);
             handler.handleStartTag(qName, prefix, localName);
-
-            content.remove_prefix(content.find_first_not_of(WHITESPACE));
-            while (xmlNameMask[content[0]]) {
-                if (isNamespace()) {
+            const auto elementQName = qName;
+            const auto elementPrefix = prefix;
+            const auto elementLocalName = localName;
+            const auto element = checkWellFormed ? OpenElement{ hashName(qName), qName.size(), offset } : OpenElement{};
+            attributeCount = 0;
+
+            skipWhitespace(content);
+            while (isClass(content[0], NAME_CHARACTER)) {
+                const auto attributeOffset = checkWellFormed ? getOffset() : 0;
+                PROFILE_MARK(attributeMark, profiling);
+                if (Policy::namespaces && isNamespace(content)) {
                     // parse XML namespace
-                    auto result = parseNamespace();
-                    auto prefix = result.first;
-                    auto uri = result.second;
+                    const auto [prefix, uri] = parseNamespace(content);
+                    if (checkWellFormed) {
+                        // the prefix directly follows "xmlns:" in the content
+                        checkAttribute(prefix.empty() ? "xmlns"sv : std::string_view(prefix.data() - "xmlns:"sv.size(), prefix.size() + "xmlns:"sv.size()), attributeOffset);
+                    }
+                    PROFILE_EVENT(NAMESPACE, attributeMark);
                     handler.handleXMLNamespace(prefix, uri);
                 } else {
                     // parse attribute
-                    value = parseAttribute(qName, prefix, localName);
-                    handler.handleAttribute(qName, prefix, localName, value);
-                    TRACE("ATTRIBUTE", "qName", qName, "prefix", prefix , "localName", localName, "value", value);
-                    // convert special srcML escaped element to characters
-                    if (localName == "escape"sv && localName == "char"sv /* && inUnit */) {
-                        // use strtol() instead of atoi() since strtol() understands hex encoding of '0x0?'
-                        [[maybe_unused]] const auto escapeValue = (char)strtol(value.data(), NULL, 0);
-                    }
+                    value = parseAttribute<Policy::qualifiedNames>(content, qName, prefix, localName);
+                    if (checkWellFormed)
+                        checkAttribute(qName, attributeOffset);
+                    PROFILE_EVENT(ATTRIBUTE, attributeMark);
+                    if (Policy::attribute(localName))
+                        handler.handleAttribute(qName, prefix, localName, value);
                     content.remove_prefix("\""sv.size());
-                    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+                    skipWhitespace(content);
                 }
             }
-            if (isCharacter(0, '>')) {
+            if (isCharacter(content, 0, '>')) {
                 content.remove_prefix(">"sv.size());
                 ++depth;
-            } else if (isCharacter(0, '/') && isCharacter(1, '>')) {
+                if (checkWellFormed)
+                    openElements.push_back(element);
+            } else if (isCharacter(content, 0, '/') && isCharacter(content, 1, '>')) {
                 assert(content.compare(0, "/>"sv.size(), "/>") == 0);
                 content.remove_prefix("/>"sv.size());
-                TRACE("END TAG", "qName", qName , "prefix", prefix , "localName", localName);
-                if (depth == 0)
-                    break;
+                if constexpr (Policy::endTags) {
+                    // an empty element ends at the end of the start tag
+                    handler.handleEndTag(elementQName, elementPrefix, elementLocalName);
+                }
+                if (depth == 0 && !fragment)
+                    inRoot = false;
+            } else if (checkWellFormed) {
+                std::cerr << "parser error : Unterminated start tag at byte offset " << offset << '\n';
+                exit(1);
             }
-        } else {
-            std::cerr << "parser error : invalid XML document\n";
-            exit(1);
+            break;
+        }
         }
     }
-
-    content.remove_prefix(content.find_first_not_of(WHITESPACE) == content.npos ? content.size() : content.find_first_not_of(WHITESPACE));
-    while (isComment()) {
-        // parse XML comment
-        value = parseComment(doneReading);
-        handler.handleXMLComment(value);
-    }
-    if (content.size() != 0) {
-        std::cerr << "parser error : extra content at end of document\n";
-        exit(1);
-    }
-    TRACE("END DOCUMENT");
-    handler.handleEndDocument();
+    fragmentDepth = depth;
+    fragmentMinDepth = minDepth;
 }
 
 // get totalBytes
-long XMLParser::getTotalBytes() {
+template <class Policy>
+long BasicXMLParser<Policy>::getTotalBytes() {
     return totalBytes;
 }
 
-// parse file from the start
-void XMLParser::parseBegin() {
-    TRACE("START DOCUMENT");
-    const int bytesRead = refillContent(content);
-    if (bytesRead < 0) {
-        std::cerr << "parser error : File input error\n";
-        exit(1);
-    }
-    if (bytesRead == 0) {
-        std::cerr << "parser error : Empty file\n";
-        exit(1);
-    }
-
-    totalBytes += bytesRead;
+// validate that the content is UTF-8 as it is read
+template <class Policy>
+void BasicXMLParser<Policy>::setValidateUTF8(bool validate) {
+    validateUTF8 = validate;
 }
 
-// parse XML declaration
-void XMLParser::parseXMLDeclaration(std::string_view& version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) {
-    content.remove_prefix("<?xml"sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+// check that the document is well-formed, i.e., that end tags match start tags
+// and that attributes are unique
+template <class Policy>
+void BasicXMLParser<Policy>::setCheckWellFormed(bool check) {
+    checkWellFormed = check;
+}
 
-    // parse required version
-    parseVersion(version);
+// record the events and refills of the parse in the profile
+// Recording requires profiling compiled in (see ParseProfile.hpp)
+template <class Policy>
+void BasicXMLParser<Policy>::setProfile(ParseProfile* profile) {
+    this->profile = profile;
+}
 
-    // parse optional encoding attribute
-    parseEncoding(encoding);
+// parse a stream of documents, one after the other, e.g., from a pipe
+// Each document has its own start and end of document, and XML declaration
+template <class Policy>
+void BasicXMLParser<Policy>::setMultipleDocuments(bool multiple) {
+    multipleDocuments = multiple;
+}
 
-    // parse optional standalone attribute
-    parseStandalone(standalone);
+// offset in the document of the start of the content, e.g., of a unit parsed
+// separately, so the byte offsets of the errors are in the document
+template <class Policy>
+void BasicXMLParser<Policy>::setBaseOffset(long offset) {
+    baseOffset = offset;
+}
 
-    TRACE("XML DECLARATION", "version", version, "encoding", (encoding ? *encoding : ""), "standalone", (standalone ? *standalone : ""));
-    assert(content.compare(0, "?>"sv.size(), "?>"sv) == 0);
-    content.remove_prefix("?>"sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+// offset in the document of the front of the content
+template <class Policy>
+long BasicXMLParser<Policy>::getOffset() {
+    return baseOffset + totalBytes - static_cast<long>(content.size());
 }
 
-// parse required version
-void XMLParser::parseVersion(std::string_view& version) {
-    const auto nameEndPosition = content.find_first_of("= ");
-    const auto attr(content.substr(0, nameEndPosition));
-    content.remove_prefix(nameEndPosition);
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    content.remove_prefix("="sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    const auto delimiter = content[0];
-    if (delimiter != '"' && delimiter != '\'') {
-        std::cerr << "parser error: Invalid start delimiter for version in XML declaration\n";
+// check that the attribute name is unique in the start tag
+template <class Policy>
+void BasicXMLParser<Policy>::checkAttribute(std::string_view qName, long offset) {
+    const auto hash = hashName(qName);
+    const auto isDuplicate = [hash, qName](const auto& attribute) {
+        return attribute.first == hash && attribute.second == qName;
+    };
+    const auto tableCount = std::min(attributeCount, ATTRIBUTE_TABLE_SIZE);
+    if (std::any_of(attributeNames.begin(), attributeNames.begin() + tableCount, isDuplicate)
+        || (attributeCount > ATTRIBUTE_TABLE_SIZE && std::any_of(extraAttributeNames.begin(), extraAttributeNames.end(), isDuplicate))) {
+        std::cerr << "parser error : Duplicate attribute '" << qName << "' at byte offset " << offset << '\n';
         exit(1);
     }
-    content.remove_prefix("\""sv.size());
-    const auto valueEndPosition = content.find(delimiter);
-    if (valueEndPosition == content.npos) {
-        std::cerr << "parser error: Invalid end delimiter for version in XML declaration\n";
+    if (attributeCount < ATTRIBUTE_TABLE_SIZE) {
+        attributeNames[attributeCount] = std::pair(hash, qName);
+    } else {
+        if (attributeCount == ATTRIBUTE_TABLE_SIZE)
+            extraAttributeNames.clear();
+        extraAttributeNames.emplace_back(hash, qName);
+    }
+    ++attributeCount;
+}
+
+// check that the end tag matches the open start tag
+template <class Policy>
+void BasicXMLParser<Policy>::checkEndTag(std::string_view qName, long offset) {
+    if (openElements.empty()) {
+        std::cerr << "parser error : End tag '" << qName << "' without a start tag at byte offset " << offset << '\n';
         exit(1);
     }
-    if (attr != "version"sv) {
-        std::cerr << "parser error: Missing required first attribute version in XML declaration\n";
+    const auto& element = openElements.back();
+    if (element.length != qName.size() || element.hash != hashName(qName)) {
+        std::cerr << "parser error : End tag '" << qName << "' at byte offset " << offset
+                  << " does not match the start tag at byte offset " << element.offset << '\n';
         exit(1);
     }
-    version = (content.substr(0, valueEndPosition));
-    content.remove_prefix(valueEndPosition);
-    content.remove_prefix("\""sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    openElements.pop_back();
 }
 
-
-// parse optional encoding attribute
-void XMLParser::parseEncoding(std::optional<std::string_view>& encoding) {
-    if (content[0] != '?') {
-        const auto nameEndPosition = content.find_first_of("= ");
-        if (nameEndPosition == content.npos) {
-            std::cerr << "parser error: Incomplete attribute in XML declaration\n";
-            exit(1);
-        }
-        const auto attr2(content.substr(0, nameEndPosition));
-        content.remove_prefix(nameEndPosition);
-        content.remove_prefix(content.find_first_not_of(WHITESPACE));
-        assert(content.compare(0, "="sv.size(), "="sv) == 0);
-        content.remove_prefix("="sv.size());
-        content.remove_prefix(content.find_first_not_of(WHITESPACE));
-        const auto delimiter2 = content[0];
-        if (delimiter2 != '"' && delimiter2 != '\'') {
-            std::cerr << "parser error: Invalid end delimiter for attribute " << attr2 << " in XML declaration\n";
-            exit(1);
-        }
-        content.remove_prefix("\""sv.size());
-        const auto valueEndPosition = content.find(delimiter2);
-        if (valueEndPosition == content.npos) {
-            std::cerr << "parser error: Incomplete attribute " << attr2 << " in XML declaration\n";
-            exit(1);
-        }
-        if (attr2 == "encoding"sv) {
-            encoding = content.substr(0, valueEndPosition);
-        } else {
-            std::cerr << "parser error: Invalid attribute " << attr2 << " in XML declaration\n";
-            exit(1);
+// parse file from the start
+template <class Policy>
+void BasicXMLParser<Policy>::parseBegin() {
+    PROFILE_START();
+    if (inMemory) {
+        // the whole document is already in the content
+        totalBytes = static_cast<long>(content.size());
+        if (validateUTF8) {
+            validateRead(totalBytes);
+            validateRead(0);
         }
-        content.remove_prefix(valueEndPosition + 1);
-        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+        handler.handleInputStart(content);
+        return;
     }
-}
-
-// parse optional standalone attribute
-void XMLParser::parseStandalone(std::optional<std::string_view>& standalone) {
-    if (content[0] != '?') {
-        const auto nameEndPosition = content.find_first_of("= ");
-        if (nameEndPosition == content.npos) {
-            std::cerr << "parser error: Incomplete attribute in XML declaration\n";
-            exit(1);
-        }
-        const auto attr2(content.substr(0, nameEndPosition));
-        content.remove_prefix(nameEndPosition);
-        content.remove_prefix(content.find_first_not_of(WHITESPACE));
-        content.remove_prefix("="sv.size());
-        content.remove_prefix(content.find_first_not_of(WHITESPACE));
-        const auto delimiter2 = content[0];
-        if (delimiter2 != '"' && delimiter2 != '\'') {
-            std::cerr << "parser error: Invalid end delimiter for attribute " << attr2 << " in XML declaration\n";
-            exit(1);
-        }
-        content.remove_prefix("\""sv.size());
-        const auto valueEndPosition = content.find(delimiter2);
-        if (valueEndPosition == content.npos) {
-            std::cerr << "parser error: Incomplete attribute " << attr2 << " in XML declaration\n";
-            exit(1);
-        }
-        if (!standalone && attr2 == "standalone"sv) {
-            standalone = content.substr(0, valueEndPosition);
-        } else {
-            std::cerr << "parser error: Invalid attribute " << attr2 << " in XML declaration\n";
-            exit(1);
-        }
-        // assert(content[valueEndPosition + 1] == '"');
-        content.remove_prefix(valueEndPosition + 1);
-        content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    PROFILE_MARK(refillMark, true);
+    const int bytesRead = refillContent(content);
+    PROFILE_REFILL(bytesRead, 0, refillMark);
+    if (bytesRead < 0) {
+        std::cerr << "parser error : File input error\n";
+        exit(1);
     }
-}
-
-//parse DOCTYPE
-void XMLParser::parseDOCTYPE() {
-    assert(content.compare(0, "<!DOCTYPE "sv.size(), "<!DOCTYPE "sv) == 0);
-    content.remove_prefix("<!DOCTYPE"sv.size());
-    int depthAngleBrackets = 1;
-    bool inSingleQuote = false;
-    bool inDoubleQuote = false;
-    bool inComment = false;
-    std::size_t p = 0;
-    while ((p = content.find_first_of("<>'\"-"sv, p)) != content.npos) {
-        if (content.compare(p, "<!--"sv.size(), "<!--"sv) == 0) {
-            inComment = true;
-            p += "<!--"sv.size();
-            continue;
-        } else if (content.compare(p, "-->"sv.size(), "-->"sv) == 0) {
-            inComment = false;
-            p += "-->"sv.size();
-            continue;
-        }
-        if (inComment) {
-            ++p;
-            continue;
-        }
-        if (content[p] == '<' && !inSingleQuote && !inDoubleQuote) {
-            ++depthAngleBrackets;
-        } else if (content[p] == '>' && !inSingleQuote && !inDoubleQuote) {
-            --depthAngleBrackets;
-        } else if (content[p] == '\'') {
-            inSingleQuote = !inSingleQuote;
-        } else if (content[p] == '"') {
-            inDoubleQuote = !inDoubleQuote;
-        }
-        if (depthAngleBrackets == 0)
-            break;
-        ++p;
+    if (bytesRead == 0) {
+        std::cerr << "parser error : Empty file\n";
+        exit(1);
     }
-    [[maybe_unused]] const auto contents(content.substr(0, p));
-    TRACE("DOCTYPE", "contents", contents);
-    content.remove_prefix(p);
-    assert(content[0] == '>');
-    content.remove_prefix(">"sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
+    if (validateUTF8)
+        validateRead(bytesRead);
+
+    totalBytes += bytesRead;
+    handler.handleInputStart(content);
 }
 
 // refill content preserving unprocessed
-void XMLParser::refillPreserve(bool& doneReading) {
+// The handler is told of the end of the parsed input before the unprocessed
+// content moves, and of the new input after
+template <class Policy>
+void BasicXMLParser<Policy>::refillPreserve(bool& doneReading) {
+    if (inMemory) {
+        doneReading = true;
+        return;
+    }
+    handler.handleInputEnd(content);
+    PROFILE_MARK(refillMark, true);
+    [[maybe_unused]] const auto unprocessedSize = static_cast<long>(content.size());
     int bytesRead = refillContent(content);
+    PROFILE_REFILL(bytesRead, unprocessedSize, refillMark);
     if (bytesRead < 0) {
         std::cerr << "parser error : File input error\n";
         exit(1);
@@ -361,284 +512,78 @@ void XMLParser::refillPreserve(bool& doneReading) {
     if (bytesRead == 0) {
         doneReading = true;
     }
+    if (validateUTF8)
+        validateRead(bytesRead);
 
     totalBytes += bytesRead;
-
-}
-
-// parse character entity references
-std::string_view XMLParser::parseCharacterEntityReference() {
-    std::string_view unescapedCharacter;
-    std::string_view escapedCharacter;
-    if (content[1] == 'l' && content[2] == 't' && content[3] == ';') {
-        unescapedCharacter = "<";
-        escapedCharacter = "&lt;"sv;
-    } else if (content[1] == 'g' && content[2] == 't' && content[3] == ';') {
-        unescapedCharacter = ">";
-        escapedCharacter = "&gt;"sv;
-    } else if (content[1] == 'a' && content[2] == 'm' && content[3] == 'p' && content[4] == ';') {
-        unescapedCharacter = "&";
-        escapedCharacter = "&amp;"sv;
-    } else {
-        unescapedCharacter = "&";
-        escapedCharacter = "&"sv;
-    }
-    assert(content.compare(0, escapedCharacter.size(), escapedCharacter) == 0);
-    content.remove_prefix(escapedCharacter.size());
-    [[maybe_unused]] const auto characters(unescapedCharacter);
-    TRACE("CHARACTERS", "characters", characters);
-    return characters;
-}
-
-// parse character non-entity references
-std::string_view XMLParser::parseCharacterNotEntityReference() {
-    assert(content[0] != '<' && content[0] != '&');
-    const auto characterEndPosition = content.find_first_of("<&");
-    const auto characters = (content.substr(0, characterEndPosition));\
-    TRACE("CHARACTERS", "characters", characters);
-    content.remove_prefix(characters.size());
-    return characters;
-}
-
-// parse XML comment
-std::string_view XMLParser::parseComment(bool& doneReading) {
-    assert(content.compare(0, "<!--"sv.size(), "<!--"sv) == 0);
-    content.remove_prefix("<!--"sv.size());
-    auto tagEndPosition = content.find("-->"sv);
-    if (tagEndPosition == content.npos) {
-        // refill content preserving unprocessed
-        refillPreserve(doneReading);
-        tagEndPosition = content.find("-->"sv);
-        if (tagEndPosition == content.npos) {
-            std::cerr << "parser error : Unterminated XML comment\n";
-            exit(1);
-        }
-    }
-    [[maybe_unused]] const auto comment(content.substr(0, tagEndPosition));
-    TRACE("COMMENT", "content", comment);
-    content.remove_prefix(tagEndPosition);
-    assert(content.compare(0, "-->"sv.size(), "-->"sv) == 0);
-    content.remove_prefix("-->"sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE) == content.npos ? content.size() : content.find_first_not_of(WHITESPACE));
-    return comment;
+    handler.handleInputStart(content);
 }
 
-// parse CDATA
-void XMLParser::parseCDATA(bool& doneReading, std::string_view& characters) {
-    content.remove_prefix("<![CDATA["sv.size());
-    auto tagEndPosition = content.find("]]>"sv);
-    if (tagEndPosition == content.npos) {
-        // refill content preserving unprocessed
+// refill content preserving unprocessed, until the end of the token is in the
+// content, e.g., a start tag larger than the buffer
+// A token without an end at the end of the input is an error of its parse
+template <class Policy>
+template <class FindEnd>
+void BasicXMLParser<Policy>::refillToken(bool& doneReading, FindEnd findEnd) {
+    while (!doneReading && findEnd(content) == content.npos)
         refillPreserve(doneReading);
-        tagEndPosition = content.find("]]>"sv);
-        if (tagEndPosition == content.npos) {
-            std::cerr << "parser error : Unterminated CDATA\n";
-            exit(1);
-        }
-    }
-    characters = (content.substr(0, tagEndPosition));
-    content.remove_prefix(tagEndPosition);
-    content.remove_prefix("]]>"sv.size());
-    TRACE("CDATA", "characters", characters);
 }
 
-// parse processing instruction
-std::pair<std::string_view, std::string_view> XMLParser::parseProcessing() {
-    assert(content.compare(0, "<?"sv.size(), "<?"sv) == 0);
-    content.remove_prefix("<?"sv.size());
-    const auto tagEndPosition = content.find("?>"sv);
-    if (tagEndPosition == content.npos) {
-        std::cerr << "parser error: Incomplete XML declaration\n";
+// validate the UTF-8 of the bytes just read into the content
+template <class Policy>
+void BasicXMLParser<Policy>::validateRead(long bytesRead) {
+    // the bytes just read are at the end of the content, while still in cache
+    const auto invalidOffset = bytesRead > 0 ? utf8Validator.validate(content.substr(content.size() - bytesRead))
+                                             : utf8Validator.finish();
+    if (invalidOffset != -1) {
+        std::cerr << "parser error : Invalid UTF-8 at byte offset " << baseOffset + invalidOffset << '\n';
         exit(1);
     }
-    auto nameEndPosition = content.find_first_of(NAMEEND);
-    if (nameEndPosition == content.npos) {
-        std::cerr << "parser error : Unterminated processing instruction\n";
-        exit(1);
-    }
-    [[maybe_unused]] const auto target(content.substr(0, nameEndPosition));
-    [[maybe_unused]] const auto data(content.substr(nameEndPosition, tagEndPosition - nameEndPosition));
-    TRACE("PI", "target", target, "data", data);
-    content.remove_prefix(tagEndPosition);
-    assert(content.compare(0, "?>"sv.size(), "?>"sv) == 0);
-    content.remove_prefix("?>"sv.size());
-    return std::pair(target, data);
 }
 
-// parse end tag
-void XMLParser::parseEndTag(std::string_view& qName, std::string_view& prefix, std::string_view& localName) {
-    assert(content.compare(0, "</"sv.size(), "</"sv) == 0);
-    content.remove_prefix("</"sv.size());
-    if (content[0] == ':') {
-        std::cerr << "parser error : Invalid end tag name\n";
-        exit(1);
-    }
-    auto nameEndPosition = content.find_first_of(NAMEEND);
-    if (nameEndPosition == content.size()) {
-        std::cerr << "parser error : Unterminated end tag '" << content.substr(0, nameEndPosition) << "'\n";
-        exit(1);
-    }
-    std::size_t colonPosition = 0;
-    if (content[nameEndPosition] == ':') {
-        colonPosition = nameEndPosition;
-        nameEndPosition = content.find_first_of(NAMEEND, nameEndPosition + 1);
-    }
-    qName = content.substr(0, nameEndPosition);
-    if (qName.empty()) {
-        std::cerr << "parser error: EndTag: invalid element name\n";
-        exit(1);
-    }
-    prefix = qName.substr(0, colonPosition);
-    localName = qName.substr(colonPosition ? colonPosition + 1 : 0);
-    TRACE("END TAG", "qName", qName, "prefix", prefix, "localName", localName);
-    content.remove_prefix(nameEndPosition);
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    assert(content.compare(0, ">"sv.size(), ">"sv) == 0);
-    content.remove_prefix(">"sv.size());
-}
-
-// parse start tag
-void XMLParser::parseStartTag(std::string_view& qName, std::string_view& prefix, std::string_view& localName) {
-    assert(content.compare(0, "<"sv.size(), "<"sv) == 0);
-    content.remove_prefix("<"sv.size());
-    if (content[0] == ':') {
-        std::cerr << "parser error : Invalid start tag name\n";
-        exit(1);
-    }
-    auto nameEndPosition = content.find_first_of(NAMEEND);
-    if (nameEndPosition == content.size()) {
-        std::cerr << "parser error : Unterminated start tag '" << content.substr(0, nameEndPosition) << "'\n";
-        exit(1);
-    }
-    std::size_t colonPosition = 0;
-    if (content[nameEndPosition] == ':') {
-        colonPosition = nameEndPosition;
-        nameEndPosition = content.find_first_of(NAMEEND, nameEndPosition + 1);
-    }
-    qName = content.substr(0, nameEndPosition);
-    if (qName.empty()) {
-        std::cerr << "parser error: StartTag: invalid element name\n";
-        exit(1);
-    }
-    prefix = qName.substr(0, colonPosition);
-    localName = qName.substr(colonPosition ? colonPosition + 1 : 0, nameEndPosition);
-    TRACE("START TAG", "qName", qName, "prefix", prefix, "localName", localName);
-    content.remove_prefix(nameEndPosition);
-}
-
-// parse XML namespace
-std::pair<std::string_view, std::string_view> XMLParser::parseNamespace() {
-    assert(content.compare(0, "xmlns"sv.size(), "xmlns"sv) == 0);
-    content.remove_prefix("xmlns"sv.size());
-    auto nameEndPosition = content.find('=');
-    if (nameEndPosition == content.npos) {
-        std::cerr << "parser error : incomplete namespace\n";
-        exit(1);
-    }
-    std::size_t prefixSize = 0;
-    if (content[0] == ':') {
-        content.remove_prefix(":"sv.size());
-        --nameEndPosition;
-        prefixSize = nameEndPosition;
-    }
-    [[maybe_unused]] const auto prefix(content.substr(0, prefixSize));
-    content.remove_prefix(nameEndPosition);
-    content.remove_prefix("="sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    if (content.empty()) {
-        std::cerr << "parser error : incomplete namespace\n";
-        exit(1);
-    }
-    const auto delimiter = content[0];
-    if (delimiter != '"' && delimiter != '\'') {
-        std::cerr << "parser error : incomplete namespace\n";
-        exit(1);
+// parse XML comment, refilling when the comment is incomplete
+template <class Policy>
+std::string_view BasicXMLParser<Policy>::parseComment(bool& doneReading) {
+    auto comment = xml_parser::parseComment(content);
+    while (!comment && !doneReading) {
+        // refill content preserving unprocessed, until the end of a comment larger than the buffer
+        refillPreserve(doneReading);
+        comment = xml_parser::parseComment(content);
     }
-    content.remove_prefix("\""sv.size());
-    const auto valueEndPosition = content.find(delimiter);
-    if (valueEndPosition == content.npos) {
-        std::cerr << "parser error : incomplete namespace\n";
+    if (!comment) {
+        std::cerr << "parser error : Unterminated XML comment\n";
         exit(1);
     }
-    [[maybe_unused]] const auto uri(content.substr(0, valueEndPosition));
-    TRACE("NAMESPACE", "prefix", prefix, "uri", uri);
-    content.remove_prefix(valueEndPosition);
-    assert(content.compare(0, "\""sv.size(), "\""sv) == 0);
-    content.remove_prefix("\""sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    return std::make_pair(prefix, uri);
+    return *comment;
 }
 
-// parse attribute
-std::string_view XMLParser::parseAttribute(std::string_view& qName, [[maybe_unused]] std::string_view& prefix, std::string_view& localName) {
-    auto nameEndPosition = content.find_first_of(NAMEEND);
-    if (nameEndPosition == content.size()) {
-        std::cerr << "parser error : Empty attribute name" << '\n';
-        exit(1);
-    }
-    std::size_t colonPosition = 0;
-    if (content[nameEndPosition] == ':') {
-        colonPosition = nameEndPosition;
-        nameEndPosition = content.find_first_of(NAMEEND, nameEndPosition + 1);
-    }
-    qName = content.substr(0, nameEndPosition);
-    prefix = qName.substr(0, colonPosition);
-    localName = qName.substr(colonPosition ? colonPosition + 1 : 0);
-    content.remove_prefix(nameEndPosition);
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    if (content.empty()) {
-        std::cerr << "parser error : attribute " << qName << " incomplete attribute\n";
-        exit(1);
-    }
-    if (content[0] != '=') {
-        std::cerr << "parser error : attribute " << qName << " missing =\n";
-        exit(1);
-    }
-    content.remove_prefix("="sv.size());
-    content.remove_prefix(content.find_first_not_of(WHITESPACE));
-    const auto delimiter = content[0];
-    if (delimiter != '"' && delimiter != '\'') {
-        std::cerr << "parser error : attribute " << qName << " missing delimiter\n";
-        exit(1);
+// parse CDATA, refilling when the CDATA is incomplete
+template <class Policy>
+std::string_view BasicXMLParser<Policy>::parseCDATA(bool& doneReading) {
+    auto characters = xml_parser::parseCDATA(content);
+    while (!characters && !doneReading) {
+        // refill content preserving unprocessed, until the end of a CDATA larger than the buffer
+        refillPreserve(doneReading);
+        characters = xml_parser::parseCDATA(content);
     }
-    content.remove_prefix("\""sv.size());
-    const auto valueEndPosition = content.find(delimiter);
-    if (valueEndPosition == content.npos) {
-        std::cerr << "parser error : attribute " << qName << " missing delimiter\n";
+    if (!characters) {
+        std::cerr << "parser error : Unterminated CDATA\n";
         exit(1);
     }
-    const std::string_view value(content.substr(0, valueEndPosition));
-    content.remove_prefix(valueEndPosition);
-    TRACE("ATTRIBUTE", "qname", qName, "prefix", prefix, "localName", localName, "value", value);
-    return value;
-}
-
-// Accessor::predicate to test if the tag is a XML declaration
-bool XMLParser::isXML() {
-    return content[0] == '<' && content[1] == '?' && content[2] == 'x' && content[3] == 'm' && content[4] == 'l' && content[5] == ' ';
+    return *characters;
 }
 
-// Accessor::predicate to test if the tag is DOCTYPE
-bool XMLParser::isDOCTYPE() {
-    return content[1] == '!' && content[0] == '<' && content[2] == 'D' && content[3] == 'O' && content[4] == 'C' && content[5] == 'T' && content[6] == 'Y' && content[7] == 'P' && content[8] == 'E' && content[9] == ' ';
-}
+// parser with all features
+template class BasicXMLParser<FullParserPolicy>;
 
-// Accessor::predicate to test if the tag is CDATA
-bool XMLParser::isCDATA() {
-    return content[1] == '!' /* && content[0] == '<' */ && content[2] == '[' && content[3] == 'C' && content[4] == 'D' && content[5] == 'A' && content[6] == 'T' && content[7] == 'A' && content[8] == '[';
-}
+// parser with only the features needed for srcFacts
+template class BasicXMLParser<FactsParserPolicy>;
 
-// Accessor::predicate to test if the tag is a comment tag
-bool XMLParser::isComment() {
-    return (!content.empty() && content[0] == '<' && content[1] == '!' && content[2] == '-' && content[3] == '-') || (content[1] == '!' /* && content[0] == '<' */ && content[2] == '-' && content[3] == '-');
-}
+// parser with only the features needed for srcNames
+template class BasicXMLParser<NamesParserPolicy>;
 
-// Accessor::predicate to test if the tag is an XML namespace
-bool XMLParser::isNamespace() {
-    return content[0] == 'x' && content[1] == 'm' && content[2] == 'l' && content[3] == 'n' && content[4] == 's' && (content[5] == ':' || content[5] == '=');
-}
+// parser with the features needed for the tree of each unit
+template class BasicXMLParser<TreeParserPolicy>;
 
-// Accessor::predicate to check if content has a specific character at a specific index
-bool XMLParser::isCharacter(int index, char character) {
-        return content[index] == character;
-}
+// parser with the features needed for filtering srcML
+template class BasicXMLParser<FilterParserPolicy>;
@@ -2,99 +2,200 @@
     XMLParser.hpp
 
     Header file for XML parsing class.
+
+    The parser is a class template on a feature policy (see XMLParserPolicy.hpp).
+    XMLParser is the parser with all features. The member functions are defined in
+    XMLParser.cpp and explicitly instantiated there for each policy.
 */
 
 #ifndef XMLPARSER_HPP
 #define XMLPARSER_HPP
 
 #include "XMLParserHandler.hpp"
+#include "XMLParserPolicy.hpp"
+#include "UTF8Validator.hpp"
+#include "ParseProfile.hpp"
 #include <string_view>
 #include <optional>
 #include <functional>
+#include <array>
+#include <vector>
+#include <utility>
+#include <cstdint>
 
-class XMLParser {
+template <class Policy>
+class BasicXMLParser {
 public:
     // constructor
-    XMLParser(std::string_view content, XMLParserHandler& handler);
+    // Empty content is read from standard input. Otherwise, the content is the
+    // complete document in memory, e.g., one unit of a mapped srcML archive
+    BasicXMLParser(std::string_view content, XMLParserHandler& handler);
 
     // parse XML
     void parse();
 
+    // parse a fragment of the content of the root element, e.g., part of a large unit
+    // The fragment starts and ends at markup boundaries. There is no XML declaration
+    // and no start or end of the document, and the depth is relative to the start
+    void parseFragment();
+
+    // get the depth at the end of the fragment, relative to its start
+    int getFragmentDepth();
+
+    // get the lowest depth after an end tag in the fragment, relative to its start
+    int getFragmentMinDepth();
+
     // get totalBytes
     long getTotalBytes();
 
+    // validate that the content is UTF-8 as it is read
+    void setValidateUTF8(bool validate);
+
+    // check that the document is well-formed, i.e., that end tags match start tags
+    // and that attributes are unique
+    void setCheckWellFormed(bool check);
+
+    // record the events and refills of the parse in the profile
+    // Recording requires profiling compiled in (see ParseProfile.hpp)
+    void setProfile(ParseProfile* profile);
+
+    // parse a stream of documents, one after the other, e.g., from a pipe
+    // Each document has its own start and end of document, and XML declaration
+    void setMultipleDocuments(bool multiple);
+
+    // offset in the document of the start of the content, e.g., of a unit parsed
+    // separately, so the byte offsets of the errors are in the document
+    void setBaseOffset(long offset);
+
 private:
-    // parse XML declaration
-    void parseXMLDeclaration(std::string_view& version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone);
+    // the push parser parses its complete tokens with this parser (see PushXMLParser.hpp)
+    template <class> friend class BasicPushXMLParser;
 
-    // parse required version
-    void parseVersion(std::string_view& version);
+    // parse file from the start
+    void parseBegin();
+
+    // parse the XML declaration and DOCTYPE at the front of the document
+    void parseProlog(bool& doneReading);
+
+    // parse the comments after the root element, with nothing else after them,
+    // or in a stream of documents, up to the next document
+    void parseEpilog(bool& doneReading);
 
-    // parse optional encoding attribute
-    void parseEncoding(std::optional<std::string_view>& encoding);
+    // skip whitespace, in a stream of documents reading until there is content
+    // to decide what follows, or the end of the input
+    void skipEpilogWhitespace(bool& doneReading);
 
-    // parse optional standalone attribute
-    void parseStandalone(std::optional<std::string_view>& standalone);
+    // parse a part of a pushed document, from the input offset, that ends at a token boundary
+    // The first part starts with the prolog, and a part ends at or before the end of the root element
+    void parsePushedElements(std::string_view part, long offset, bool first);
 
-    //parse DOCTYPE
-    void parseDOCTYPE();
+    // parse a part of a pushed document after the root element, from the input offset
+    void parsePushedEpilog(std::string_view part, long offset);
+
+    // validate the UTF-8 of a chunk of a pushed document, or the end of the document when empty
+    void validatePushed(std::string_view chunk);
+
+    // end of a pushed document
+    void finishPushed();
+
+    // parse elements and their content until the end of the root element
+    // In a fragment, the parse continues to the end of the content. Without
+    // profiling, the loop has no checks for a profile
+    template <bool profiling>
+    void parseElements(bool& doneReading, bool fragment);
 
     // refill content preserving unprocessed
     void refillPreserve(bool& doneReading);
 
-    // parse character entity references
-    std::string_view parseCharacterEntityReference();
+    // refill content preserving unprocessed, until the end of the token is in the
+    // content, e.g., a start tag larger than the buffer
+    template <class FindEnd>
+    void refillToken(bool& doneReading, FindEnd findEnd);
+
+    // validate the UTF-8 of the bytes just read into the content
+    void validateRead(long bytesRead);
 
-    // parse character non-entity references
-    std::string_view parseCharacterNotEntityReference();
+    // offset in the document of the front of the content
+    long getOffset();
 
-    // parse XML comment
+    // check that the attribute name is unique in the start tag
+    void checkAttribute(std::string_view qName, long offset);
+
+    // check that the end tag matches the open start tag
+    void checkEndTag(std::string_view qName, long offset);
+
+    // parse XML comment, refilling when the comment is incomplete
     std::string_view parseComment(bool& doneReading);
 
-    // parse CDATA
-    void parseCDATA(bool& doneReading, std::string_view& characters);
+    // parse CDATA, refilling when the CDATA is incomplete
+    std::string_view parseCDATA(bool& doneReading);
 
-    // parse processing instruction
-    std::pair<std::string_view, std::string_view> parseProcessing();
+    // profile, input offset, and ticks at the start of an event
+    struct ProfileMark {
+        ParseProfile* profile;
+        long offset;
+        std::uint64_t ticks;
+    };
 
-    // parse end tag
-    void parseEndTag(std::string_view& qName, std::string_view& prefix, std::string_view& localName);
+    // data members
+    std::string_view content;
 
-    // parse start tag
-    void parseStartTag(std::string_view& qName, std::string_view& prefix, std::string_view& localName);
+    long totalBytes;
 
-    // parse XML namespace
-    std::pair<std::string_view, std::string_view> parseNamespace();
+    // offset in the document of the start of the input
+    long baseOffset;
 
-    // parse attribute
-    std::string_view parseAttribute(std::string_view& qName, [[maybe_unused]] std::string_view& prefix, std::string_view& localName);
+    // content is the complete document in memory, so there is no refill
+    bool inMemory;
 
-    // Accessor::predicate to test if the tag is a XML declaration
-    bool isXML();
+    bool validateUTF8;
 
-    // Accessor::predicate to test if the tag is DOCTYPE
-    bool isDOCTYPE();
+    UTF8Validator utf8Validator;
 
-    // Accessor::predicate to test if the tag is CDATA
-    bool isCDATA();
+    bool checkWellFormed;
 
-    // Accessor::predicate to test if the tag is a comment tag
-    bool isComment();
+    // input is a stream of documents
+    bool multipleDocuments;
 
-    // Accessor::predicate to test if the tag is an XML namespace
-    bool isNamespace();
+    // open element, as the hash and length of the name, and the input offset of the start tag
+    struct OpenElement {
+        std::uint64_t hash;
+        std::size_t length;
+        long offset;
+    };
 
-    // parse file from the start
-    void parseBegin();
+    std::vector<OpenElement> openElements;
 
-    // Accessor::predicate to check if content has a specific character at a specific index
-    bool isCharacter(int index, char character);
+    // attribute names of the current start tag with their hash
+    static constexpr int ATTRIBUTE_TABLE_SIZE = 32;
+    std::array<std::pair<std::uint64_t, std::string_view>, ATTRIBUTE_TABLE_SIZE> attributeNames;
+    int attributeCount;
 
-    // data members
-    std::string_view content;
+    // attribute names after the first ATTRIBUTE_TABLE_SIZE
+    std::vector<std::pair<std::uint64_t, std::string_view>> extraAttributeNames;
 
-    long totalBytes;
+    // depth at the end of a fragment, and the lowest depth in it, relative to its start
+    int fragmentDepth;
+    int fragmentMinDepth;
+
+    ParseProfile* profile;
 
     XMLParserHandler& handler;
 };
+
+// XML parser with all features
+using XMLParser = BasicXMLParser<FullParserPolicy>;
+
+// XML parser with only the features needed for srcFacts
+using FactsXMLParser = BasicXMLParser<FactsParserPolicy>;
+
+// XML parser with only the features needed for srcNames
+using NamesXMLParser = BasicXMLParser<NamesParserPolicy>;
+
+// XML parser with the features needed for the tree of each unit
+using TreeXMLParser = BasicXMLParser<TreeParserPolicy>;
+
+// XML parser with the features needed for filtering srcML
+using FilterXMLParser = BasicXMLParser<FilterParserPolicy>;
+
 #endif
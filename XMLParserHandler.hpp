@@ -49,6 +49,15 @@ public:
     // end Document Handler
     virtual void handleEndDocument() {};
 
+    // input start Handler, with the input that the views of the following events are in,
+    // at the start of the parse and after each refill, e.g., to copy the input verbatim
+    virtual void handleInputStart(std::string_view input) {};
+
+    // input end Handler, with the input not parsed yet, before each refill and at the end
+    // of the parse. The views of the input before it are invalid after a refill. The push
+    // parser reports neither, as its input is in the chunks of the caller
+    virtual void handleInputEnd(std::string_view unparsed) {};
+
 };
 
 #endif
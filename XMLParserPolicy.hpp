@@ -0,0 +1,147 @@
+/*
+    XMLParserPolicy.hpp
+
+    Compile-time feature policies for the XML parser. A policy selects which
+    parts of the XML the parser reports, so that an engine which only needs
+    a few of the events does not pay for the rest.
+*/
+
+#ifndef XMLPARSERPOLICY_HPP
+#define XMLPARSERPOLICY_HPP
+
+#include <string_view>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// all features, for general-purpose handlers
+struct FullParserPolicy {
+
+    // report XML namespace declarations
+    static constexpr bool namespaces = true;
+
+    // split qualified names into prefix and localName
+    static constexpr bool qualifiedNames = true;
+
+    // report end tags
+    static constexpr bool endTags = true;
+
+    // report processing instructions
+    static constexpr bool processingInstructions = true;
+
+    // report XML comments
+    static constexpr bool comments = true;
+
+    // report the attribute with this local name
+    static constexpr bool attribute(std::string_view /* localName */) {
+        return true;
+    }
+};
+
+// minimal features for counting srcML facts
+// End tags, comments, and processing instructions are skipped, names are not split, so
+// the localName is the qName, and only the url and type attributes are reported.
+// Namespace declarations are parsed as attributes, so they are not reported either
+struct FactsParserPolicy {
+
+    // report XML namespace declarations
+    static constexpr bool namespaces = false;
+
+    // split qualified names into prefix and localName
+    static constexpr bool qualifiedNames = false;
+
+    // report end tags
+    static constexpr bool endTags = false;
+
+    // report processing instructions
+    static constexpr bool processingInstructions = false;
+
+    // report XML comments
+    static constexpr bool comments = false;
+
+    // report the attribute with this local name
+    static constexpr bool attribute(std::string_view localName) {
+        return localName == "url"sv || localName == "type"sv;
+    }
+};
+
+// minimal features for counting the names of srcML
+// As for srcFacts, with end tags reported, since the text of a name ends at its end
+// tag, and only the url attribute is reported
+struct NamesParserPolicy {
+
+    // report XML namespace declarations
+    static constexpr bool namespaces = false;
+
+    // split qualified names into prefix and localName
+    static constexpr bool qualifiedNames = false;
+
+    // report end tags
+    static constexpr bool endTags = true;
+
+    // report processing instructions
+    static constexpr bool processingInstructions = false;
+
+    // report XML comments
+    static constexpr bool comments = false;
+
+    // report the attribute with this local name
+    static constexpr bool attribute(std::string_view localName) {
+        return localName == "url"sv;
+    }
+};
+
+// features for building the tree of each srcML unit
+// End tags and all attributes are reported, names are not split, so the localName
+// is the qName, e.g., cpp:if, and namespace declarations are not attributes
+struct TreeParserPolicy {
+
+    // report XML namespace declarations
+    static constexpr bool namespaces = true;
+
+    // split qualified names into prefix and localName
+    static constexpr bool qualifiedNames = false;
+
+    // report end tags
+    static constexpr bool endTags = true;
+
+    // report processing instructions
+    static constexpr bool processingInstructions = false;
+
+    // report XML comments
+    static constexpr bool comments = false;
+
+    // report the attribute with this local name
+    static constexpr bool attribute(std::string_view) {
+        return true;
+    }
+};
+
+// features for filtering srcML, with the unchanged input copied verbatim
+// All the events that a filter may change are reported, i.e., start and end tags,
+// attributes with their prefix, namespace declarations, and comments. The DOCTYPE
+// and processing instructions are copied without being reported
+struct FilterParserPolicy {
+
+    // report XML namespace declarations
+    static constexpr bool namespaces = true;
+
+    // split qualified names into prefix and localName
+    static constexpr bool qualifiedNames = true;
+
+    // report end tags
+    static constexpr bool endTags = true;
+
+    // report processing instructions
+    static constexpr bool processingInstructions = false;
+
+    // report XML comments
+    static constexpr bool comments = true;
+
+    // report the attribute with this local name
+    static constexpr bool attribute(std::string_view) {
+        return true;
+    }
+};
+
+#endif
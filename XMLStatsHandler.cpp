@@ -95,6 +95,38 @@ int XMLStatsHandler::getEndDocumentCount()
     return endDocumentCount;
 }
 
+// get the counts of all the measures
+XMLStatsHandler::Counts XMLStatsHandler::getCounts()
+{
+    return Counts{ unitCount, loc, startDocumentCount, XMLDeclarationCount, startTagCount,
+                   endTagCount, charactersCount, attributeCount, XMLNamespaceCount,
+                   XMLCommentCount, CDATACount, processingInstructionCount, endDocumentCount };
+}
+
+// add counts of all the measures
+void XMLStatsHandler::addCounts(const Counts& counts)
+{
+    unitCount                  += counts[0];
+    loc                        += counts[1];
+    startDocumentCount         += counts[2];
+    XMLDeclarationCount        += counts[3];
+    startTagCount              += counts[4];
+    endTagCount                += counts[5];
+    charactersCount            += counts[6];
+    attributeCount             += counts[7];
+    XMLNamespaceCount          += counts[8];
+    XMLCommentCount            += counts[9];
+    CDATACount                 += counts[10];
+    processingInstructionCount += counts[11];
+    endDocumentCount           += counts[12];
+}
+
+// merge the stats of another handler
+void XMLStatsHandler::merge(XMLStatsHandler& other)
+{
+    addCounts(other.getCounts());
+}
+
 // start Document Handler
 void XMLStatsHandler::handleStartDocument() {
     ++startDocumentCount;
@@ -10,6 +10,8 @@
 #include "XMLStatsHandler.hpp"
 #include "XMLParserHandler.hpp"
 #include <string>
+#include <string_view>
+#include <array>
 
 // provides literal string operator""sv
 using namespace std::literals::string_view_literals;
@@ -61,6 +63,25 @@ public:
     // get endDocumentCount
     int getEndDocumentCount();
 
+    // counts of all the measures, e.g., to store the stats of a shard
+    using Counts = std::array<int, 13>;
+
+    // names of the counts, in the order of getCounts(), e.g., for partial results
+    static constexpr std::array<std::string_view, 13> COUNT_NAMES = {
+        "unitCount", "loc", "startDocumentCount", "XMLDeclarationCount", "startTagCount",
+        "endTagCount", "charactersCount", "attributeCount", "XMLNamespaceCount",
+        "XMLCommentCount", "CDATACount", "processingInstructionCount", "endDocumentCount"
+    };
+
+    // get the counts of all the measures
+    Counts getCounts();
+
+    // add counts of all the measures
+    void addCounts(const Counts& counts);
+
+    // merge the stats of another handler
+    void merge(XMLStatsHandler& other);
+
 protected:
     // start Document Handler
     void handleStartDocument() override;
@@ -0,0 +1,36 @@
+# allocCheck.cmake
+#
+# Checks that the heap allocations of the parse do not grow with the input, by comparing
+# the allocations reported by srcfacts --memory on a small and on a large srcML archive.
+# The allocations are the refill buffer and the first blocks and capacities of the
+# handler, made once, so the large archive has no more allocations than the small one
+#
+# cmake -DSRCFACTS=srcfacts -DSMALL=small.xml -DLARGE=large.xml ["-DOPTIONS=--full --wellformed"] -P allocCheck.cmake
+
+separate_arguments(options UNIX_COMMAND "${OPTIONS}")
+
+# number of heap allocations of the parse of the input
+function(parse_allocations input result)
+    execute_process(COMMAND ${SRCFACTS} ${options} --memory
+        INPUT_FILE ${input}
+        OUTPUT_QUIET
+        ERROR_VARIABLE report
+        RESULT_VARIABLE status)
+    if(NOT status EQUAL 0)
+        message(FATAL_ERROR "srcfacts ${OPTIONS} failed on ${input}\n${report}")
+    endif()
+    if(NOT report MATCHES "Parse heap allocations *\\| *([0-9]+)")
+        message(FATAL_ERROR "srcfacts ${OPTIONS} did not report the heap allocations of the parse")
+    endif()
+    set(${result} ${CMAKE_MATCH_1} PARENT_SCOPE)
+endfunction()
+
+parse_allocations(${SMALL} smallAllocations)
+parse_allocations(${LARGE} largeAllocations)
+file(SIZE ${SMALL} smallSize)
+file(SIZE ${LARGE} largeSize)
+string(STRIP "srcfacts ${OPTIONS}" command)
+message(STATUS "${command}: ${smallAllocations} allocations for ${smallSize} bytes, ${largeAllocations} allocations for ${largeSize} bytes")
+if(largeAllocations GREATER smallAllocations)
+    message(FATAL_ERROR "The heap allocations of the parse grow with the input")
+endif()
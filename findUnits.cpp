@@ -0,0 +1,205 @@
+/*
+    findUnits.cpp
+
+    Implementation file for the findUnits, unitEnvelope, findRootContent, and findLiteral functions
+*/
+
+#include "findUnits.hpp"
+#include "xml_parser.hpp"
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+using namespace xml_parser;
+
+namespace {
+
+    // position of the '>' at the end of the start tag at pos, skipping attribute values
+    std::size_t findTagEnd(std::string_view document, std::size_t pos) {
+        while (true) {
+            pos = document.find_first_of("\"'>"sv, pos);
+            if (pos == document.npos) {
+                std::cerr << "parser error : Unterminated unit start tag\n";
+                exit(1);
+            }
+            if (document[pos] == '>')
+                return pos;
+            pos = document.find(document[pos], pos + 1);
+            if (pos == document.npos) {
+                std::cerr << "parser error : Unterminated attribute value in unit start tag\n";
+                exit(1);
+            }
+            ++pos;
+        }
+    }
+
+    // unit start tag at pos, i.e., not a longer name that starts with "unit"
+    bool isUnitStartTag(std::string_view document, std::size_t pos) {
+        const auto after = pos + "<unit"sv.size();
+        return document.compare(pos, "<unit"sv.size(), "<unit"sv) == 0
+            && after < document.size()
+            && (isClass(document[after], WHITESPACE_CHARACTER) || document[after] == '>' || document[after] == '/');
+    }
+
+    // end of the unit whose start tag is at pos, i.e., just past the unit end tag
+    std::size_t findUnitEnd(std::string_view document, std::size_t pos) {
+        const auto tagEnd = findTagEnd(document, pos);
+        if (document[tagEnd - 1] == '/')
+            return tagEnd + ">"sv.size();
+        const auto endTag = findLiteral(document, "</unit>"sv, tagEnd);
+        if (endTag == document.npos) {
+            std::cerr << "parser error : Unterminated unit at byte offset " << pos << '\n';
+            exit(1);
+        }
+        return endTag + "</unit>"sv.size();
+    }
+
+    // offset of the root unit, after the XML declaration, DOCTYPE, comments, and processing instructions
+    std::size_t findRoot(std::string_view document) {
+        auto content = document;
+        skipWhitespace(content);
+        while (!content.empty()) {
+            if (isComment(content)) {
+                if (!parseComment(content)) {
+                    std::cerr << "parser error : Unterminated XML comment\n";
+                    exit(1);
+                }
+            } else if (isCharacter(content, 0, '<') && isCharacter(content, 1, '?')) {
+                skipProcessing(content);
+            } else if (isDOCTYPE(content)) {
+                parseDOCTYPE(content);
+            } else {
+                break;
+            }
+            skipWhitespace(content);
+        }
+        const auto rootOffset = document.size() - content.size();
+        if (!isUnitStartTag(document, rootOffset)) {
+            std::cerr << "parser error : Root element is not a srcML unit\n";
+            exit(1);
+        }
+        return rootOffset;
+    }
+}
+
+/*
+    Position of the literal in the document at or after pos.
+
+    The content between unit tags is dense with '<' from the other tags, so a
+    search on the first character stops often. memmem() and Boyer-Moore-Horspool do not.
+
+    @param[in] document Document to search
+    @param[in] literal Literal to find
+    @param[in] pos Position in the document to start the search
+    @return Position of the literal, or npos
+*/
+[[nodiscard]] std::size_t findLiteral(std::string_view document, std::string_view literal, std::size_t pos) {
+#if !defined(_MSC_VER)
+    const auto found = static_cast<const char*>(memmem(document.data() + pos, document.size() - pos, literal.data(), literal.size()));
+    return found ? static_cast<std::size_t>(found - document.data()) : document.npos;
+#else
+    const auto searcher = std::boyer_moore_horspool_searcher(literal.begin(), literal.end());
+    const auto found = std::search(document.begin() + pos, document.end(), searcher);
+    return found == document.end() ? document.npos : static_cast<std::size_t>(found - document.begin());
+#endif
+}
+
+/*
+    Find the top-level units of a srcML document.
+
+    For a srcML archive, these are the units directly inside the root unit.
+    For a single srcML unit, it is the root unit. The ranges are from the start
+    of the unit start tag to the end of the unit end tag.
+
+    Only the unit tags are scanned, not the XML in between, so a unit tag inside
+    an XML comment or CDATA section is not supported. srcML does not produce those.
+
+    @param[in] document Complete srcML document
+    @return Byte ranges of the units in document order
+*/
+[[nodiscard]] std::vector<UnitRange> findUnits(std::string_view document) {
+
+    const auto rootOffset = findRoot(document);
+
+    // units directly inside the root unit
+    std::vector<UnitRange> units;
+    auto pos = findTagEnd(document, rootOffset) + ">"sv.size();
+    if (document[pos - 2] != '/') {
+        while ((pos = findLiteral(document, "<unit"sv, pos)) != document.npos) {
+            if (!isUnitStartTag(document, pos)) {
+                pos += "<unit"sv.size();
+                continue;
+            }
+            const auto unitEnd = findUnitEnd(document, pos);
+            units.push_back(UnitRange{ pos, unitEnd - pos });
+            pos = unitEnd;
+        }
+    }
+
+    // a single unit, not an archive
+    if (units.empty())
+        units.push_back(UnitRange{ rootOffset, findUnitEnd(document, rootOffset) - rootOffset });
+
+    return units;
+}
+
+/*
+    The srcML document without the units.
+
+    This is the XML declaration, the root unit start and end tags, and the
+    content between the units, e.g., newlines. It is a complete document, so
+    it can be parsed separately from the units. Each unit is replaced by an
+    empty CDATA section, so the content before and after a unit stays separate,
+    e.g., whitespace after an XML comment. For a single unit there is nothing
+    outside the unit, and the result is empty.
+
+    @param[in] document Complete srcML document
+    @param[in] units Byte ranges of the units from findUnits()
+    @return Document without the units
+*/
+[[nodiscard]] std::string unitEnvelope(std::string_view document, const std::vector<UnitRange>& units) {
+
+    if (units.empty() || units.front().offset == findRoot(document))
+        return std::string();
+
+    std::string envelope(document.substr(0, units.front().offset));
+    for (std::size_t i = 1; i < units.size(); ++i) {
+        const auto previousEnd = units[i - 1].offset + units[i - 1].length;
+        envelope += "<![CDATA[]]>"sv;
+        envelope += document.substr(previousEnd, units[i].offset - previousEnd);
+    }
+    envelope += "<![CDATA[]]>"sv;
+    envelope += document.substr(units.back().offset + units.back().length);
+
+    return envelope;
+}
+
+/*
+    The content of the root unit, between its start tag and its end tag.
+
+    The end tag is the last end tag in the document, so only whitespace and
+    XML comments without end tags can follow it. For an empty root element
+    the content is empty.
+
+    @param[in] document Complete srcML document
+    @return Byte range of the content of the root unit
+*/
+[[nodiscard]] UnitRange findRootContent(std::string_view document) {
+
+    const auto rootOffset = findRoot(document);
+    const auto contentStart = findTagEnd(document, rootOffset) + ">"sv.size();
+    if (document[contentStart - 2] == '/')
+        return UnitRange{ contentStart, 0 };
+
+    const auto endTag = document.rfind("</"sv);
+    if (endTag == document.npos || endTag < contentStart) {
+        std::cerr << "parser error : Unterminated root unit\n";
+        exit(1);
+    }
+
+    return UnitRange{ contentStart, endTag - contentStart };
+}
@@ -0,0 +1,77 @@
+/*
+    findUnits.hpp
+
+    Include file for the findUnits, unitEnvelope, findRootContent, and findLiteral functions
+*/
+
+#ifndef INCLUDED_FINDUNITS_HPP
+#define INCLUDED_FINDUNITS_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// byte range of a unit in a srcML document
+struct UnitRange {
+    std::size_t offset;
+    std::size_t length;
+};
+
+/*
+    Position of the literal in the document at or after pos.
+
+    The content between unit tags is dense with '<' from the other tags, so a
+    search on the first character stops often. memmem() and Boyer-Moore-Horspool do not.
+
+    @param[in] document Document to search
+    @param[in] literal Literal to find
+    @param[in] pos Position in the document to start the search
+    @return Position of the literal, or npos
+*/
+[[nodiscard]] std::size_t findLiteral(std::string_view document, std::string_view literal, std::size_t pos);
+
+/*
+    Find the top-level units of a srcML document.
+
+    For a srcML archive, these are the units directly inside the root unit.
+    For a single srcML unit, it is the root unit. The ranges are from the start
+    of the unit start tag to the end of the unit end tag.
+
+    Only the unit tags are scanned, not the XML in between, so a unit tag inside
+    an XML comment or CDATA section is not supported. srcML does not produce those.
+
+    @param[in] document Complete srcML document
+    @return Byte ranges of the units in document order
+*/
+[[nodiscard]] std::vector<UnitRange> findUnits(std::string_view document);
+
+/*
+    The srcML document without the units.
+
+    This is the XML declaration, the root unit start and end tags, and the
+    content between the units, e.g., newlines. It is a complete document, so
+    it can be parsed separately from the units. Each unit is replaced by an
+    empty CDATA section, so the content before and after a unit stays separate,
+    e.g., whitespace after an XML comment. For a single unit there is nothing
+    outside the unit, and the result is empty.
+
+    @param[in] document Complete srcML document
+    @param[in] units Byte ranges of the units from findUnits()
+    @return Document without the units
+*/
+[[nodiscard]] std::string unitEnvelope(std::string_view document, const std::vector<UnitRange>& units);
+
+/*
+    The content of the root unit, between its start tag and its end tag.
+
+    The end tag is the last end tag in the document, so only whitespace and
+    XML comments without end tags can follow it. For an empty root element
+    the content is empty.
+
+    @param[in] document Complete srcML document
+    @return Byte range of the content of the root unit
+*/
+[[nodiscard]] UnitRange findRootContent(std::string_view document);
+
+#endif
@@ -0,0 +1,119 @@
+/*
+    hashContent.cpp
+
+    Implementation file for the hashContent function
+
+    XXH64 processes 32-byte stripes in four independent lanes, so the
+    multiplies of the lanes overlap, then folds the lanes and the tail.
+*/
+
+#include "hashContent.hpp"
+#include <cstring>
+
+namespace {
+
+    const std::uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    const std::uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    const std::uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    const std::uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    const std::uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    // rotate left
+    inline std::uint64_t rotateLeft(std::uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // read 8 bytes in little-endian order
+    inline std::uint64_t read64(const char* p) {
+        std::uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap64(value);
+#endif
+        return value;
+    }
+
+    // read 4 bytes in little-endian order
+    inline std::uint64_t read32(const char* p) {
+        std::uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap32(value);
+#endif
+        return value;
+    }
+
+    // add 8 bytes of input to a lane
+    inline std::uint64_t round(std::uint64_t lane, std::uint64_t input) {
+        lane += input * PRIME2;
+        lane = rotateLeft(lane, 31);
+        return lane * PRIME1;
+    }
+
+    // fold a lane into the hash
+    inline std::uint64_t mergeRound(std::uint64_t hash, std::uint64_t lane) {
+        hash ^= round(0, lane);
+        return hash * PRIME1 + PRIME4;
+    }
+}
+
+/*
+    Hash the content with the XXH64 algorithm, seed 0.
+
+    Used to detect changes in the content of a unit, not for security.
+
+    @param[in] content Content to hash
+    @return 64-bit hash of the content
+*/
+[[nodiscard]] std::uint64_t hashContent(std::string_view content) {
+
+    const char* p = content.data();
+    const char* const end = p + content.size();
+    std::uint64_t hash;
+    if (content.size() >= 32) {
+        std::uint64_t lane1 = PRIME1 + PRIME2;
+        std::uint64_t lane2 = PRIME2;
+        std::uint64_t lane3 = 0;
+        std::uint64_t lane4 = 0 - PRIME1;
+        const char* const limit = end - 32;
+        do {
+            lane1 = round(lane1, read64(p));
+            lane2 = round(lane2, read64(p + 8));
+            lane3 = round(lane3, read64(p + 16));
+            lane4 = round(lane4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        hash = rotateLeft(lane1, 1) + rotateLeft(lane2, 7) + rotateLeft(lane3, 12) + rotateLeft(lane4, 18);
+        hash = mergeRound(hash, lane1);
+        hash = mergeRound(hash, lane2);
+        hash = mergeRound(hash, lane3);
+        hash = mergeRound(hash, lane4);
+    } else {
+        hash = PRIME5;
+    }
+    hash += content.size();
+
+    // tail of less than 32 bytes
+    for (; p + 8 <= end; p += 8) {
+        hash ^= round(0, read64(p));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (p + 4 <= end) {
+        hash ^= read32(p) * PRIME1;
+        hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= static_cast<unsigned char>(*p) * PRIME5;
+        hash = rotateLeft(hash, 11) * PRIME1;
+    }
+
+    // avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
@@ -0,0 +1,23 @@
+/*
+    hashContent.hpp
+
+    Include file for the hashContent function
+*/
+
+#ifndef INCLUDED_HASHCONTENT_HPP
+#define INCLUDED_HASHCONTENT_HPP
+
+#include <string_view>
+#include <cstdint>
+
+/*
+    Hash the content with the XXH64 algorithm, seed 0.
+
+    Used to detect changes in the content of a unit, not for security.
+
+    @param[in] content Content to hash
+    @return 64-bit hash of the content
+*/
+[[nodiscard]] std::uint64_t hashContent(std::string_view content);
+
+#endif
@@ -12,6 +12,18 @@
     CDATA parts, but you must escape all >, <, and & in
     Character and CDATA content.
 
+    The option --profile outputs the counts, bytes, and time of each kind of
+    parse event after the performance statistics (see ParseProfile.hpp).
+
+    The option --perf-counters outputs the hardware performance counters of the
+    parse, e.g., cycles and cache misses (see PerfCounters.hpp).
+
+    The option --memory outputs the memory usage, i.e., peak RSS, the input
+    buffer, and the heap allocations of the parse (see memoryUsage.hpp).
+
+    The option --push SIZE reads the input in chunks of at most SIZE bytes and
+    pushes each to the parser, as an event loop does (see PushXMLParser.hpp).
+    The output is the same as without it.
 */
 
 #include <iostream>
@@ -20,32 +32,136 @@
 #include <string_view>
 #include <cmath>
 #include <chrono>
+#include <cstring>
 #include <cassert>
+#include <optional>
+#include <vector>
 #include "refillContent.hpp"
 #include "XMLParser.hpp"
+#include "PushXMLParser.hpp"
+#include "TapeReplayer.hpp"
 #include "IdentityHandler.hpp"
+#include "ParseProfile.hpp"
+#include "PerfCounters.hpp"
+#include "memoryUsage.hpp"
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#define READ read
+#else
+#include <BaseTsd.h>
+#include <io.h>
+typedef SSIZE_T ssize_t;
+#define READ _read
+#define STDIN_FILENO 0
+#endif
 
 // provides literal string operator""sv
 using namespace std::literals::string_view_literals;
 
-int main() {
+int main(int argc, char* argv[]) {
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    const char* tapeFilename = nullptr;
+    bool profile = false;
+    bool perfCounters = false;
+    bool memory = false;
+    long pushSize = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else if (strcmp(argv[i], "--tape") == 0 && i + 1 < argc) {
+            tapeFilename = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (strcmp(argv[i], "--perf-counters") == 0) {
+            perfCounters = true;
+        } else if (strcmp(argv[i], "--memory") == 0) {
+            memory = true;
+        } else if (strcmp(argv[i], "--push") == 0 && i + 1 < argc) {
+            pushSize = std::stol(argv[++i]);
+            if (pushSize < 1) {
+                std::cerr << "identity: Invalid push size " << argv[i] << '\n';
+                return 1;
+            }
+        } else {
+            std::cerr << "identity: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    if (profile && (!ParseProfile::compiledIn || tapeFilename)) {
+        std::cerr << "identity: The option --profile requires profiling compiled in, cmake -DPROFILE=ON, and a parse\n";
+        return 1;
+    }
+
+    std::optional<PerfCounters> counters;
+    if (perfCounters)
+        counters.emplace();
+
+    const auto startAllocations = getAllocationCounts();
     const auto startTime = std::chrono::steady_clock::now();
+    if (counters)
+        counters->start();
     std::string_view content;
     IdentityHandler handler;
-    XMLParser parser(content, handler);
+    ParseProfile parseProfile;
+    long totalBytes = 0;
+    if (tapeFilename) {
+        // replay the events of the tape
+        TapeReplayer tape(tapeFilename);
+        tape.replay(handler);
+        totalBytes = tape.getTotalBytes();
+    } else if (pushSize) {
+        PushXMLParser parser(handler);
+        parser.setValidateUTF8(validateUTF8);
+        parser.setCheckWellFormed(checkWellFormed);
+        if (profile)
+            parser.setProfile(&parseProfile);
+
+        // push the input to the parser as it is read
+        std::vector<char> buffer(pushSize);
+        ssize_t bytesRead = 0;
+        while ((bytesRead = READ(STDIN_FILENO, buffer.data(), buffer.size())) > 0)
+            parser.feed(std::string_view(buffer.data(), bytesRead));
+        if (bytesRead < 0) {
+            std::cerr << "parser error : File input error\n";
+            return 1;
+        }
+        parser.finish();
+        totalBytes = parser.getTotalBytes();
+    } else {
+        XMLParser parser(content, handler);
+        parser.setValidateUTF8(validateUTF8);
+        parser.setCheckWellFormed(checkWellFormed);
+        if (profile)
+            parser.setProfile(&parseProfile);
 
-    // parse XML
-    parser.parse();
+        // parse XML
+        parser.parse();
+        totalBytes = parser.getTotalBytes();
+    }
 
+    if (counters)
+        counters->stop("Parse"sv, totalBytes);
     const auto finishTime = std::chrono::steady_clock::now();
+    const auto finishAllocations = getAllocationCounts();
     const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
     const auto MLOCPerSecond = handler.getLoc() / elapsedSeconds / 1000000;
     std::clog.imbue(std::locale{""});
     std::clog.precision(3);
     std::clog << '\n';
-    std::clog << parser.getTotalBytes()  << " bytes\n";
+    std::clog << totalBytes  << " bytes\n";
     std::clog << elapsedSeconds << " sec\n";
     std::clog << MLOCPerSecond << " MLOC/sec\n";
+    if (profile)
+        parseProfile.report(std::clog);
+    if (counters)
+        counters->report(std::clog);
+    if (memory)
+        reportMemory(std::clog, { finishAllocations.count - startAllocations.count, finishAllocations.bytes - startAllocations.bytes }, totalBytes);
 
     return 0;
 }
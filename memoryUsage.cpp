@@ -0,0 +1,138 @@
+/*
+    memoryUsage.cpp
+
+    Implementation file for the getAllocationCounts, getPeakRSS, and reportMemory
+    functions, and the counting global operator new with COUNT_ALLOCATIONS
+*/
+
+#include "memoryUsage.hpp"
+#include "refillContent.hpp"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <iomanip>
+
+#if !defined(_MSC_VER)
+#include <sys/resource.h>
+#endif
+
+#ifdef COUNT_ALLOCATIONS
+// number and bytes of heap allocations, from any thread
+static std::atomic<long> allocationCount{0};
+static std::atomic<long> allocationBytes{0};
+
+// allocate, counting the allocation
+static void* countedAllocate(std::size_t size) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(static_cast<long>(size), std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+// global operator new and delete, with the allocations counted
+void* operator new(std::size_t size) {
+    if (void* p = countedAllocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* p = countedAllocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+#endif
+
+/*
+    The heap allocations since the start of the application.
+
+    @return Number and bytes of the allocations
+*/
+[[nodiscard]] AllocationCounts getAllocationCounts() {
+#ifdef COUNT_ALLOCATIONS
+    return { allocationCount.load(std::memory_order_relaxed), allocationBytes.load(std::memory_order_relaxed) };
+#else
+    return { 0, 0 };
+#endif
+}
+
+/*
+    The peak resident set size of the application.
+
+    @return Peak RSS in bytes, or -1 if not available
+*/
+[[nodiscard]] long getPeakRSS() {
+#if !defined(_MSC_VER)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#if defined(__APPLE__)
+    // macOS reports bytes
+    return static_cast<long>(usage.ru_maxrss);
+#else
+    // Linux reports kilobytes
+    return static_cast<long>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return -1;
+#endif
+}
+
+/*
+    Output the markdown table of the memory usage.
+
+    This is the peak RSS, the high-water mark of the parser input buffer, the
+    largest partial token held in the buffer during a refill, and the heap
+    allocations of the parse when they are counted.
+
+    @param[in, out] out Output stream
+    @param[in] parseAllocations Heap allocations during the parse
+    @param[in] totalBytes Size of the input, for the allocations per MB
+*/
+void reportMemory(std::ostream& out, AllocationCounts parseAllocations, long totalBytes) {
+
+    const auto megabytes = totalBytes / 1e6;
+    out << "\n# Memory\n";
+    out << "| Measure                   |            Value |\n";
+    out << "|:--------------------------|-----------------:|\n";
+    out << "| Peak RSS bytes            | " << std::setw(16) << getPeakRSS() << " |\n";
+    out << "| Input buffer high-water   | " << std::setw(16) << getRefillHighWater() << " |\n";
+    out << "| Largest buffered token    | " << std::setw(16) << getRefillMaxPreserved() << " |\n";
+    if (!allocationsCounted)
+        return;
+    out << "| Parse heap allocations    | " << std::setw(16) << parseAllocations.count << " |\n";
+    out << "| Parse heap bytes          | " << std::setw(16) << parseAllocations.bytes << " |\n";
+    out << "| Parse allocations per MB  | " << std::setw(16) << std::fixed << std::setprecision(2)
+        << (megabytes > 0 ? parseAllocations.count / megabytes : 0) << " |\n" << std::defaultfloat;
+}
@@ -0,0 +1,59 @@
+/*
+    memoryUsage.hpp
+
+    Include file for the getAllocationCounts, getPeakRSS, and reportMemory functions
+
+    When compiled with COUNT_ALLOCATIONS, an application linked with
+    memoryUsage.cpp counts every heap allocation with the global operator new,
+    e.g., of std::string and std::vector, so the allocations of a phase, e.g.,
+    a parse, are the difference of the counts before and after it. Allocations
+    with malloc(), e.g., by zlib, and over-aligned allocations are not counted.
+    Without it, the global operator new is not replaced, and the counts are 0.
+*/
+
+#ifndef INCLUDED_MEMORYUSAGE_HPP
+#define INCLUDED_MEMORYUSAGE_HPP
+
+#include <ostream>
+
+// heap allocations are counted by the global operator new
+#ifdef COUNT_ALLOCATIONS
+inline constexpr bool allocationsCounted = true;
+#else
+inline constexpr bool allocationsCounted = false;
+#endif
+
+// number and bytes of heap allocations
+struct AllocationCounts {
+    long count;
+    long bytes;
+};
+
+/*
+    The heap allocations since the start of the application.
+
+    @return Number and bytes of the allocations
+*/
+[[nodiscard]] AllocationCounts getAllocationCounts();
+
+/*
+    The peak resident set size of the application.
+
+    @return Peak RSS in bytes, or -1 if not available
+*/
+[[nodiscard]] long getPeakRSS();
+
+/*
+    Output the markdown table of the memory usage.
+
+    This is the peak RSS, the high-water mark of the parser input buffer, the
+    largest partial token held in the buffer during a refill, and the heap
+    allocations of the parse when they are counted.
+
+    @param[in, out] out Output stream
+    @param[in] parseAllocations Heap allocations during the parse
+    @param[in] totalBytes Size of the input, for the allocations per MB
+*/
+void reportMemory(std::ostream& out, AllocationCounts parseAllocations, long totalBytes);
+
+#endif
@@ -0,0 +1,115 @@
+/*
+    parseParallel.hpp
+
+    Parses a srcML archive from standard input with multiple threads.
+
+    The calling thread reads the input and cuts it into chunks of complete
+    units (see UnitChunker). Worker threads parse the units of the chunks, each
+    with its own handler. The queue of chunks has a fixed number of chunks, so
+    the reading waits when the workers fall behind, and the memory is bounded
+    by the number of chunks no matter the size of the input. At the end, the
+    envelope, the document without the units, is parsed into the handler, and
+    the handlers of the workers are merged into it. For a single unit, the
+    envelope is the whole document, and its content is parsed speculatively
+    in parallel (see parseSpeculative).
+
+    The Handler is default constructible and has merge(Handler&), e.g., srcFactsHandler.
+*/
+
+#ifndef PARSEPARALLEL_HPP
+#define PARSEPARALLEL_HPP
+
+#include "UnitChunker.hpp"
+#include "parseSpeculative.hpp"
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+// size of the units in a chunk before it is queued
+const std::size_t PARALLEL_CHUNK_SIZE = 1024 * 1024;
+
+// parse the srcML archive on standard input with the number of threads,
+// with at most maxChunks chunks in the queue
+// @return Number of bytes parsed
+template <class Parser, class Handler>
+long parseParallel(Handler& handler, int threadCount, std::size_t maxChunks, bool validateUTF8, bool checkWellFormed) {
+
+    // parse the content in memory into the handler, with the offset in the document of its start
+    const auto parseContent = [validateUTF8, checkWellFormed](std::string_view content, long offset, Handler& contentHandler) {
+        Parser parser(content, contentHandler);
+        parser.setValidateUTF8(validateUTF8);
+        parser.setCheckWellFormed(checkWellFormed);
+        parser.setBaseOffset(offset);
+        parser.parse();
+    };
+
+    std::deque<UnitChunk> queue;
+    bool endOfInput = false;
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    // workers parse each unit of a chunk separately
+    std::vector<Handler> handlers(threadCount);
+    std::vector<std::thread> workers;
+    for (auto& workerHandler : handlers) {
+        workers.emplace_back([&, &workerHandler = workerHandler]() {
+            while (true) {
+                UnitChunk chunk;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&]() { return !queue.empty() || endOfInput; });
+                    if (queue.empty())
+                        return;
+                    chunk = std::move(queue.front());
+                    queue.pop_front();
+                }
+                changed.notify_all();
+                const std::string_view content(chunk.content);
+                for (const auto& unit : chunk.units)
+                    parseContent(content.substr(unit.offset, unit.length), chunk.offset + static_cast<long>(unit.offset), workerHandler);
+            }
+        });
+    }
+
+    // read the input into chunks for the workers
+    UnitChunker chunker(PARALLEL_CHUNK_SIZE);
+    UnitChunk chunk;
+    bool foundUnits = false;
+    while (chunker.next(chunk)) {
+        foundUnits = true;
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return queue.size() < maxChunks; });
+        queue.push_back(std::move(chunk));
+        lock.unlock();
+        changed.notify_all();
+        chunk = UnitChunk();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        endOfInput = true;
+    }
+    changed.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+
+    // the envelope has the XML declaration and the root unit, so it is parsed first
+    // The checks of a unit report byte offsets in the document. The envelope is
+    // the document without the units, so its offsets are in the document only up
+    // to the first unit, e.g., the root start tag, and in the envelope after it.
+    // The envelope of an archive is only the content between the units, so only
+    // a single unit is parsed speculatively
+    if (validateUTF8 || checkWellFormed || foundUnits)
+        parseContent(chunker.getEnvelope(), 0, handler);
+    else
+        parseSpeculative<Parser>(chunker.getEnvelope(), handler, threadCount);
+    for (auto& workerHandler : handlers)
+        handler.merge(workerHandler);
+
+    return chunker.getTotalBytes();
+}
+
+#endif
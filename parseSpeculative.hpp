@@ -0,0 +1,112 @@
+/*
+    parseSpeculative.hpp
+
+    Parses a single srcML document in memory with multiple threads, e.g., one
+    very large unit from a generated or amalgamated source file.
+
+    The content of the root unit is split at arbitrary offsets, resynced to the
+    next start tag (see splitAtTags). The split is speculative, since a tag
+    start may be in a comment, CDATA, or processing instruction. First, the
+    chunks are scanned in parallel for these. Then the chunks are parsed in
+    parallel as fragments, each with its own handler and a depth relative to
+    the start of the chunk. The depths are stitched together: the depth of a
+    chunk starts at the end depth of the chunks before it, and must not drop
+    below the root before the end. When the speculation fails, the document is
+    parsed again sequentially, so the result, or the error, is the same as a
+    sequential parse.
+
+    The Handler is default constructible and has merge(Handler&), e.g., srcFactsHandler.
+*/
+
+#ifndef PARSESPECULATIVE_HPP
+#define PARSESPECULATIVE_HPP
+
+#include "findUnits.hpp"
+#include "splitAtTags.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+
+// minimum size of the content of a speculative chunk
+const std::size_t SPECULATIVE_CHUNK_SIZE = 1024 * 1024;
+
+// parse the srcML document in memory into the handler, with the content of the
+// root unit split among the number of threads
+// @return Whether the document was parsed in parallel, instead of sequentially
+template <class Parser, class Handler>
+bool parseSpeculative(std::string_view document, Handler& handler, int threadCount) {
+
+    // sequential parse of the whole document, i.e., for a small root or a failed speculation
+    const auto parseDocument = [document, &handler]() {
+        Parser parser(document, handler);
+        parser.parse();
+    };
+
+    const auto root = findRootContent(document);
+    const auto content = document.substr(root.offset, root.length);
+    if (threadCount < 2 || content.size() < 2 * SPECULATIVE_CHUNK_SIZE) {
+        parseDocument();
+        return false;
+    }
+    const auto chunkCount = std::min<std::size_t>(threadCount, content.size() / SPECULATIVE_CHUNK_SIZE);
+    const auto chunks = splitAtTags(content, chunkCount);
+
+    // process each chunk on its own thread
+    const auto forEachChunk = [&chunks](auto process) {
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < chunks.size(); ++i)
+            threads.emplace_back(process, i);
+        process(0);
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    // a chunk that ends inside a comment, CDATA, or processing instruction
+    // means that the next chunk does not start at a tag
+    std::vector<char> insideMarkup(chunks.size());
+    forEachChunk([&](std::size_t i) {
+        insideMarkup[i] = endsInsideMarkup(content.substr(chunks[i].offset, chunks[i].length));
+    });
+    if (std::any_of(insideMarkup.begin(), insideMarkup.end(), [](char inside) { return inside; })) {
+        parseDocument();
+        return false;
+    }
+
+    // parse the chunks as fragments with relative depths
+    std::vector<Handler> handlers(chunks.size());
+    std::vector<int> depths(chunks.size());
+    std::vector<int> minDepths(chunks.size());
+    forEachChunk([&](std::size_t i) {
+        Parser parser(content.substr(chunks[i].offset, chunks[i].length), handlers[i]);
+        parser.parseFragment();
+        depths[i] = parser.getFragmentDepth();
+        minDepths[i] = parser.getFragmentMinDepth();
+    });
+
+    // stitch the depths, with the root element closed only by its end tag
+    int depth = 0;
+    bool balanced = true;
+    for (std::size_t i = 0; i < chunks.size() && balanced; ++i) {
+        balanced = depth + minDepths[i] >= 0;
+        depth += depths[i];
+    }
+    if (!balanced || depth != 0) {
+        parseDocument();
+        return false;
+    }
+
+    // the document without the content of the root unit has the XML declaration and the root unit tags
+    std::string envelope(document.substr(0, root.offset));
+    envelope += document.substr(root.offset + root.length);
+    Parser parser(envelope, handler);
+    parser.parse();
+    for (auto& chunkHandler : handlers)
+        handler.merge(chunkHandler);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+    partialResult.cpp
+
+    Implementation file for partial results.
+*/
+
+#include "partialResult.hpp"
+#include "JSONReader.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // hash from its hex string
+    std::uint64_t readHash(const std::string& value, JSONReader& reader) {
+        if (value.size() != 16 || value.find_first_not_of("0123456789abcdef") != value.npos)
+            reader.error("Invalid archive hash");
+        return std::stoull(value, nullptr, 16);
+    }
+}
+
+// write the partial result as JSON
+void writePartialResult(std::ostream& out, const PartialResult& partial) {
+    out << "{\"format\":";
+    writeJSONString(out, partial.tool + "-partial");
+    out << ",\"version\":" << PARTIAL_RESULT_VERSION;
+    out << ",\"tool\":";
+    writeJSONString(out, partial.tool);
+    out << ",\"url\":";
+    writeJSONString(out, partial.url);
+    out << ",\"totalBytes\":" << partial.totalBytes;
+    if (partial.shardCount > 0) {
+        out << ",\"shardBegin\":" << partial.shardBegin;
+        out << ",\"shardEnd\":" << partial.shardEnd;
+        out << ",\"shardCount\":" << partial.shardCount;
+        out << ",\"archiveSize\":" << partial.archiveSize;
+
+        // the hash is unsigned 64 bits, so it is a hex string, not a JSON number
+        std::ostringstream hash;
+        hash << std::hex << std::setw(16) << std::setfill('0') << partial.archiveHash;
+        out << ",\"archiveHash\":";
+        writeJSONString(out, hash.str());
+    }
+    out << ",\"counts\":{";
+    bool first = true;
+    for (const auto& [name, count] : partial.counts) {
+        if (!first)
+            out << ',';
+        first = false;
+        writeJSONString(out, name);
+        out << ':' << count;
+    }
+    out << "}}\n";
+}
+
+// read the partial result from the JSON file
+// Errors in the file are reported, and exit
+PartialResult readPartialResult(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "partial error : Unable to open " << filename << '\n';
+        exit(1);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const auto content = buffer.str();
+
+    JSONReader reader(content, filename, "partial"sv);
+    PartialResult partial;
+    std::string format;
+    long version = 0;
+    reader.expect('{');
+    do {
+        const auto key = reader.readString();
+        reader.expect(':');
+        if (key == "counts"sv) {
+            reader.expect('{');
+            if (!reader.accept('}')) {
+                do {
+                    auto name = reader.readString();
+                    reader.expect(':');
+                    partial.counts[std::move(name)] = reader.readInteger();
+                } while (reader.accept(','));
+                reader.expect('}');
+            }
+        } else if (reader.isString()) {
+            const auto value = reader.readString();
+            if (key == "format"sv)
+                format = value;
+            else if (key == "tool"sv)
+                partial.tool = value;
+            else if (key == "url"sv)
+                partial.url = value;
+            else if (key == "archiveHash"sv)
+                partial.archiveHash = readHash(value, reader);
+        } else {
+            const auto value = reader.readInteger();
+            if (key == "version"sv)
+                version = value;
+            else if (key == "totalBytes"sv)
+                partial.totalBytes = value;
+            else if (key == "shardBegin"sv)
+                partial.shardBegin = static_cast<int>(value);
+            else if (key == "shardEnd"sv)
+                partial.shardEnd = static_cast<int>(value);
+            else if (key == "shardCount"sv)
+                partial.shardCount = static_cast<int>(value);
+            else if (key == "archiveSize"sv)
+                partial.archiveSize = value;
+        }
+    } while (reader.accept(','));
+    reader.expect('}');
+    if (!reader.atEnd())
+        reader.error("Extra content after the partial result");
+
+    if (partial.tool.empty() || format != partial.tool + "-partial")
+        reader.error("Not a partial result");
+    if (version != PARTIAL_RESULT_VERSION)
+        reader.error("Unsupported partial result version " + std::to_string(version));
+    if (partial.shardCount < 0 || (partial.shardCount > 0
+        && (partial.shardBegin < 0 || partial.shardBegin >= partial.shardEnd || partial.shardEnd > partial.shardCount)))
+        reader.error("Invalid shard range");
+
+    return partial;
+}
@@ -0,0 +1,96 @@
+/*
+    partialResult.hpp
+
+    Header file for partial results, the counts of a handler over part of the
+    input, e.g., a shard of the units of a srcML archive.
+
+    Partial results are stored as a single JSON object, so they can be summed
+    by srcmerge into the report of the whole input:
+
+    {"format":"srcfacts-partial","version":3,"tool":"srcfacts","url":"...",
+     "totalBytes":1234,"shardBegin":0,"shardEnd":1,"shardCount":2,
+     "archiveSize":5678,"archiveHash":"0123456789abcdef","counts":{"textSize":100,"loc":10,...}}
+
+    The counts are named by the COUNT_NAMES of the handler. Unknown names are
+    kept, so a newer count does not break the merge of older partial results.
+
+    A partial result of the shards of a srcML archive has the range of its shards,
+    and the size and hash of the archive, so that the shards of a merge are
+    checked to be of the same archive, without a missing or duplicate shard. A
+    partial result of other input has a shard count of 0, and no archive.
+*/
+
+#ifndef PARTIALRESULT_HPP
+#define PARTIALRESULT_HPP
+
+#include <string>
+#include <string_view>
+#include <map>
+#include <ostream>
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+
+// version of the partial result format
+const int PARTIAL_RESULT_VERSION = 3;
+
+struct PartialResult {
+    // application that produced the counts, e.g., "srcfacts" or "xmlstats"
+    std::string tool;
+
+    // url of the root unit, if any
+    std::string url;
+
+    // bytes of the input in this part
+    long totalBytes = 0;
+
+    // range of the shards of the srcML archive, from shardBegin up to shardEnd of shardCount,
+    // or a shardCount of 0 when the input is not sharded
+    int shardBegin = 0;
+    int shardEnd = 0;
+    int shardCount = 0;
+
+    // size and hash of the whole srcML archive of the shards
+    long archiveSize = 0;
+    std::uint64_t archiveHash = 0;
+
+    // counts by name
+    std::map<std::string, long> counts;
+};
+
+// write the partial result as JSON
+void writePartialResult(std::ostream& out, const PartialResult& partial);
+
+// read the partial result from the JSON file
+// Errors in the file are reported, and exit
+PartialResult readPartialResult(const std::string& filename);
+
+// partial result with the counts of the handler
+template <class Handler>
+PartialResult makePartialResult(std::string_view tool, std::string_view url, long totalBytes, Handler& handler) {
+    PartialResult partial;
+    partial.tool = tool;
+    partial.url = url;
+    partial.totalBytes = totalBytes;
+    const auto counts = handler.getCounts();
+    for (std::size_t i = 0; i < counts.size(); ++i)
+        partial.counts[std::string(Handler::COUNT_NAMES[i])] = counts[i];
+    return partial;
+}
+
+// add the counts of the partial result to the handler
+template <class Handler>
+void addPartialResult(const PartialResult& partial, Handler& handler) {
+    typename Handler::Counts counts{};
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        const auto count = partial.counts.find(std::string(Handler::COUNT_NAMES[i]));
+        if (count == partial.counts.end()) {
+            std::cerr << "partial error : Missing count " << Handler::COUNT_NAMES[i] << '\n';
+            exit(1);
+        }
+        counts[i] = static_cast<int>(count->second);
+    }
+    handler.addCounts(counts);
+}
+
+#endif
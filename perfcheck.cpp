@@ -0,0 +1,407 @@
+/*
+    perfcheck.cpp
+
+    Performance regression check of the applications of a build directory.
+
+    perfcheck [--runs N] [--size MB] [--threshold PERCENT] [--machine CLASS]
+              [--baseline FILE] [--write-baseline] [--allow-missing-baseline]
+              builddir [builddir]
+
+    Each workload is a fixed run of srcfacts, xmlstats, or identity on a
+    synthetic srcML archive made from copies of data/demo.xml of the build
+    directory, or on demo.xml itself. Each workload runs N times after a
+    warm-up run, and the time of a run is the user and system CPU time of its
+    process, which varies less than the elapsed time on a shared machine. The
+    statistics are the median and the median absolute deviation (MAD), so a few
+    slow runs do not move them.
+
+    With one build directory, the medians are compared to the baseline of the
+    machine class, by default perfbaseline-<machine>-<cpus>cpu.json in the
+    current directory. With two build directories, the runs of the two
+    alternate, and the second, e.g., with a patch, is compared to the first.
+    A workload is a regression when its median is slower by more than the
+    threshold percent, and by more than three times the combined MAD, so the
+    noise of the runs is not a regression. Any regression is an exit status of 1.
+
+    A missing baseline is an error, so a machine class without a baseline does
+    not pass the check unchecked, unless the option --allow-missing-baseline
+    only reports the runs. A baseline of another machine class or size of the
+    synthetic archive is an error, as its times are not comparable.
+
+    With the option --write-baseline, the results of the build directory are
+    written as the baseline instead.
+
+    The baseline is a JSON object of the machine class, the bytes of the synthetic
+    archive, and the median and MAD of each workload in microseconds:
+
+    {"format":"perfcheck-baseline","version":1,"machine":"x86_64-8cpu","archiveBytes":20042751,
+     "workloads":{"srcfacts":{"medianMicroseconds":1234,"madMicroseconds":12},...}}
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include "JSONReader.hpp"
+#include "syntheticArchive.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // workload of the check, an application with options on an input
+    struct Workload {
+        std::string_view name;
+        std::string_view program;
+        std::vector<std::string_view> options;
+        bool synthetic;
+    };
+
+    // workloads of the check, in the order of the report
+    const Workload WORKLOADS[] = {
+        { "srcfacts"sv,           "srcfacts"sv, {},                                 true  },
+        { "srcfacts-full"sv,      "srcfacts"sv, { "--full"sv },                     true  },
+        { "srcfacts-wellformed"sv,"srcfacts"sv, { "--wellformed"sv },               true  },
+        { "srcfacts-utf8"sv,      "srcfacts"sv, { "--validate-utf8"sv },            true  },
+        { "xmlstats"sv,           "xmlstats"sv, {},                                 true  },
+        { "identity"sv,           "identity"sv, {},                                 true  },
+        { "srcfacts-demo"sv,      "srcfacts"sv, {},                                 false },
+    };
+
+    // statistics of the runs of a workload, in seconds
+    struct Statistics {
+        double median;
+        double mad;
+    };
+
+    // version of the baseline format
+    const int BASELINE_VERSION = 1;
+
+    // baseline of a machine class, with the statistics of each workload by name
+    struct Baseline {
+        std::string machine;
+        long archiveBytes = 0;
+        std::map<std::string, Statistics> workloads;
+    };
+
+    // write the baseline as JSON
+    void writeBaseline(std::ostream& out, const Baseline& baseline) {
+        out << "{\"format\":\"perfcheck-baseline\",\"version\":" << BASELINE_VERSION << ",\"machine\":";
+        writeJSONString(out, baseline.machine);
+        out << ",\"archiveBytes\":" << baseline.archiveBytes << ",\"workloads\":{";
+        bool first = true;
+        for (const auto& [name, workload] : baseline.workloads) {
+            if (!first)
+                out << ',';
+            first = false;
+            writeJSONString(out, name);
+            out << ":{\"medianMicroseconds\":" << std::lround(workload.median * 1e6)
+                << ",\"madMicroseconds\":" << std::lround(workload.mad * 1e6) << '}';
+        }
+        out << "}}\n";
+    }
+
+    // read the baseline from the JSON file
+    // Errors in the file are reported, and exit
+    Baseline readBaseline(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        const auto content = buffer.str();
+
+        JSONReader reader(content, filename, "baseline"sv);
+        Baseline baseline;
+        std::string format;
+        long version = 0;
+        reader.expect('{');
+        do {
+            const auto key = reader.readString();
+            reader.expect(':');
+            if (key == "workloads"sv) {
+                reader.expect('{');
+                if (!reader.accept('}')) {
+                    do {
+                        auto& workload = baseline.workloads[reader.readString()];
+                        reader.expect(':');
+                        reader.expect('{');
+                        do {
+                            const auto statistic = reader.readString();
+                            reader.expect(':');
+                            const auto microseconds = reader.readInteger() / 1e6;
+                            if (statistic == "medianMicroseconds"sv)
+                                workload.median = microseconds;
+                            else if (statistic == "madMicroseconds"sv)
+                                workload.mad = microseconds;
+                        } while (reader.accept(','));
+                        reader.expect('}');
+                    } while (reader.accept(','));
+                    reader.expect('}');
+                }
+            } else if (reader.isString()) {
+                const auto value = reader.readString();
+                if (key == "format"sv)
+                    format = value;
+                else if (key == "machine"sv)
+                    baseline.machine = value;
+            } else {
+                const auto value = reader.readInteger();
+                if (key == "version"sv)
+                    version = value;
+                else if (key == "archiveBytes"sv)
+                    baseline.archiveBytes = value;
+            }
+        } while (reader.accept(','));
+        reader.expect('}');
+        if (!reader.atEnd())
+            reader.error("Extra content after the baseline");
+        if (format != "perfcheck-baseline"sv)
+            reader.error("Not a perfcheck baseline");
+        if (version != BASELINE_VERSION)
+            reader.error("Unsupported baseline version " + std::to_string(version));
+
+        return baseline;
+    }
+
+    // median of the values
+    double median(std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        const auto middle = values.size() / 2;
+        return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+    }
+
+    // median and median absolute deviation of the times
+    Statistics statistics(const std::vector<double>& times) {
+        const auto center = median(times);
+        std::vector<double> deviations;
+        for (const auto time : times)
+            deviations.push_back(std::fabs(time - center));
+        return { center, median(deviations) };
+    }
+
+    // run the workload of the build directory, and return the CPU time of its process
+    double runWorkload(const Workload& workload, const std::string& builddir, const std::string& input) {
+        const auto program = builddir + '/' + std::string(workload.program);
+        std::vector<std::string> arguments{ program };
+        for (const auto option : workload.options)
+            arguments.emplace_back(option);
+        std::vector<char*> argv;
+        for (auto& argument : arguments)
+            argv.push_back(argument.data());
+        argv.push_back(nullptr);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, input.c_str(), O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        pid_t pid;
+        if (posix_spawn(&pid, program.c_str(), &actions, nullptr, argv.data(), environ) != 0) {
+            std::cerr << "perfcheck: Unable to run " << program << '\n';
+            exit(1);
+        }
+        posix_spawn_file_actions_destroy(&actions);
+
+        int status;
+        rusage usage;
+        if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "perfcheck: Failed run of " << workload.name << " in " << builddir << '\n';
+            exit(1);
+        }
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    // machine class, the machine architecture and number of CPUs, e.g., x86_64-8cpu
+    std::string machineClass() {
+        utsname name;
+        const std::string machine = uname(&name) == 0 ? name.machine : "unknown";
+        return machine + '-' + std::to_string(std::thread::hardware_concurrency()) + "cpu";
+    }
+
+    // file exists
+    bool exists(const std::string& filename) {
+        return std::ifstream(filename).good();
+    }
+
+    // regression when slower by more than the threshold percent and more than the noise
+    bool isRegression(const Statistics& base, const Statistics& current, double threshold) {
+        const auto difference = current.median - base.median;
+        return difference > base.median * threshold / 100 && difference > 3 * (base.mad + current.mad);
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    int runCount = 11;
+    long sizeMB = 20;
+    double threshold = 10;
+    std::string machine = machineClass();
+    std::string baselineFilename;
+    bool writingBaseline = false;
+    bool allowMissingBaseline = false;
+    std::vector<std::string> builddirs;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runCount = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            sizeMB = std::stol(argv[++i]);
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = std::stod(argv[++i]);
+        } else if (strcmp(argv[i], "--machine") == 0 && i + 1 < argc) {
+            machine = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselineFilename = argv[++i];
+        } else if (strcmp(argv[i], "--write-baseline") == 0) {
+            writingBaseline = true;
+        } else if (strcmp(argv[i], "--allow-missing-baseline") == 0) {
+            allowMissingBaseline = true;
+        } else if (argv[i][0] != '-') {
+            builddirs.emplace_back(argv[i]);
+        } else {
+            std::cerr << "perfcheck: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (builddirs.empty() || builddirs.size() > 2 || runCount < 1 || sizeMB < 1) {
+        std::cerr << "perfcheck: Usage: perfcheck [--runs N] [--size MB] [--threshold PERCENT] [--machine CLASS]\n"
+                     "                 [--baseline FILE] [--write-baseline] [--allow-missing-baseline]\n"
+                     "                 builddir [builddir]\n";
+        return 1;
+    }
+    if (baselineFilename.empty())
+        baselineFilename = "perfbaseline-" + machine + ".json";
+
+    // without a baseline, the check of a single build directory has nothing to compare to
+    const bool checkingBaseline = builddirs.size() == 1 && !writingBaseline;
+    if (checkingBaseline && !exists(baselineFilename) && !allowMissingBaseline) {
+        std::cerr << "perfcheck: No baseline " << baselineFilename << " for machine class " << machine
+                  << ", write one with --write-baseline, or run with --allow-missing-baseline\n";
+        return 1;
+    }
+
+    // synthetic archive of the demo file of the first build directory
+    const auto demoFilename = builddirs.front() + "/data/demo.xml";
+    std::ifstream demoFile(demoFilename, std::ios::binary);
+    if (!demoFile) {
+        std::cerr << "perfcheck: Unable to open " << demoFilename << '\n';
+        return 1;
+    }
+    std::stringstream buffer;
+    buffer << demoFile.rdbuf();
+    const auto demo = buffer.str();
+    const auto archive = syntheticArchive(demo, sizeMB * 1000000);
+    const auto archiveFilename = builddirs.front() + "/perfcheck.xml";
+    std::ofstream(archiveFilename, std::ios::binary) << archive;
+
+    // runs of each workload, alternating between the build directories
+    std::cerr << "perfcheck: " << runCount << " runs of " << std::size(WORKLOADS) << " workloads on " << archive.size() << " bytes\n";
+    std::vector<std::vector<Statistics>> results(builddirs.size());
+    for (const auto& workload : WORKLOADS) {
+        const auto& input = workload.synthetic ? archiveFilename : demoFilename;
+        std::vector<std::vector<double>> times(builddirs.size());
+
+        // warm-up run of each, for the page cache
+        for (const auto& builddir : builddirs)
+            runWorkload(workload, builddir, input);
+
+        // the order of the build directories alternates, so neither is always first
+        for (int run = 0; run < runCount; ++run) {
+            for (std::size_t i = 0; i < builddirs.size(); ++i) {
+                const auto build = run % 2 ? builddirs.size() - 1 - i : i;
+                times[build].push_back(runWorkload(workload, builddirs[build], input));
+            }
+        }
+        for (std::size_t build = 0; build < builddirs.size(); ++build)
+            results[build].push_back(statistics(times[build]));
+    }
+
+    // write the results of the build directory as the baseline
+    if (writingBaseline) {
+        Baseline baseline;
+        baseline.machine = machine;
+        baseline.archiveBytes = static_cast<long>(archive.size());
+        for (std::size_t i = 0; i < std::size(WORKLOADS); ++i)
+            baseline.workloads[std::string(WORKLOADS[i].name)] = results.back()[i];
+        std::ofstream out(baselineFilename);
+        writeBaseline(out, baseline);
+        std::cerr << "perfcheck: Wrote baseline for " << machine << " to " << baselineFilename << '\n';
+    }
+
+    // the first build directory is the base of the comparison, otherwise the baseline
+    std::vector<Statistics> base;
+    std::string baseName = builddirs.front();
+    if (builddirs.size() == 2) {
+        base = results.front();
+    } else if (checkingBaseline && exists(baselineFilename)) {
+        // the times of another machine class, or of another input, are not comparable
+        const auto baseline = readBaseline(baselineFilename);
+        if (baseline.machine != machine) {
+            std::cerr << "perfcheck: Baseline " << baselineFilename << " is for machine class " << baseline.machine << ", not " << machine << '\n';
+            return 1;
+        }
+        if (baseline.archiveBytes != static_cast<long>(archive.size())) {
+            std::cerr << "perfcheck: Baseline " << baselineFilename << " is for " << baseline.archiveBytes << " bytes, not " << archive.size() << '\n';
+            return 1;
+        }
+        for (const auto& workload : WORKLOADS) {
+            const auto found = baseline.workloads.find(std::string(workload.name));
+            if (found == baseline.workloads.end()) {
+                std::cerr << "perfcheck: Baseline " << baselineFilename << " has no workload " << workload.name << '\n';
+                return 1;
+            }
+            base.push_back(found->second);
+        }
+        baseName = baselineFilename;
+    }
+
+    // report, with the comparison to the base
+    const auto& current = results.back();
+    std::cout << "# perfcheck " << builddirs.back() << '\n';
+    if (base.empty() && !writingBaseline)
+        std::cout << "No baseline " << baselineFilename << " for machine class " << machine << '\n';
+    else if (!base.empty())
+        std::cout << "Compared to " << baseName << ", threshold " << threshold << "%\n";
+    std::cout << "| Workload            |   Median ms |     MAD ms |     MB/sec |     Base ms | Change % | Status     |\n";
+    std::cout << "|:--------------------|------------:|-----------:|-----------:|------------:|---------:|:-----------|\n";
+    std::cout << std::fixed;
+    int regressionCount = 0;
+    for (std::size_t i = 0; i < std::size(WORKLOADS); ++i) {
+        const auto bytes = WORKLOADS[i].synthetic ? archive.size() : demo.size();
+        std::cout << "| " << std::setw(19) << std::left << WORKLOADS[i].name << std::right
+                  << " | " << std::setw(11) << std::setprecision(2) << current[i].median * 1000
+                  << " | " << std::setw(10) << current[i].mad * 1000
+                  << " | " << std::setw(10) << std::setprecision(1) << (current[i].median > 0 ? bytes / 1e6 / current[i].median : 0);
+        if (base.empty() || base[i].median == 0) {
+            std::cout << " | " << std::setw(11) << "" << " | " << std::setw(8) << "" << " | " << std::setw(10) << std::left << "" << std::right << " |\n";
+            continue;
+        }
+        const auto change = 100 * (current[i].median - base[i].median) / base[i].median;
+        const auto regression = isRegression(base[i], current[i], threshold);
+        const auto improvement = isRegression(current[i], base[i], threshold);
+        regressionCount += regression;
+        std::cout << " | " << std::setw(11) << std::setprecision(2) << base[i].median * 1000
+                  << " | " << std::setw(8) << std::setprecision(1) << std::showpos << change << std::noshowpos
+                  << " | " << std::setw(10) << std::left << (regression ? "REGRESSION" : improvement ? "faster" : "ok") << std::right << " |\n";
+    }
+
+    if (regressionCount) {
+        std::cerr << "perfcheck: " << regressionCount << " workloads slower than " << baseName << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -5,6 +5,10 @@
 */
 
 #include "refillContent.hpp"
+#include "xml_parser.hpp"
+#include "Decompressor.hpp"
+#include <algorithm>
+#include <memory>
 #include <errno.h>
 #include <sys/types.h>
 
@@ -22,9 +26,28 @@ typedef SSIZE_T ssize_t;
 const int BLOCK_SIZE = 4096;
 const int BUFFER_SIZE = 16 * 16 * BLOCK_SIZE;
 
+// largest content after a refill, and largest unprocessed content preserved by a refill
+static std::size_t highWater = 0;
+static std::size_t maxPreserved = 0;
+
+// buffer of the size with zeroed padding after it
+// Only the padding is initialized, as the content is read into the buffer
+static std::unique_ptr<char[]> allocateBuffer(std::size_t size) {
+    std::unique_ptr<char[]> buffer(new char[size + xml_parser::PADDING]);
+    std::fill_n(buffer.get() + size, xml_parser::PADDING, '\0');
+    return buffer;
+}
+
 /*
     Refill the content preserving the existing data.
 
+    Compressed input, gzip, zip, or zstd, is detected on the first read and
+    decompressed on its own thread.
+
+    The buffer doubles when the unprocessed content leaves less than a block
+    free, e.g., a comment or start tag larger than the buffer, so a read of 0 bytes is only
+    at the end of the input.
+
     @param[in, out] content View of the content
     @return Number of bytes read
     @retval 0 EOF
@@ -33,23 +56,80 @@ const int BUFFER_SIZE = 16 * 16 * BLOCK_SIZE;
 [[nodiscard]] int refillContent(std::string_view& content) {
 
     // initialize the internal buffer at first use
-    static char buffer[BUFFER_SIZE];
+    // padding after the buffer allows fixed-size lookahead past the end of the content
+    static std::unique_ptr<char[]> buffer = allocateBuffer(BUFFER_SIZE);
+    static std::size_t bufferSize = BUFFER_SIZE;
 
-    // preserve prefix of unprocessed characters to start of the buffer
-    std::copy(content.cbegin(), content.cend(), buffer);
+    // decompression of compressed input, detected on the first read
+    static std::unique_ptr<Decompressor> decompressor;
+    static bool firstRead = true;
 
-    // read in multiple of whole blocks
+    // preserve prefix of unprocessed characters to start of the buffer, in a larger
+    // buffer when the unprocessed characters leave less than a block to read into
+    if (bufferSize - content.size() < BLOCK_SIZE) {
+        while (bufferSize - content.size() < BLOCK_SIZE)
+            bufferSize *= 2;
+        auto larger = allocateBuffer(bufferSize);
+        std::copy(content.cbegin(), content.cend(), larger.get());
+        buffer.swap(larger);
+    } else {
+        std::copy(content.cbegin(), content.cend(), buffer.get());
+    }
+    maxPreserved = std::max(maxPreserved, content.size());
+
+    // read in multiple of whole blocks, never past the end of the buffer
+    const auto readSize = std::min<std::size_t>(bufferSize - BLOCK_SIZE, (bufferSize - content.size()) / BLOCK_SIZE * BLOCK_SIZE);
+    char* const readStart = buffer.get() + content.size();
     ssize_t bytesRead = 0;
-    while (((bytesRead = READ(0, (buffer + content.size()),
-        BUFFER_SIZE - BLOCK_SIZE)) == -1) && (errno == EINTR)) {
+    if (decompressor) {
+        bytesRead = decompressor->read(readStart, readSize);
+    } else {
+        while (((bytesRead = READ(0, readStart,
+            readSize)) == -1) && (errno == EINTR)) {
+        }
     }
     if (bytesRead == -1) {
         // error in read
         return -1;
     }
 
+    // compressed input is decompressed on its own thread, starting with the bytes just read
+    if (firstRead) {
+        firstRead = false;
+        const std::string_view start(readStart, bytesRead);
+        const auto format = Decompressor::detect(start);
+        if (format != Decompressor::Format::NONE) {
+            decompressor = std::make_unique<Decompressor>(format, start, 0);
+            bytesRead = decompressor->read(readStart, readSize);
+            if (bytesRead == -1)
+                return -1;
+        }
+    }
+
     // set content to the start of the buffer
-    content = std::string_view(buffer, content.size() + bytesRead);
+    content = std::string_view(buffer.get(), content.size() + bytesRead);
+    highWater = std::max(highWater, content.size());
 
     return bytesRead;
 }
+
+/*
+    The high-water mark of the refill buffer, i.e., the largest content after a refill.
+
+    @return Size of the largest content in bytes, or 0 without any refill
+*/
+[[nodiscard]] std::size_t getRefillHighWater() {
+    return highWater;
+}
+
+/*
+    The largest unprocessed content preserved by a refill.
+
+    This is the largest partial token held in the buffer while more input is
+    read, e.g., a long comment that crosses a refill.
+
+    @return Size of the largest preserved content in bytes
+*/
+[[nodiscard]] std::size_t getRefillMaxPreserved() {
+    return maxPreserved;
+}
@@ -1,22 +1,47 @@
-/*
-    refillContent.hpp
-
-    Include file for the refillContent function
-*/
-
-#ifndef INCLUDED_REFILLCONTENT_HPP
-#define INCLUDED_REFILLCONTENT_HPP
-
-#include <string_view>
-
-/*
-    Refill the content preserving the existing data.
-
-    @param[in, out] content View of the content
-    @return Number of bytes read
-    @retval 0 EOF
-    @retval -1 Read error
-*/
-[[nodiscard]] int refillContent(std::string_view& content);
-
-#endif
+/*
+    refillContent.hpp
+
+    Include file for the refillContent, getRefillHighWater, and getRefillMaxPreserved functions
+*/
+
+#ifndef INCLUDED_REFILLCONTENT_HPP
+#define INCLUDED_REFILLCONTENT_HPP
+
+#include <string_view>
+#include <cstddef>
+
+/*
+    Refill the content preserving the existing data.
+
+    Compressed input, gzip, zip, or zstd, is detected on the first read and
+    decompressed on its own thread.
+
+    The buffer doubles when the unprocessed content leaves less than a block
+    free, e.g., a comment larger than the buffer, so a read of 0 bytes is only
+    at the end of the input.
+
+    @param[in, out] content View of the content
+    @return Number of bytes read
+    @retval 0 EOF
+    @retval -1 Read error
+*/
+[[nodiscard]] int refillContent(std::string_view& content);
+
+/*
+    The high-water mark of the refill buffer, i.e., the largest content after a refill.
+
+    @return Size of the largest content in bytes, or 0 without any refill
+*/
+[[nodiscard]] std::size_t getRefillHighWater();
+
+/*
+    The largest unprocessed content preserved by a refill.
+
+    This is the largest partial token held in the buffer while more input is
+    read, e.g., a long comment that crosses a refill.
+
+    @return Size of the largest preserved content in bytes
+*/
+[[nodiscard]] std::size_t getRefillMaxPreserved();
+
+#endif
@@ -0,0 +1,40 @@
+/*
+    reportFacts.cpp
+
+    Implementation file for the reportFacts function
+*/
+
+#include "reportFacts.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+/*
+    Output the markdown table of the facts to standard output.
+
+    @param[in] url Url of the root unit
+    @param[in] handler Handler with the facts
+    @param[in] totalBytes Size of the input, for the width of the values
+*/
+void reportFacts(std::string_view url, srcFactsHandler& handler, long totalBytes) {
+
+    // the files of the documents, or for counts without documents, e.g., of srcfactspull, of the units
+    const auto files = handler.getDocumentCount() > 0 ? handler.getFileCount() : std::max(handler.getUnitCount() - 1, 1);
+    std::cout.imbue(std::locale{""});
+    const auto valueWidth = std::max(5, static_cast<int>(log10(totalBytes) * 1.3 + 1));
+    std::cout << "# srcFacts: " << url << '\n';
+    std::cout << "| Measure      | " << std::setw(valueWidth + 3) << "Value |\n";
+    std::cout << "|:-------------|-" << std::setw(valueWidth + 3) << std::setfill('-') << ":|\n" << std::setfill(' ');
+    std::cout << "| Characters   | " << std::setw(valueWidth) << handler.getTextSize()        << " |\n";
+    std::cout << "| LOC          | " << std::setw(valueWidth) << handler.getLoc()             << " |\n";
+    std::cout << "| Files        | " << std::setw(valueWidth) << files                       << " |\n";
+    std::cout << "| Classes      | " << std::setw(valueWidth) << handler.getClassCount()      << " |\n";
+    std::cout << "| Functions    | " << std::setw(valueWidth) << handler.getFunctionCount()   << " |\n";
+    std::cout << "| Declarations | " << std::setw(valueWidth) << handler.getDeclCount()       << " |\n";
+    std::cout << "| Expressions  | " << std::setw(valueWidth) << handler.getExprCount()       << " |\n";
+    std::cout << "| Comments     | " << std::setw(valueWidth) << handler.getCommentCount()    << " |\n";
+    std::cout << "| Returns      | " << std::setw(valueWidth) << handler.getReturnCount()     << " |\n";
+    std::cout << "| Line Comments| " << std::setw(valueWidth) << handler.getLineCommentCount()<< " |\n";
+    std::cout << "| Strings      | " << std::setw(valueWidth) << handler.getStringCount()     << " |\n";
+}
@@ -0,0 +1,22 @@
+/*
+    reportFacts.hpp
+
+    Include file for the reportFacts function
+*/
+
+#ifndef INCLUDED_REPORTFACTS_HPP
+#define INCLUDED_REPORTFACTS_HPP
+
+#include "srcFactsHandler.hpp"
+#include <string_view>
+
+/*
+    Output the markdown table of the facts to standard output.
+
+    @param[in] url Url of the root unit
+    @param[in] handler Handler with the facts
+    @param[in] totalBytes Size of the input, for the width of the values
+*/
+void reportFacts(std::string_view url, srcFactsHandler& handler, long totalBytes);
+
+#endif
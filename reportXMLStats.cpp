@@ -0,0 +1,37 @@
+/*
+    reportXMLStats.cpp
+
+    Implementation file for the reportXMLStats function
+*/
+
+#include "reportXMLStats.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+/*
+    Output the markdown table of the XML stats to standard output.
+
+    @param[in] handler Handler with the stats
+    @param[in] totalBytes Size of the input, for the width of the values
+*/
+void reportXMLStats(XMLStatsHandler& handler, long totalBytes) {
+
+    std::cout.imbue(std::locale{""});
+    const auto valueWidth = std::max(5, static_cast<int>(log10(totalBytes) * 1.3 + 1));
+    std::cout << "# xmlStats: " << '\n';
+    std::cout << "| Measure                 | " << std::setw(valueWidth + 3) << "Value |\n";
+    std::cout << "|:------------------------|-" << std::setw(valueWidth + 3) << std::setfill('-')       << ":|\n" << std::setfill(' ');
+    std::cout << "| Start Document          | " << std::setw(valueWidth) << handler.getStartDocumentCount()          << " |\n";
+    std::cout << "| XML Declarations        | " << std::setw(valueWidth) << handler.getXMLDeclarationCount()         << " |\n";
+    std::cout << "| Start Tags              | " << std::setw(valueWidth) << handler.getStartTagCount()               << " |\n";
+    std::cout << "| End Tags                | " << std::setw(valueWidth) << handler.getEndTagCount()                 << " |\n";
+    std::cout << "| Characters              | " << std::setw(valueWidth) << handler.getCharactersCount()             << " |\n";
+    std::cout << "| Attributes              | " << std::setw(valueWidth) << handler.getAttributeCount()              << " |\n";
+    std::cout << "| XML Namespaces          | " << std::setw(valueWidth) << handler.getXMLNamespaceCount()           << " |\n";
+    std::cout << "| XML Comments            | " << std::setw(valueWidth) << handler.getXMLCommentCount()             << " |\n";
+    std::cout << "| CDATA                   | " << std::setw(valueWidth) << handler.getCDATACount()                  << " |\n";
+    std::cout << "| Processing Instructions | " << std::setw(valueWidth) << handler.getProcessingInstructionCount()  << " |\n";
+    std::cout << "| End Document            | " << std::setw(valueWidth) << handler.getEndDocumentCount()            << " |\n";
+}
@@ -0,0 +1,20 @@
+/*
+    reportXMLStats.hpp
+
+    Include file for the reportXMLStats function
+*/
+
+#ifndef INCLUDED_REPORTXMLSTATS_HPP
+#define INCLUDED_REPORTXMLSTATS_HPP
+
+#include "XMLStatsHandler.hpp"
+
+/*
+    Output the markdown table of the XML stats to standard output.
+
+    @param[in] handler Handler with the stats
+    @param[in] totalBytes Size of the input, for the width of the values
+*/
+void reportXMLStats(XMLStatsHandler& handler, long totalBytes);
+
+#endif
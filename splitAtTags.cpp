@@ -0,0 +1,93 @@
+/*
+    splitAtTags.cpp
+
+    Implementation file for the splitAtTags and endsInsideMarkup functions
+*/
+
+#include "splitAtTags.hpp"
+#include <algorithm>
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+/*
+    Split the content of an element into chunks of about the same size.
+
+    Each chunk after the first starts at a tag start, i.e., a '<' of a start
+    tag. An end tag stays in the chunk of the text before it, e.g., for a
+    handler that collects the text of an element until its end tag, as in
+    srcNamesHandler. A '<' is never in an attribute value, so there is no
+    quote state to track, but a '<' in a comment, CDATA, or processing
+    instruction also looks like a tag start. The split is speculative, and is
+    checked with endsInsideMarkup().
+
+    @param[in] content Content of an element
+    @param[in] count Number of chunks
+    @return Byte ranges of the chunks, at most count, in order
+*/
+[[nodiscard]] std::vector<UnitRange> splitAtTags(std::string_view content, std::size_t count) {
+
+    std::vector<UnitRange> chunks;
+    std::size_t start = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        // resync at the next start tag, skipping end tags, comments, CDATA, and processing instructions
+        auto pos = std::max(start + 1, content.size() / count * i);
+        while ((pos = content.find('<', pos)) != content.npos && pos + 1 < content.size()
+            && (content[pos + 1] == '/' || content[pos + 1] == '!' || content[pos + 1] == '?')) {
+            ++pos;
+        }
+        if (pos == content.npos || pos + 1 >= content.size())
+            break;
+        chunks.push_back(UnitRange{ start, pos - start });
+        start = pos;
+    }
+    chunks.push_back(UnitRange{ start, content.size() - start });
+
+    return chunks;
+}
+
+/*
+    Chunk ends inside a comment, CDATA, or processing instruction.
+
+    The chunk is scanned from a start outside of these, so for chunks split
+    with splitAtTags(), when no chunk ends inside one, no chunk starts inside one.
+
+    @param[in] chunk Chunk of element content
+    @return Whether the chunk ends inside a comment, CDATA, or processing instruction
+*/
+[[nodiscard]] bool endsInsideMarkup(std::string_view chunk) {
+
+    auto nextDeclaration = findLiteral(chunk, "<!"sv, 0);
+    auto nextProcessing = findLiteral(chunk, "<?"sv, 0);
+    while (true) {
+        const auto start = std::min(nextDeclaration, nextProcessing);
+        if (start == chunk.npos)
+            return false;
+
+        // end of the markup, searched for the same as in the parser
+        std::string_view startLiteral;
+        std::string_view endLiteral;
+        if (start == nextProcessing) {
+            startLiteral = "<?"sv;
+            endLiteral = "?>"sv;
+        } else if (chunk.compare(start, "<!--"sv.size(), "<!--"sv) == 0) {
+            startLiteral = "<!--"sv;
+            endLiteral = "-->"sv;
+        } else if (chunk.compare(start, "<![CDATA["sv.size(), "<![CDATA["sv) == 0) {
+            startLiteral = "<![CDATA["sv;
+            endLiteral = "]]>"sv;
+        } else {
+            // other declarations are not allowed in element content
+            return true;
+        }
+        const auto end = findLiteral(chunk, endLiteral, std::min(start + startLiteral.size(), chunk.size()));
+        if (end == chunk.npos)
+            return true;
+        const auto pos = end + endLiteral.size();
+
+        if (nextDeclaration < pos)
+            nextDeclaration = findLiteral(chunk, "<!"sv, pos);
+        if (nextProcessing < pos)
+            nextProcessing = findLiteral(chunk, "<?"sv, pos);
+    }
+}
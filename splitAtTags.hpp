@@ -0,0 +1,43 @@
+/*
+    splitAtTags.hpp
+
+    Include file for the splitAtTags and endsInsideMarkup functions
+*/
+
+#ifndef INCLUDED_SPLITATTAGS_HPP
+#define INCLUDED_SPLITATTAGS_HPP
+
+#include "findUnits.hpp"
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/*
+    Split the content of an element into chunks of about the same size.
+
+    Each chunk after the first starts at a tag start, i.e., a '<' of a start
+    tag. An end tag stays in the chunk of the text before it, e.g., for a
+    handler that collects the text of an element until its end tag, as in
+    srcNamesHandler. A '<' is never in an attribute value, so there is no
+    quote state to track, but a '<' in a comment, CDATA, or processing
+    instruction also looks like a tag start. The split is speculative, and is
+    checked with endsInsideMarkup().
+
+    @param[in] content Content of an element
+    @param[in] count Number of chunks
+    @return Byte ranges of the chunks, at most count, in order
+*/
+[[nodiscard]] std::vector<UnitRange> splitAtTags(std::string_view content, std::size_t count);
+
+/*
+    Chunk ends inside a comment, CDATA, or processing instruction.
+
+    The chunk is scanned from a start outside of these, so for chunks split
+    with splitAtTags(), when no chunk ends inside one, no chunk starts inside one.
+
+    @param[in] chunk Chunk of element content
+    @return Whether the chunk ends inside a comment, CDATA, or processing instruction
+*/
+[[nodiscard]] bool endsInsideMarkup(std::string_view chunk);
+
+#endif
@@ -7,61 +7,393 @@
     are output to standard error.
 
     The code includes a complete XML parser:
-    * Characters and content from XML is in UTF-8
+    * Characters and content from XML is in UTF-8, checked with the option --validate-utf8
     * DTD declarations are allowed, but not fine-grained parsed
-    * No checking for well-formedness
+    * Well-formedness is checked with the option --wellformed
+
+    By default, the parser is the stripped FactsXMLParser. The option --full
+    uses the parser with all features, e.g., to compare throughput.
+
+    With the option --unit filename and a srcML archive with a unit index (see
+    srcindex), only the unit with that filename is parsed, directly from the archive:
+
+    srcfacts --unit src/main.cpp archive.xml
+
+    With the option --cache cachefile and a srcML archive, the counts of each unit
+    are stored in the cache file. On the next run, a unit with the same content is
+    not parsed, but its counts are taken from the cache. The option --cache-entries
+    bounds the number of units in the cache, with the least recently used evicted:
+
+    srcfacts --cache srcfacts.cache archive.xml
+
+    With the option --tape tapefile, the handler is driven by replaying an event
+    tape recorded with srctape, instead of parsing the XML.
+
+    With the option --threads N, a srcML archive on standard input is parsed by N
+    threads, a unit at a time. The option --max-chunks bounds the chunks of
+    units read ahead of the threads, so the memory does not grow with the input:
+
+    srcfacts --threads 4 < archive.xml
+
+    With the option --shard i/N and a srcML archive, only the i-th of N ranges of
+    units is parsed, with i from 0. The option --partial outputs the counts as a
+    partial result in JSON instead of the report, and srcmerge sums the partial
+    results of all the shards into the report of the whole archive:
+
+    srcfacts --shard 0/2 --partial archive.xml > shard0.json
+    srcfacts --shard 1/2 --partial archive.xml > shard1.json
+    srcmerge shard0.json shard1.json
+
+    With the option --profile, the counts, bytes, and time of each kind of parse
+    event, and of the refills of the input, are output after the performance
+    statistics (see ParseProfile.hpp).
+
+    With the option --perf-counters, the hardware performance counters of the
+    parse and of the report, e.g., cycles and cache misses, are output after the
+    performance statistics (see PerfCounters.hpp).
+
+    With the option --memory, the memory usage, i.e., peak RSS, the input buffer,
+    and the heap allocations of the parse, is output after the performance
+    statistics (see memoryUsage.hpp). With the option --max-allocations N, more
+    than N heap allocations during the parse is an error, e.g., to check that
+    the parse does not allocate for each event, with the allocation counting
+    compiled in, cmake -DCOUNT_ALLOCATIONS=ON:
+
+    srcfacts --max-allocations 10 < archive.xml
+
+    With the option --multiple-documents, standard input is a stream of srcML
+    documents one after the other, e.g., one for each changed file written back
+    to back to a pipe, and the report is of all of them:
+
+    srcfacts --multiple-documents < stream.xml
 */
 
 #include <iostream>
 #include <algorithm>
-#include <iomanip>
 #include <string_view>
-#include <cmath>
+#include <cstdio>
 #include <chrono>
 #include <cassert>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
 #include "refillContent.hpp"
 #include "XMLParser.hpp"
+#include "UnitIndex.hpp"
+#include "MappedFile.hpp"
+#include "findUnits.hpp"
+#include "hashContent.hpp"
+#include "srcFactsCache.hpp"
+#include "TapeReplayer.hpp"
+#include "parseParallel.hpp"
+#include "partialResult.hpp"
+#include "reportFacts.hpp"
 #include "srcFactsHandler.hpp"
+#include "ParseProfile.hpp"
+#include "PerfCounters.hpp"
+#include "memoryUsage.hpp"
 
 // provides literal string operator""sv
 using namespace std::literals::string_view_literals;
 
+// parse the content, or standard input if the content is empty, with an optional profile
+// The base offset is the offset in the document of the content, e.g., of a unit, for the errors
+// @return Number of bytes parsed
+template <class Parser>
+long parseFacts(std::string_view content, srcFactsHandler& handler, bool validateUTF8, bool checkWellFormed, ParseProfile* profile,
+                bool multipleDocuments = false, long baseOffset = 0) {
+    Parser parser(content, handler);
+    parser.setValidateUTF8(validateUTF8);
+    parser.setCheckWellFormed(checkWellFormed);
+    parser.setProfile(profile);
+    parser.setMultipleDocuments(multipleDocuments);
+    parser.setBaseOffset(baseOffset);
+
+    // parse XML
+    parser.parse();
+    return parser.getTotalBytes();
+}
+
+// parse the units of the shard of the srcML document, the shard index of the shard count
+// With a cache, the counts of the cached units are merged without parsing. A unit
+// is only taken from the cache when it was parsed with at least the checks of this run
+// @return Number of bytes of the shard
+template <class Parser>
+long parseUnits(std::string_view document, int shardIndex, int shardCount, srcFactsCache* cache,
+                srcFactsHandler& handler, bool validateUTF8, bool checkWellFormed, ParseProfile* profile) {
+    const auto units = findUnits(document);
+
+    // the shard is a range of units by index
+    const auto first = units.size() * shardIndex / shardCount;
+    const auto last = units.size() * (shardIndex + 1) / shardCount;
+    const auto checks = (validateUTF8 ? srcFactsCache::VALIDATED_UTF8 : 0) | (checkWellFormed ? srcFactsCache::CHECKED_WELLFORMED : 0);
+    long totalBytes = 0;
+    for (auto i = first; i < last; ++i) {
+        const auto unitContent = document.substr(units[i].offset, units[i].length);
+        totalBytes += static_cast<long>(unitContent.size());
+        const auto hash = cache ? hashContent(unitContent) : 0;
+        if (cache) {
+            if (const auto counts = cache->find(hash, unitContent.size(), checks)) {
+                handler.addCounts(*counts);
+                continue;
+            }
+        }
+        srcFactsHandler unitHandler;
+        parseFacts<Parser>(unitContent, unitHandler, validateUTF8, checkWellFormed, profile, false, static_cast<long>(units[i].offset));
+        if (cache)
+            cache->insert(hash, unitContent.size(), checks, unitHandler.getCounts());
+        handler.merge(unitHandler);
+    }
+
+    // the root unit and the content between the units are in the first shard, and never cached
+    // The offsets of the errors in the envelope are in the document up to the first unit
+    if (shardIndex == 0) {
+        const auto envelope = unitEnvelope(document, units);
+        if (!envelope.empty()) {
+            srcFactsHandler envelopeHandler;
+            parseFacts<Parser>(envelope, envelopeHandler, validateUTF8, checkWellFormed, profile);
+            handler.merge(envelopeHandler);
+        }
+        for (const auto& unit : units)
+            totalBytes -= static_cast<long>(unit.length);
+        totalBytes += static_cast<long>(document.size());
+    }
+
+    return totalBytes;
+}
+
+// parse the count of the option, a whole decimal number from 0 to the maximum
+// @return Whether the text is a count, with the error output when it is not
+bool parseCount(const char* option, const char* text, long maximum, long& count) {
+    char* end = nullptr;
+    errno = 0;
+    count = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno != 0 || count < 0 || count > maximum) {
+        std::cerr << "srcfacts: Invalid count " << text << " for the option " << option << '\n';
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, char* argv[]) {
 
+    bool fullParser = false;
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    const char* unitFilename = nullptr;
+    const char* cacheFilename = nullptr;
+    std::size_t cacheEntries = 1000000;
+    const char* tapeFilename = nullptr;
+    const char* archiveFilename = nullptr;
+    int threadCount = 0;
+    std::size_t maxChunks = 0;
+    int shardIndex = 0;
+    int shardCount = 0;
+    bool partial = false;
+    bool profile = false;
+    bool perfCounters = false;
+    bool memory = false;
+    long maxAllocations = -1;
+    bool multipleDocuments = false;
+    long count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--full") == 0) {
+            fullParser = true;
+        } else if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else if (strcmp(argv[i], "--unit") == 0 && i + 1 < argc) {
+            unitFilename = argv[++i];
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cacheFilename = argv[++i];
+        } else if (strcmp(argv[i], "--tape") == 0 && i + 1 < argc) {
+            tapeFilename = argv[++i];
+        } else if (strcmp(argv[i], "--cache-entries") == 0 && i + 1 < argc) {
+            if (!parseCount(argv[i], argv[i + 1], LONG_MAX, count))
+                return 1;
+            cacheEntries = static_cast<std::size_t>(count);
+            ++i;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            if (!parseCount(argv[i], argv[i + 1], INT_MAX, count))
+                return 1;
+            threadCount = static_cast<int>(count);
+            ++i;
+        } else if (strcmp(argv[i], "--max-chunks") == 0 && i + 1 < argc) {
+            if (!parseCount(argv[i], argv[i + 1], LONG_MAX, count))
+                return 1;
+            maxChunks = static_cast<std::size_t>(count);
+            ++i;
+        } else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d/%d", &shardIndex, &shardCount) != 2 || shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount) {
+                std::cerr << "srcfacts: Invalid shard " << argv[i] << ", expected i/N with 0 <= i < N\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--partial") == 0) {
+            partial = true;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (strcmp(argv[i], "--perf-counters") == 0) {
+            perfCounters = true;
+        } else if (strcmp(argv[i], "--memory") == 0) {
+            memory = true;
+        } else if (strcmp(argv[i], "--max-allocations") == 0 && i + 1 < argc) {
+            if (!parseCount(argv[i], argv[i + 1], LONG_MAX, maxAllocations))
+                return 1;
+            ++i;
+        } else if (strcmp(argv[i], "--multiple-documents") == 0) {
+            multipleDocuments = true;
+        } else if (argv[i][0] != '-' && !archiveFilename) {
+            archiveFilename = argv[i];
+        } else {
+            std::cerr << "srcfacts: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if ((unitFilename || cacheFilename || shardCount) != (archiveFilename != nullptr)) {
+        std::cerr << "srcfacts: The options --unit, --cache, and --shard require a srcML archive filename\n";
+        return 1;
+    }
+    if (unitFilename && (cacheFilename || shardCount)) {
+        std::cerr << "srcfacts: The option --unit cannot be combined with --cache or --shard\n";
+        return 1;
+    }
+    if (threadCount < 0 || (threadCount > 0 && (archiveFilename || tapeFilename))) {
+        std::cerr << "srcfacts: The option --threads requires a positive count and input from standard input\n";
+        return 1;
+    }
+
+    if (multipleDocuments && (archiveFilename || tapeFilename || threadCount > 0)) {
+        std::cerr << "srcfacts: The option --multiple-documents requires input from standard input on a single thread\n";
+        return 1;
+    }
+
+    if (maxAllocations >= 0 && !allocationsCounted) {
+        std::cerr << "srcfacts: The option --max-allocations requires allocation counting compiled in, cmake -DCOUNT_ALLOCATIONS=ON\n";
+        return 1;
+    }
+
+    if (profile && (!ParseProfile::compiledIn || threadCount > 0 || tapeFilename)) {
+        std::cerr << "srcfacts: The option --profile requires profiling compiled in, cmake -DPROFILE=ON, and a parse on a single thread\n";
+        return 1;
+    }
+
+    // by default, each thread has a chunk being parsed and one waiting
+    if (maxChunks == 0)
+        maxChunks = 2 * static_cast<std::size_t>(threadCount);
+
+    std::optional<PerfCounters> counters;
+    if (perfCounters)
+        counters.emplace();
+
+    const auto startAllocations = getAllocationCounts();
     const auto startTime = std::chrono::steady_clock::now();
+    if (counters)
+        counters->start();
     std::string_view content;
+
+    // parse only the unit, directly from the archive
+    std::optional<UnitIndex> index;
+    long unitOffset = 0;
+    if (unitFilename) {
+        index.emplace(archiveFilename, UnitIndex::indexFilename(archiveFilename));
+        const auto position = index->findUnit(unitFilename);
+        if (!position) {
+            std::cerr << "srcfacts: No unit with filename " << unitFilename << '\n';
+            return 1;
+        }
+        content = index->getUnitContent(*position);
+        unitOffset = static_cast<long>(index->getUnit(*position).offset);
+    }
     srcFactsHandler handler;
-    XMLParser parser(content, handler);
+    ParseProfile parseProfile;
+    ParseProfile* const profiler = profile ? &parseProfile : nullptr;
+    long totalBytes = 0;
+    std::optional<srcFactsCache> cache;
+    long archiveSize = 0;
+    std::uint64_t archiveHash = 0;
+    if (tapeFilename) {
+        // replay the events of the tape
+        TapeReplayer tape(tapeFilename);
+        tape.replay(handler);
+        totalBytes = tape.getTotalBytes();
+    } else if (cacheFilename || shardCount) {
+        // parse the units of the shard that are not in the cache
+        MappedFile archive(archiveFilename);
+        if (cacheFilename)
+            cache.emplace(cacheFilename, cacheEntries);
+        if (!shardCount)
+            shardCount = 1;
 
-    // parse XML
-    parser.parse();
+        // the partial result of a shard identifies its archive, for the checks of the merge
+        if (partial) {
+            archiveSize = static_cast<long>(archive.getContent().size());
+            archiveHash = hashContent(archive.getContent());
+        }
+        if (fullParser)
+            totalBytes = parseUnits<XMLParser>(archive.getContent(), shardIndex, shardCount, cache ? &*cache : nullptr, handler, validateUTF8, checkWellFormed, profiler);
+        else
+            totalBytes = parseUnits<FactsXMLParser>(archive.getContent(), shardIndex, shardCount, cache ? &*cache : nullptr, handler, validateUTF8, checkWellFormed, profiler);
+        if (cache)
+            cache->save();
+    } else if (threadCount > 0) {
+        // parse the units of standard input in parallel
+        if (fullParser)
+            totalBytes = parseParallel<XMLParser>(handler, threadCount, maxChunks, validateUTF8, checkWellFormed);
+        else
+            totalBytes = parseParallel<FactsXMLParser>(handler, threadCount, maxChunks, validateUTF8, checkWellFormed);
+    } else if (fullParser) {
+        totalBytes = parseFacts<XMLParser>(content, handler, validateUTF8, checkWellFormed, profiler, multipleDocuments, unitOffset);
+    } else {
+        totalBytes = parseFacts<FactsXMLParser>(content, handler, validateUTF8, checkWellFormed, profiler, multipleDocuments, unitOffset);
+    }
 
+    if (counters) {
+        counters->stop("Parse"sv, totalBytes);
+        counters->start();
+    }
     const auto finishTime = std::chrono::steady_clock::now();
+    const auto finishAllocations = getAllocationCounts();
+    const AllocationCounts parseAllocations = { finishAllocations.count - startAllocations.count,
+                                                finishAllocations.bytes - startAllocations.bytes };
     const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
     const auto MLOCPerSecond = handler.getLoc() / elapsedSeconds / 1000000;
-    const auto files = std::max(handler.getUnitCount() - 1, 1);
-    std::cout.imbue(std::locale{""});
-    const auto valueWidth = std::max(5, static_cast<int>(log10(parser.getTotalBytes()) * 1.3 + 1));
-    std::cout << "# srcFacts: " << handler.getUrl() << '\n';
-    std::cout << "| Measure      | " << std::setw(valueWidth + 3) << "Value |\n";
-    std::cout << "|:-------------|-" << std::setw(valueWidth + 3) << std::setfill('-') << ":|\n" << std::setfill(' ');
-    std::cout << "| Characters   | " << std::setw(valueWidth) << handler.getTextSize()        << " |\n";
-    std::cout << "| LOC          | " << std::setw(valueWidth) << handler.getLoc()             << " |\n";
-    std::cout << "| Files        | " << std::setw(valueWidth) << files                       << " |\n";
-    std::cout << "| Classes      | " << std::setw(valueWidth) << handler.getClassCount()      << " |\n";
-    std::cout << "| Functions    | " << std::setw(valueWidth) << handler.getFunctionCount()   << " |\n";
-    std::cout << "| Declarations | " << std::setw(valueWidth) << handler.getDeclCount()       << " |\n";
-    std::cout << "| Expressions  | " << std::setw(valueWidth) << handler.getExprCount()       << " |\n";
-    std::cout << "| Comments     | " << std::setw(valueWidth) << handler.getCommentCount()    << " |\n";
-    std::cout << "| Returns      | " << std::setw(valueWidth) << handler.getReturnCount()     << " |\n";
-    std::cout << "| Line Comments| " << std::setw(valueWidth) << handler.getLineCommentCount()<< " |\n";
-    std::cout << "| Strings      | " << std::setw(valueWidth) << handler.getStringCount()     << " |\n";
+    if (partial) {
+        auto result = makePartialResult("srcfacts"sv, handler.getUrl(), totalBytes, handler);
+        if (shardCount) {
+            result.shardBegin = shardIndex;
+            result.shardEnd = shardIndex + 1;
+            result.shardCount = shardCount;
+            result.archiveSize = archiveSize;
+            result.archiveHash = archiveHash;
+        }
+        writePartialResult(std::cout, result);
+    } else
+        reportFacts(handler.getUrl(), handler, totalBytes);
+    if (counters)
+        counters->stop("Report"sv, totalBytes);
     std::clog.imbue(std::locale{""});
     std::clog.precision(3);
     std::clog << '\n';
-    std::clog << parser.getTotalBytes()  << " bytes\n";
+    std::clog << totalBytes  << " bytes\n";
     std::clog << elapsedSeconds << " sec\n";
     std::clog << MLOCPerSecond << " MLOC/sec\n";
+    if (cache)
+        std::clog << cache->getHitCount() << " cached units, " << cache->getMissCount() << " parsed units\n";
+    if (profile)
+        parseProfile.report(std::clog);
+    if (counters)
+        counters->report(std::clog);
+    if (memory)
+        reportMemory(std::clog, parseAllocations, totalBytes);
+    if (maxAllocations >= 0 && parseAllocations.count > maxAllocations) {
+        std::cerr << "srcfacts: " << parseAllocations.count << " heap allocations during the parse, more than the maximum of "
+                  << maxAllocations << '\n';
+        return 1;
+    }
 
     return 0;
 }
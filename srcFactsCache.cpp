@@ -0,0 +1,124 @@
+/*
+    srcFactsCache.cpp
+
+    Implementation file for the persistent cache of srcFacts counts per unit.
+
+    Cache file layout, in the byte order of the machine:
+    * Header: magic "SRCFCACH", version, number of counts, run number
+    * Records: hash, length, run that last used it, counts, and checks of the parse
+*/
+
+#include "srcFactsCache.hpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+    const char MAGIC[8] = { 'S', 'R', 'C', 'F', 'C', 'A', 'C', 'H' };
+
+    const std::uint32_t VERSION = 2;
+
+    // header of the cache file
+    struct CacheHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t countSize;
+        std::uint64_t generation;
+    };
+
+    // record of a unit in the cache file
+    struct CacheRecord {
+        std::uint64_t hash;
+        std::uint64_t length;
+        std::uint64_t lastUsed;
+        srcFactsHandler::Counts counts;
+        std::uint32_t checks;
+    };
+}
+
+// constructor, loading the cache file if it exists
+srcFactsCache::srcFactsCache(const std::string& filename, std::size_t maxEntries)
+    : filename(filename), maxEntries(maxEntries), generation(1), hitCount(0), missCount(0) {
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        return;
+
+    // a cache from another version is ignored, and replaced on save
+    CacheHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0
+        || header.version != VERSION || header.countSize != std::tuple_size_v<srcFactsHandler::Counts>) {
+        std::cerr << "cache warning : Ignoring invalid cache file " << filename << '\n';
+        return;
+    }
+    generation = header.generation + 1;
+    CacheRecord record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        entries.emplace(record.hash, Entry{ record.length, record.lastUsed, record.counts, record.checks });
+}
+
+// find the counts of the unit with the hash and length, parsed with at least the checks
+std::optional<srcFactsHandler::Counts> srcFactsCache::find(std::uint64_t hash, std::uint64_t length, std::uint32_t checks) {
+    const auto found = entries.find(hash);
+    if (found == entries.end() || found->second.length != length || (found->second.checks & checks) != checks) {
+        ++missCount;
+        return std::nullopt;
+    }
+    ++hitCount;
+    found->second.lastUsed = generation;
+    return found->second.counts;
+}
+
+// insert the counts of the unit with the hash and length, parsed with the checks
+// The checks of an entry for the same unit still hold for it
+void srcFactsCache::insert(std::uint64_t hash, std::uint64_t length, std::uint32_t checks, const srcFactsHandler::Counts& counts) {
+    const auto found = entries.find(hash);
+    if (found != entries.end() && found->second.length == length)
+        checks |= found->second.checks;
+    entries.insert_or_assign(hash, Entry{ length, generation, counts, checks });
+}
+
+// save the cache file, evicting the least recently used entries
+void srcFactsCache::save() {
+
+    std::vector<CacheRecord> records;
+    records.reserve(entries.size());
+    for (const auto& [hash, entry] : entries)
+        records.push_back(CacheRecord{ hash, entry.length, entry.lastUsed, entry.counts, entry.checks });
+    if (records.size() > maxEntries) {
+        std::nth_element(records.begin(), records.begin() + maxEntries, records.end(),
+            [](const CacheRecord& a, const CacheRecord& b) { return a.lastUsed > b.lastUsed; });
+        records.resize(maxEntries);
+    }
+
+    // write to a temporary file and rename, so an interrupted run leaves the previous cache
+    CacheHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.countSize = std::tuple_size_v<srcFactsHandler::Counts>;
+    header.generation = generation;
+    const auto temporaryFilename = filename + ".tmp";
+    std::ofstream out(temporaryFilename, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(CacheRecord));
+    out.close();
+    if (!out || std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+        std::cerr << "cache error : Unable to write " << filename << '\n';
+        exit(1);
+    }
+}
+
+// get hitCount
+long srcFactsCache::getHitCount() {
+    return hitCount;
+}
+
+// get missCount
+long srcFactsCache::getMissCount() {
+    return missCount;
+}
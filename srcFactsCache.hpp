@@ -0,0 +1,72 @@
+/*
+    srcFactsCache.hpp
+
+    Header file for the persistent cache of srcFacts counts per unit.
+
+    The cache maps the hash and length of the raw bytes of a unit to the counts
+    of the unit, so an unchanged unit is not parsed again on the next run. The
+    cache file is loaded at the start of a run and saved at the end. The number
+    of entries is bounded, and the least recently used entries are evicted.
+
+    Each entry records the checks of the parse of the unit, e.g., --wellformed,
+    so a run with a check that the unit was not parsed with parses it again.
+*/
+
+#ifndef SRCFACTSCACHE_HPP
+#define SRCFACTSCACHE_HPP
+
+#include "srcFactsHandler.hpp"
+#include <string>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+class srcFactsCache {
+public:
+    // checks of the parse of a unit, as flags
+    static constexpr std::uint32_t VALIDATED_UTF8 = 1;
+    static constexpr std::uint32_t CHECKED_WELLFORMED = 2;
+
+    // constructor, loading the cache file if it exists
+    srcFactsCache(const std::string& filename, std::size_t maxEntries);
+
+    // find the counts of the unit with the hash and length, parsed with at least the checks
+    std::optional<srcFactsHandler::Counts> find(std::uint64_t hash, std::uint64_t length, std::uint32_t checks);
+
+    // insert the counts of the unit with the hash and length, parsed with the checks
+    void insert(std::uint64_t hash, std::uint64_t length, std::uint32_t checks, const srcFactsHandler::Counts& counts);
+
+    // save the cache file, evicting the least recently used entries
+    void save();
+
+    // get hitCount
+    long getHitCount();
+
+    // get missCount
+    long getMissCount();
+
+private:
+    // cached counts with the length of the unit, the run that last used them, and the checks of the parse
+    struct Entry {
+        std::uint64_t length;
+        std::uint64_t lastUsed;
+        srcFactsHandler::Counts counts;
+        std::uint32_t checks;
+    };
+
+    std::string filename;
+
+    std::size_t maxEntries;
+
+    // run number, increased on each run
+    std::uint64_t generation;
+
+    std::unordered_map<std::uint64_t, Entry> entries;
+
+    long hitCount;
+
+    long missCount;
+};
+
+#endif
@@ -14,13 +14,14 @@ using namespace std::literals::string_view_literals;
 srcFactsHandler::srcFactsHandler() :
     textSize(0), loc(0), exprCount(0), functionCount(0),
     classCount(0), unitCount(0), declCount(0), commentCount(0),
-    returnCount(0), lineCommentCount(0), stringCount(0)
+    returnCount(0), lineCommentCount(0), stringCount(0),
+    documentCount(0), fileCount(0), documentStartUnitCount(0), separateUnitCount(0)
     {}
 
 // get urls
 std::string srcFactsHandler::getUrl()
 {
-    return url;
+    return std::string(url);
 }
 
 // get textSizes
@@ -89,8 +90,57 @@ int srcFactsHandler::getStringCount()
     return stringCount;
 }
 
+// get documentCount
+int srcFactsHandler::getDocumentCount()
+{
+    return documentCount;
+}
+
+// get fileCount
+int srcFactsHandler::getFileCount()
+{
+    return fileCount;
+}
+
+// get the counts of all the measures
+srcFactsHandler::Counts srcFactsHandler::getCounts()
+{
+    return Counts{ textSize, loc, exprCount, functionCount, classCount, unitCount,
+                   declCount, commentCount, returnCount, lineCommentCount, stringCount,
+                   documentCount, fileCount };
+}
+
+// add counts of all the measures
+void srcFactsHandler::addCounts(const Counts& counts)
+{
+    textSize         += counts[0];
+    loc              += counts[1];
+    exprCount        += counts[2];
+    functionCount    += counts[3];
+    classCount       += counts[4];
+    unitCount        += counts[5];
+    declCount        += counts[6];
+    commentCount     += counts[7];
+    returnCount      += counts[8];
+    lineCommentCount += counts[9];
+    stringCount      += counts[10];
+    documentCount    += counts[11];
+    fileCount        += counts[12];
+}
+
+// merge the facts of another handler, e.g., of a separately parsed unit
+void srcFactsHandler::merge(srcFactsHandler& other)
+{
+    addCounts(other.getCounts());
+    if (url.empty())
+        url = strings.intern(other.url);
+}
+
 // start Document Handler
-void srcFactsHandler::handleStartDocument() {}
+void srcFactsHandler::handleStartDocument() {
+    documentStartUnitCount = unitCount;
+    separateUnitCount = 0;
+}
 
 // XML Declaration Handler
 void srcFactsHandler::handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) {}
@@ -126,7 +176,7 @@ void srcFactsHandler::handleCharacter(std::string_view characters) {
 // attribute Handler
 void srcFactsHandler::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
     if (localName == "url"sv) {
-        url = value;
+        url = strings.intern(value);
     } else if (localName == "type"sv && value == "string"sv) {
         ++stringCount;
     } else if (localName == "type"sv && value == "line") {
@@ -141,7 +191,10 @@ void srcFactsHandler::handleXMLNamespace(std::string_view prefix, std::string_vi
 void srcFactsHandler::handleXMLComment(std::string_view value) {}
 
 // CDATA Handler
+// An empty CDATA section is a unit parsed separately, in the envelope of an archive (see unitEnvelope())
 void srcFactsHandler::handleCDATA(std::string_view characters) {
+    if (characters.empty())
+        ++separateUnitCount;
     textSize += static_cast<int>(characters.size());
     loc += static_cast<int>(std::count(characters.cbegin(), characters.cend(), '\n'));
 }
@@ -150,4 +203,10 @@ void srcFactsHandler::handleCDATA(std::string_view characters) {
 void srcFactsHandler::handleProcessingInstruction(std::string_view target, std::string_view data) {}
 
 // end Document Handler
-void srcFactsHandler::handleEndDocument() {}
+// The root unit of an archive is not a file, and the units parsed separately count their own files
+void srcFactsHandler::handleEndDocument() {
+    ++documentCount;
+    const auto units = unitCount - documentStartUnitCount;
+    const bool archive = units > 1 || separateUnitCount > 0;
+    fileCount += archive ? units - 1 : 1;
+}
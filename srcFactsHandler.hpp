@@ -7,7 +7,10 @@
 #define SRCFACTSHANDLER_HPP
 
 #include <string>
+#include <string_view>
+#include <array>
 #include "XMLParserHandler.hpp"
+#include "StringPool.hpp"
 
 class srcFactsHandler : public XMLParserHandler {
 public:
@@ -50,6 +53,31 @@ public:
     // get stringCount
     int getStringCount();
 
+    // get documentCount, e.g., of a stream of documents
+    int getDocumentCount();
+
+    // get the number of files of the documents, i.e., of the units that are not an archive
+    int getFileCount();
+
+    // counts of all the measures, e.g., to store the facts of a unit
+    using Counts = std::array<int, 13>;
+
+    // names of the counts, in the order of getCounts(), e.g., for partial results
+    static constexpr std::array<std::string_view, 13> COUNT_NAMES = {
+        "textSize", "loc", "exprCount", "functionCount", "classCount", "unitCount",
+        "declCount", "commentCount", "returnCount", "lineCommentCount", "stringCount",
+        "documentCount", "fileCount"
+    };
+
+    // get the counts of all the measures
+    Counts getCounts();
+
+    // add counts of all the measures
+    void addCounts(const Counts& counts);
+
+    // merge the facts of another handler, e.g., of a separately parsed unit
+    void merge(srcFactsHandler& other);
+
 protected:
     // start Document Handler
     void handleStartDocument() override;
@@ -85,7 +113,9 @@ protected:
     void handleEndDocument() override;
 
 private:
-    std::string url;
+    // url interned in the pool, as it is kept after its attribute
+    StringPool strings;
+    std::string_view url;
     int textSize;
     int loc;
     int exprCount;
@@ -97,6 +127,14 @@ private:
     int returnCount;
     int lineCommentCount;
     int stringCount;
+
+    // documents parsed, and their files, as a document is a single unit or an archive of units
+    int documentCount;
+    int fileCount;
+
+    // units, and units parsed separately, in the document so far
+    int documentStartUnitCount;
+    int separateUnitCount;
 };
 
 #endif
@@ -0,0 +1,91 @@
+/*
+    srcNamesHandler.cpp
+
+    Concrete class specific to srcNames inheriting from the abstract class XMLParser
+*/
+
+#include "srcNamesHandler.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// maximum number of names in the table of a new handler
+std::size_t srcNamesHandler::maxNames = 1000000;
+
+// constructor
+srcNamesHandler::srcNamesHandler() : names(maxNames), inName(false) {}
+
+// set the maximum number of names in the table of the handlers constructed after,
+// e.g., of the handlers of the threads
+void srcNamesHandler::setMaxNames(std::size_t newMaxNames)
+{
+    maxNames = newMaxNames;
+}
+
+// get url
+std::string srcNamesHandler::getUrl()
+{
+    return std::string(url);
+}
+
+// get the counts of the names
+const NameCounter& srcNamesHandler::getNames()
+{
+    return names;
+}
+
+// merge the names of another handler, e.g., of a separately parsed unit
+void srcNamesHandler::merge(srcNamesHandler& other)
+{
+    names.merge(other.names);
+    if (url.empty())
+        url = strings.intern(other.url);
+}
+
+// start Document Handler
+void srcNamesHandler::handleStartDocument() {}
+
+// XML Declaration Handler
+void srcNamesHandler::handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) {}
+
+// Start Tag Handler
+// A tag in a name, e.g., of a name of a qualified name, makes it a complex name
+void srcNamesHandler::handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+    inName = localName == "name"sv;
+    text.clear();
+}
+
+// End Tag Handler
+void srcNamesHandler::handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) {
+    if (inName && !text.empty())
+        names.add(text);
+    inName = false;
+}
+
+// Character Handler
+// The text of a name may be in more than one piece, e.g., operator&lt;
+void srcNamesHandler::handleCharacter(std::string_view characters) {
+    if (inName)
+        text.append(characters);
+}
+
+// attribute Handler
+void srcNamesHandler::handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) {
+    if (localName == "url"sv)
+        url = strings.intern(value);
+}
+
+// XML Namespace Handler
+void srcNamesHandler::handleXMLNamespace(std::string_view prefix, std::string_view uri) {}
+
+// XML Comment Handler
+void srcNamesHandler::handleXMLComment(std::string_view value) {}
+
+// CDATA Handler
+void srcNamesHandler::handleCDATA(std::string_view characters) {}
+
+// processing Instruction Handler
+void srcNamesHandler::handleProcessingInstruction(std::string_view target, std::string_view data) {}
+
+// end Document Handler
+void srcNamesHandler::handleEndDocument() {}
@@ -0,0 +1,86 @@
+/*
+    srcNamesHandler.hpp
+
+    Concrete class specific to srcNames inheriting from the abstract class XMLParser.
+    Counts the text of each srcML name element that has only text, i.e., each
+    identifier, and not the complex names with other names in them.
+*/
+#ifndef SRCNAMESHANDLER_HPP
+#define SRCNAMESHANDLER_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include "XMLParserHandler.hpp"
+#include "StringPool.hpp"
+#include "NameCounter.hpp"
+
+class srcNamesHandler : public XMLParserHandler {
+public:
+    // constructor
+    srcNamesHandler();
+
+    // set the maximum number of names in the table of the handlers constructed after,
+    // e.g., of the handlers of the threads
+    static void setMaxNames(std::size_t maxNames);
+
+    // get url
+    std::string getUrl();
+
+    // get the counts of the names
+    const NameCounter& getNames();
+
+    // merge the names of another handler, e.g., of a separately parsed unit
+    void merge(srcNamesHandler& other);
+
+protected:
+    // start Document Handler
+    void handleStartDocument() override;
+
+    // XML Declaration Handler
+    void handleXMLDeclaration(std::string_view version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) override;
+
+    // Start Tag Handler
+    void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // End Tag Handler
+    void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override;
+
+    // Character Handler
+    void handleCharacter(std::string_view characters) override;
+
+    // attribute Handler
+    void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override;
+
+    // XML Namespace Handler
+    void handleXMLNamespace(std::string_view prefix, std::string_view uri) override;
+
+    // XML Comment Handler
+    void handleXMLComment(std::string_view value) override;
+
+    // CDATA Handler
+    void handleCDATA(std::string_view characters) override;
+
+    // processing Instruction Handler
+    void handleProcessingInstruction(std::string_view target, std::string_view data) override;
+
+    // end Document Handler
+    void handleEndDocument() override;
+
+private:
+    // maximum number of names in the table of a new handler
+    static std::size_t maxNames;
+
+    // url interned in the pool, as it is kept after its attribute
+    StringPool strings;
+    std::string_view url;
+    NameCounter names;
+
+    // in a name with only text so far
+    bool inName;
+
+    // text of the name, copied as the input may be refilled before its end tag
+    std::string text;
+};
+
+#endif
@@ -0,0 +1,307 @@
+/*
+    srcfactsd.cpp
+
+    Daemon that produces the srcFacts counts of srcML sent over a Unix domain
+    socket, without the startup of a process for each input:
+
+    srcfactsd /tmp/srcfacts.socket --workers 4 --idle-timeout 10
+
+    Each request on a connection is a header line, followed by the content:
+    * XML length\n followed by length bytes of srcML
+    * FILE path\n for a srcML file on the same machine
+
+    The response is a single line, the facts as a partial result in JSON (see
+    partialResult.hpp), and a connection can send any number of requests.
+
+    Requests are handled concurrently by a pool of worker processes that are
+    started once and stay warm. A parse error exits, as everywhere in the
+    parser, so a worker is a process, not a thread. During a request the error
+    output of the worker is the connection, so the client receives the error
+    line before the connection closes, and the daemon starts a new worker.
+    A worker that does not start, e.g., on a failed fork, is started again
+    after a backoff, and the daemon exits when no worker starts.
+
+    A worker serves one connection at a time, so at most as many connections
+    as workers are served at once, and the others wait. A connection that sends
+    no request for the idle timeout, 10 seconds by default, is closed so that
+    idle clients do not hold the workers.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "XMLParser.hpp"
+#include "srcFactsHandler.hpp"
+#include "MappedFile.hpp"
+#include "partialResult.hpp"
+#include "xml_parser.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// largest srcML content of an XML request
+const std::size_t MAX_REQUEST_SIZE = 1024 * 1024 * 1024;
+
+// size of a read from the connection
+const std::size_t READ_SIZE = 64 * 1024;
+
+// starts of the workers that did not start, with a backoff of 1, 2, 4, ... seconds,
+// before the daemon exits when no worker is running
+const int MAX_START_RETRIES = 6;
+
+namespace {
+
+    // daemon is stopping, from a signal
+    volatile std::sig_atomic_t stopping = 0;
+
+    // stop on a signal
+    void stop(int) {
+        stopping = 1;
+    }
+
+    // connection of a worker, with the input read but not yet used
+    class Connection {
+    public:
+        // constructor
+        Connection(int fd) : fd(fd) {}
+
+        // read the line, without the newline
+        // @return false at the end of the connection
+        bool readLine(std::string& line) {
+            std::size_t newline;
+            while ((newline = pending.find('\n')) == pending.npos) {
+                if (!fill())
+                    return false;
+            }
+            line.assign(pending, 0, newline);
+            pending.erase(0, newline + 1);
+            return true;
+        }
+
+        // read exactly size bytes into the content
+        // @return false at the end of the connection
+        bool readContent(std::string& content, std::size_t size) {
+            while (pending.size() < size) {
+                if (!fill())
+                    return false;
+            }
+            content.assign(pending, 0, size);
+            pending.erase(0, size);
+            return true;
+        }
+
+        // write the whole response
+        bool write(std::string_view response) {
+            while (!response.empty()) {
+                const auto bytesWritten = ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+                if (bytesWritten == -1 && errno == EINTR)
+                    continue;
+                if (bytesWritten <= 0)
+                    return false;
+                response.remove_prefix(bytesWritten);
+            }
+            return true;
+        }
+
+    private:
+        // read more of the connection into the pending input
+        bool fill() {
+            char buffer[READ_SIZE];
+            ssize_t bytesRead = 0;
+            while ((bytesRead = ::read(fd, buffer, sizeof(buffer))) == -1 && errno == EINTR) {
+            }
+            if (bytesRead <= 0)
+                return false;
+            pending.append(buffer, bytesRead);
+            return true;
+        }
+
+        int fd;
+        std::string pending;
+    };
+
+    // facts of the srcML content as a partial result line
+    std::string parseRequest(std::string_view content) {
+        srcFactsHandler handler;
+        FactsXMLParser parser(content, handler);
+        parser.parse();
+        std::ostringstream response;
+        writePartialResult(response, makePartialResult("srcfacts"sv, handler.getUrl(), parser.getTotalBytes(), handler));
+        return response.str();
+    }
+
+    // handle the requests of the connection until it closes
+    void handleConnection(int fd, std::string& content) {
+        Connection connection(fd);
+
+        // parse errors go to the client, before the worker exits
+        dup2(fd, STDERR_FILENO);
+        std::string header;
+        while (connection.readLine(header)) {
+            std::string response;
+            if (header.compare(0, "XML "sv.size(), "XML "sv) == 0) {
+                const auto size = std::strtoull(header.c_str() + "XML "sv.size(), nullptr, 10);
+                if (size == 0 || size > MAX_REQUEST_SIZE) {
+                    response = "request error : Invalid content length\n";
+                } else if (!connection.readContent(content, size)) {
+                    break;
+                } else {
+                    // padding after the content allows fixed-size lookahead past its end
+                    content.append(xml_parser::PADDING, '\0');
+                    response = parseRequest(std::string_view(content.data(), size));
+                }
+            } else if (header.compare(0, "FILE "sv.size(), "FILE "sv) == 0) {
+                MappedFile file(header.substr("FILE "sv.size()));
+                if (file.getContent().empty())
+                    response = "request error : Empty file\n";
+                else
+                    response = parseRequest(file.getContent());
+            } else {
+                response = "request error : Unknown request\n";
+            }
+            if (!connection.write(response))
+                break;
+        }
+        close(fd);
+    }
+
+    // worker process, handling one connection at a time
+    // A read that waits longer than the idle timeout ends the connection
+    [[noreturn]] void runWorker(int listenFd, int idleSeconds) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+
+        // the content buffer stays allocated across requests
+        std::string content;
+        const int errorFd = dup(STDERR_FILENO);
+        while (true) {
+            const int fd = accept(listenFd, nullptr, nullptr);
+            if (fd == -1) {
+                if (errno == EINTR)
+                    continue;
+                std::cerr << "srcfactsd: accept failed, " << strerror(errno) << '\n';
+                _exit(1);
+            }
+            const timeval timeout{ idleSeconds, 0 };
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            handleConnection(fd, content);
+            dup2(errorFd, STDERR_FILENO);
+        }
+    }
+
+    // start a worker process
+    // @return Process id of the worker, or -1 when it did not start
+    pid_t startWorker(int listenFd, int idleSeconds) {
+        const auto pid = fork();
+        if (pid == 0)
+            runWorker(listenFd, idleSeconds);
+        if (pid == -1)
+            std::cerr << "srcfactsd: Unable to start a worker, " << strerror(errno) << '\n';
+        return pid;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    const char* socketPath = nullptr;
+    int workerCount = 4;
+    int idleSeconds = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workerCount = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--idle-timeout") == 0 && i + 1 < argc) {
+            idleSeconds = std::stoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !socketPath) {
+            socketPath = argv[i];
+        } else {
+            std::cerr << "srcfactsd: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (!socketPath || workerCount < 1 || idleSeconds < 1) {
+        std::cerr << "srcfactsd: Usage: srcfactsd socket [--workers N] [--idle-timeout SECONDS]\n";
+        return 1;
+    }
+
+    // listen on the socket, replacing a socket left by a previous daemon
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        std::cerr << "srcfactsd: Socket path is too long\n";
+        return 1;
+    }
+    strcpy(address.sun_path, socketPath);
+    const int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath);
+    if (listenFd == -1 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1
+        || listen(listenFd, SOMAXCONN) == -1) {
+        std::cerr << "srcfactsd: Unable to listen on " << socketPath << ", " << strerror(errno) << '\n';
+        return 1;
+    }
+
+    // stop on an interrupt, without SA_RESTART so the wait is interrupted
+    struct sigaction action{};
+    action.sa_handler = stop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    std::vector<pid_t> workers;
+    for (int i = 0; i < workerCount; ++i)
+        workers.push_back(startWorker(listenFd, idleSeconds));
+    std::clog << "srcfactsd: " << workerCount << " workers on " << socketPath << '\n';
+
+    // replace a worker that exits, e.g., on a parse error
+    int exitStatus = 0;
+    int startRetries = 0;
+    while (!stopping) {
+        const auto notStarted = std::count(workers.begin(), workers.end(), -1);
+        if (notStarted > 0) {
+            // without a running worker, the wait has no child, so the daemon waits for the
+            // backoff, and exits when the workers still do not start
+            if (notStarted == static_cast<long>(workers.size()) && startRetries == MAX_START_RETRIES) {
+                std::cerr << "srcfactsd: Unable to start any worker\n";
+                exitStatus = 1;
+                break;
+            }
+            sleep(1u << std::min(startRetries, MAX_START_RETRIES - 1));
+            for (auto& worker : workers) {
+                if (worker == -1)
+                    worker = startWorker(listenFd, idleSeconds);
+            }
+            const bool allStarted = std::find(workers.begin(), workers.end(), -1) == workers.end();
+            startRetries = allStarted ? 0 : std::min(startRetries + 1, MAX_START_RETRIES);
+            continue;
+        }
+
+        int status = 0;
+        const auto pid = wait(&status);
+        if (pid == -1)
+            continue;
+        for (auto& worker : workers) {
+            if (worker == pid)
+                worker = startWorker(listenFd, idleSeconds);
+        }
+    }
+
+    // a worker that did not start has no process, and kill() of -1 is of all processes
+    for (const auto worker : workers) {
+        if (worker != -1)
+            kill(worker, SIGTERM);
+    }
+    while (wait(nullptr) > 0) {
+    }
+    unlink(socketPath);
+
+    return exitStatus;
+}
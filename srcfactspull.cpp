@@ -0,0 +1,162 @@
+/*
+    srcfactspull.cpp
+
+    Produces the same report as srcfacts, with the pull API instead of a
+    handler with callbacks. The analysis is a loop over the events of an XML
+    cursor (see XMLCursor.hpp), with the counts in local variables. With the
+    option --generator, the events are the output of a pipeline of C++20
+    generator stages (see XMLEventGenerator.hpp), with a stage that keeps
+    only the events that srcFacts measures.
+
+    By default, the cursor is the stripped FactsXMLCursor. The option --full
+    uses the cursor with all features. To compare with the callbacks of
+    srcfacts on the same input:
+
+    srcfacts < archive.xml
+    srcfactspull < archive.xml
+    srcfactspull --generator < archive.xml
+*/
+
+#include <iostream>
+#include <algorithm>
+#include <string_view>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include "XMLCursor.hpp"
+#include "XMLEventGenerator.hpp"
+#include "reportFacts.hpp"
+#include "srcFactsHandler.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// counts of srcFacts, in the order of srcFactsHandler::COUNT_NAMES, and the url
+// Without the counts of the documents, the report has the files of the units
+struct Facts {
+    srcFactsHandler::Counts counts{};
+    std::string url;
+};
+
+// add the measures of the event to the facts
+void countEvent(const XMLEvent& event, Facts& facts) {
+    auto& [textSize, loc, exprCount, functionCount, classCount, unitCount,
+           declCount, commentCount, returnCount, lineCommentCount, stringCount,
+           documentCount, fileCount] = facts.counts;
+    switch (event.kind) {
+    case XMLEventKind::START_TAG:
+        if (event.localName == "expr"sv) {
+            ++exprCount;
+        } else if (event.localName == "decl"sv) {
+            ++declCount;
+        } else if (event.localName == "comment"sv) {
+            ++commentCount;
+        } else if (event.localName == "function"sv) {
+            ++functionCount;
+        } else if (event.localName == "unit"sv) {
+            ++unitCount;
+        } else if (event.localName == "class"sv) {
+            ++classCount;
+        } else if (event.localName == "return"sv) {
+            ++returnCount;
+        }
+        break;
+    case XMLEventKind::CHARACTERS:
+    case XMLEventKind::CDATA:
+        loc += static_cast<int>(std::count(event.value.cbegin(), event.value.cend(), '\n'));
+        textSize += static_cast<int>(event.value.size());
+        break;
+    case XMLEventKind::ATTRIBUTE:
+        if (event.localName == "url"sv) {
+            facts.url = event.value;
+        } else if (event.localName == "type"sv && event.value == "string"sv) {
+            ++stringCount;
+        } else if (event.localName == "type"sv && event.value == "line"sv) {
+            ++lineCommentCount;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// facts of the events of the cursor, in a loop
+template <class Cursor>
+Facts cursorFacts(Cursor& cursor) {
+    Facts facts;
+    while (const auto event = cursor.next())
+        countEvent(*event, facts);
+    return facts;
+}
+
+// stage of the pipeline with only the events that srcFacts measures
+Generator<const XMLEvent&> factEvents(Generator<const XMLEvent&> events) {
+    for (const auto& event : events) {
+        if (event.kind == XMLEventKind::START_TAG || event.kind == XMLEventKind::CHARACTERS
+            || event.kind == XMLEventKind::CDATA || event.kind == XMLEventKind::ATTRIBUTE)
+            co_yield event;
+    }
+}
+
+// facts of the events of the cursor, through the generator pipeline
+template <class Cursor>
+Facts generatorFacts(Cursor& cursor) {
+    Facts facts;
+    for (const auto& event : factEvents(xmlEvents(cursor)))
+        countEvent(event, facts);
+    return facts;
+}
+
+// facts of standard input with the cursor
+// @return Number of bytes parsed
+template <class Cursor>
+long parseFacts(Facts& facts, bool generator, bool validateUTF8, bool checkWellFormed) {
+    Cursor cursor(std::string_view{});
+    cursor.setValidateUTF8(validateUTF8);
+    cursor.setCheckWellFormed(checkWellFormed);
+    facts = generator ? generatorFacts(cursor) : cursorFacts(cursor);
+    return cursor.getTotalBytes();
+}
+
+int main(int argc, char* argv[]) {
+
+    bool fullParser = false;
+    bool generator = false;
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--full") == 0) {
+            fullParser = true;
+        } else if (strcmp(argv[i], "--generator") == 0) {
+            generator = true;
+        } else if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else {
+            std::cerr << "srcfactspull: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    Facts facts;
+    const auto totalBytes = fullParser ? parseFacts<XMLCursor>(facts, generator, validateUTF8, checkWellFormed)
+                                       : parseFacts<FactsXMLCursor>(facts, generator, validateUTF8, checkWellFormed);
+    const auto finishTime = std::chrono::steady_clock::now();
+
+    // report with the handler of srcfacts, so the report is the same
+    srcFactsHandler handler;
+    handler.addCounts(facts.counts);
+    const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+    const auto MLOCPerSecond = handler.getLoc() / elapsedSeconds / 1000000;
+    reportFacts(facts.url, handler, totalBytes);
+    std::clog.imbue(std::locale{""});
+    std::clog.precision(3);
+    std::clog << '\n';
+    std::clog << totalBytes  << " bytes\n";
+    std::clog << elapsedSeconds << " sec\n";
+    std::clog << MLOCPerSecond << " MLOC/sec\n";
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+    srcfilter.cpp
+
+    Filters srcML, e.g., to strip an archive before it is shipped to the next
+    stage. Input is an XML file in the srcML format on standard input, and
+    output is the filtered srcML on standard output. Performance statistics
+    are output to standard error.
+
+    The input between the changes is copied verbatim, not serialized from the
+    parse events (see FilterHandler.hpp), so without options the output is the
+    input, and the throughput is close to that of the parse. The options are:
+
+    --drop-attribute NAME   drop the attribute with the qualified name, e.g., pos:start
+    --drop-namespace PREFIX drop the namespace declaration, and the attributes and elements in it
+    --drop-element NAME     drop the element with the qualified name, with its content
+    --drop-comments         drop XML comments, and srcML comment elements
+    --drop-whitespace       drop whitespace-only text, which changes the source code
+    --rename OLD=NEW        rename the element with the qualified name OLD to NEW
+
+    E.g., to drop the position attributes of srcML with positions:
+
+    srcfilter --drop-namespace pos < archive.xml > stripped.xml
+*/
+
+#include <iostream>
+#include <string_view>
+#include <chrono>
+#include <cstring>
+#include "XMLParser.hpp"
+#include "FilterHandler.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+int main(int argc, char* argv[]) {
+
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    FilterHandler handler;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else if (strcmp(argv[i], "--drop-attribute") == 0 && i + 1 < argc) {
+            handler.dropAttribute(argv[++i]);
+        } else if (strcmp(argv[i], "--drop-namespace") == 0 && i + 1 < argc) {
+            handler.dropNamespace(argv[++i]);
+        } else if (strcmp(argv[i], "--drop-element") == 0 && i + 1 < argc) {
+            handler.dropElement(argv[++i]);
+        } else if (strcmp(argv[i], "--drop-comments") == 0) {
+            handler.dropComments();
+        } else if (strcmp(argv[i], "--drop-whitespace") == 0) {
+            handler.dropWhitespace();
+        } else if (strcmp(argv[i], "--rename") == 0 && i + 1 < argc) {
+            const std::string_view rename(argv[++i]);
+            const auto equalPosition = rename.find('=');
+            if (equalPosition == 0 || equalPosition == rename.npos || equalPosition + 1 == rename.size()) {
+                std::cerr << "srcfilter: Invalid rename " << rename << ", expected OLD=NEW\n";
+                return 1;
+            }
+            handler.renameElement(rename.substr(0, equalPosition), rename.substr(equalPosition + 1));
+        } else {
+            std::cerr << "srcfilter: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    FilterXMLParser parser(std::string_view{}, handler);
+    parser.setValidateUTF8(validateUTF8);
+    parser.setCheckWellFormed(checkWellFormed);
+    parser.parse();
+    std::cout.flush();
+    const auto totalBytes = parser.getTotalBytes();
+    const auto finishTime = std::chrono::steady_clock::now();
+    const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+    const auto MBPerSecond = totalBytes / elapsedSeconds / 1000000;
+
+    std::clog.imbue(std::locale{""});
+    std::clog.precision(3);
+    std::clog << totalBytes  << " bytes\n";
+    std::clog << handler.getOutputBytes() << " bytes output\n";
+    std::clog << handler.getDropCount() << " drops\n";
+    std::clog << elapsedSeconds << " sec\n";
+    std::clog << MBPerSecond << " MB/sec\n";
+
+    return 0;
+}
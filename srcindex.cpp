@@ -0,0 +1,101 @@
+/*
+    srcindex.cpp
+
+    Builds and queries the sidecar unit index of a srcML archive. The index
+    file is the archive filename with the extension .idx.
+
+    srcindex archive.xml                     Build the index
+    srcindex --list archive.xml              Markdown table of the units in the index
+    srcindex --extract filename archive.xml  Output the srcML of the unit with the filename
+    srcindex --verify archive.xml            Check the unit hashes against the archive
+
+    Except for the build, the archive is not read from the start, but each
+    unit is accessed directly at its offset.
+*/
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <cstring>
+#include "UnitIndex.hpp"
+
+int main(int argc, char* argv[]) {
+
+    bool list = false;
+    bool verify = false;
+    const char* extractFilename = nullptr;
+    const char* archiveFilename = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else if (strcmp(argv[i], "--extract") == 0 && i + 1 < argc) {
+            extractFilename = argv[++i];
+        } else if (argv[i][0] != '-' && !archiveFilename) {
+            archiveFilename = argv[i];
+        } else {
+            std::cerr << "srcindex: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (!archiveFilename) {
+        std::cerr << "srcindex: Missing srcML archive filename\n";
+        return 1;
+    }
+    const auto indexFilename = UnitIndex::indexFilename(archiveFilename);
+
+    // build the index
+    if (!list && !verify && !extractFilename) {
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto unitCount = UnitIndex::build(archiveFilename, indexFilename);
+        const auto finishTime = std::chrono::steady_clock::now();
+        const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+        std::clog.imbue(std::locale{""});
+        std::clog.precision(3);
+        std::clog << unitCount << " units indexed in " << indexFilename << '\n';
+        std::clog << elapsedSeconds << " sec\n";
+        return 0;
+    }
+
+    UnitIndex index(archiveFilename, indexFilename);
+
+    // output the srcML of a single unit
+    if (extractFilename) {
+        const auto position = index.findUnit(extractFilename);
+        if (!position) {
+            std::cerr << "srcindex: No unit with filename " << extractFilename << '\n';
+            return 1;
+        }
+        std::cout << index.getUnitContent(*position) << '\n';
+    }
+
+    // markdown table of the units
+    if (list) {
+        std::cout << "| Offset | Length | Language | Filename |\n";
+        std::cout << "|-------:|-------:|:---------|:---------|\n";
+        for (std::size_t position = 0; position < index.getUnitCount(); ++position) {
+            const auto unit = index.getUnit(position);
+            std::cout << "| " << unit.offset << " | " << unit.length << " | " << unit.language << " | " << unit.filename << " |\n";
+        }
+    }
+
+    // check the unit hashes against the archive
+    if (verify) {
+        std::size_t changed = 0;
+        for (std::size_t position = 0; position < index.getUnitCount(); ++position) {
+            if (index.hasChanged(position)) {
+                std::cerr << "srcindex: Unit " << position << " " << index.getUnit(position).filename << " has changed\n";
+                ++changed;
+            }
+        }
+        if (changed) {
+            std::cerr << "srcindex: " << changed << " changed units, rebuild the index\n";
+            return 1;
+        }
+        std::clog << index.getUnitCount() << " units verified\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+    srcmerge.cpp
+
+    Merges partial results, e.g., of the shards of a srcML archive, into the
+    report of the whole input. The partial results are from srcfacts or
+    xmlstats with the option --partial, all from the same application:
+
+    srcmerge shard0.json shard1.json shard2.json
+
+    The option --partial outputs the merged counts as a partial result again,
+    so partial results can be merged in stages.
+
+    Partial results of shards are all of the same archive and shard count, and
+    no shard is merged twice. The report requires all the shards, and a merged
+    partial result requires a range of shards without a gap.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include "partialResult.hpp"
+#include "srcFactsHandler.hpp"
+#include "XMLStatsHandler.hpp"
+#include "reportFacts.hpp"
+#include "reportXMLStats.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// sum the partial results in the handler, and output the merged partial result or the report
+template <class Handler, class Report>
+void mergePartialResults(const std::vector<PartialResult>& partials, bool partial, Report report) {
+    Handler handler;
+    std::string url;
+    long totalBytes = 0;
+    for (const auto& result : partials) {
+        addPartialResult(result, handler);
+        totalBytes += result.totalBytes;
+
+        // the url is from the root unit, in the first shard
+        if (url.empty())
+            url = result.url;
+    }
+    if (partial) {
+        // the shards are sorted, so the merged range is from the first to the last
+        auto result = makePartialResult(partials.front().tool, url, totalBytes, handler);
+        result.shardBegin = partials.front().shardBegin;
+        result.shardEnd = partials.back().shardEnd;
+        result.shardCount = partials.front().shardCount;
+        result.archiveSize = partials.front().archiveSize;
+        result.archiveHash = partials.front().archiveHash;
+        writePartialResult(std::cout, result);
+    } else
+        report(url, handler, totalBytes);
+}
+
+int main(int argc, char* argv[]) {
+
+    bool partial = false;
+    std::vector<std::string> filenames;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--partial") == 0) {
+            partial = true;
+        } else if (argv[i][0] != '-') {
+            filenames.push_back(argv[i]);
+        } else {
+            std::cerr << "srcmerge: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (filenames.empty()) {
+        std::cerr << "srcmerge: Missing partial result filenames\n";
+        return 1;
+    }
+
+    std::vector<PartialResult> partials;
+    for (const auto& filename : filenames) {
+        partials.push_back(readPartialResult(filename));
+        if (partials.back().tool != partials.front().tool) {
+            std::cerr << "srcmerge: Partial result " << filename << " is from " << partials.back().tool
+                      << ", not " << partials.front().tool << '\n';
+            return 1;
+        }
+        const auto& first = partials.front();
+        const auto& last = partials.back();
+        if (last.shardCount != first.shardCount || last.archiveSize != first.archiveSize || last.archiveHash != first.archiveHash) {
+            std::cerr << "srcmerge: Partial result " << filename << " is not of the same archive and shard count as "
+                      << filenames.front() << '\n';
+            return 1;
+        }
+    }
+
+    // the shards in order, with each shard once, and all of them for the report
+    if (partials.front().shardCount > 0) {
+        std::sort(partials.begin(), partials.end(), [](const PartialResult& a, const PartialResult& b) {
+            return a.shardBegin < b.shardBegin;
+        });
+        const auto shardCount = partials.front().shardCount;
+        int shardEnd = partial ? partials.front().shardBegin : 0;
+        for (const auto& result : partials) {
+            if (result.shardBegin < shardEnd) {
+                std::cerr << "srcmerge: Duplicate shard " << result.shardBegin << '/' << shardCount << '\n';
+                return 1;
+            }
+            if (result.shardBegin > shardEnd) {
+                std::cerr << "srcmerge: Missing shard " << shardEnd << '/' << shardCount << '\n';
+                return 1;
+            }
+            shardEnd = result.shardEnd;
+        }
+        if (!partial && shardEnd != shardCount) {
+            std::cerr << "srcmerge: Missing shard " << shardEnd << '/' << shardCount << '\n';
+            return 1;
+        }
+    }
+
+    const auto& tool = partials.front().tool;
+    if (tool == "srcfacts"sv) {
+        mergePartialResults<srcFactsHandler>(partials, partial, reportFacts);
+    } else if (tool == "xmlstats"sv) {
+        mergePartialResults<XMLStatsHandler>(partials, partial, [](std::string_view, XMLStatsHandler& handler, long totalBytes) {
+            reportXMLStats(handler, totalBytes);
+        });
+    } else {
+        std::cerr << "srcmerge: Unknown application " << tool << " of the partial results\n";
+        return 1;
+    }
+
+    std::clog.imbue(std::locale{""});
+    std::clog << '\n' << partials.size() << " partial results merged\n";
+
+    return 0;
+}
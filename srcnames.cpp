@@ -0,0 +1,160 @@
+/*
+    srcnames.cpp
+
+    Produces a report of the most frequent identifiers of source code. Input
+    is an XML file in the srcML format on standard input, and output is a
+    markdown table of the names with the largest counts. Performance
+    statistics are output to standard error.
+
+    An identifier is the text of a srcML name element with only text, so a
+    qualified name, e.g., std::string, is counted as its names std and string.
+
+    The option --top K outputs the K most frequent names, 20 by default.
+
+    The option --max-names N bounds the memory of the table of names to N names,
+    1,000,000 by default. When the input has more distinct names, a new name
+    replaces the name with the smallest count (see NameCounter.hpp), and the
+    report has a column with the most that each count may be over its true
+    count. A name that is more frequent than the bound allows is always reported:
+
+    srcnames --top 100 --max-names 100000 < archive.xml
+
+    With the option --threads N, a srcML archive is parsed by N threads, each
+    with its own table of names, and the tables are merged at the end. The
+    option --max-chunks bounds the chunks of units read ahead of the threads:
+
+    srcnames --threads 4 < archive.xml
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include "XMLParser.hpp"
+#include "parseParallel.hpp"
+#include "srcNamesHandler.hpp"
+
+// the name as a markdown table cell, with any | escaped, e.g., of operator|
+std::string markdownCell(std::string_view name) {
+    std::string cell;
+    for (const auto c : name) {
+        if (c == '|')
+            cell += '\\';
+        cell += c;
+    }
+    return cell;
+}
+
+/*
+    Output the markdown table of the most frequent names to standard output.
+
+    @param[in] url Url of the root unit
+    @param[in] names Counts of the names
+    @param[in] topCount Number of names in the table
+*/
+void reportNames(std::string_view url, const NameCounter& names, std::size_t topCount) {
+
+    const auto top = names.top(topCount);
+    const bool approximate = names.isApproximate();
+    std::vector<std::string> cells;
+    std::size_t nameWidth = 4;
+    for (const auto& each : top) {
+        cells.push_back(markdownCell(each.name));
+        nameWidth = std::max(nameWidth, cells.back().size());
+    }
+    std::cout.imbue(std::locale{""});
+    const auto rankWidth = 4;
+    const auto valueWidth = std::max(5, static_cast<int>(std::log10(std::max<double>(static_cast<double>(names.getTotal()), 1)) * 1.3 + 1));
+    std::cout << "# srcNames: " << url << '\n';
+    std::cout << "| " << std::setw(rankWidth) << "Rank" << " | " << std::left << std::setw(static_cast<int>(nameWidth)) << "Name" << std::right
+              << " | " << std::setw(valueWidth) << "Count" << " |";
+    if (approximate)
+        std::cout << ' ' << std::setw(valueWidth) << "Error" << " |";
+    std::cout << '\n';
+    std::cout << std::setfill('-') << '|' << std::setw(rankWidth + 2) << ':' << "|:" << std::setw(static_cast<int>(nameWidth) + 2) << '|'
+              << std::setw(valueWidth + 3) << ":|";
+    if (approximate)
+        std::cout << std::setw(valueWidth + 3) << ":|";
+    std::cout << std::setfill(' ') << '\n';
+    for (std::size_t i = 0; i < top.size(); ++i) {
+        std::cout << "| " << std::setw(rankWidth) << i + 1 << " | " << std::left << std::setw(static_cast<int>(nameWidth)) << cells[i] << std::right
+                  << " | " << std::setw(valueWidth) << top[i].count << " |";
+        if (approximate)
+            std::cout << ' ' << std::setw(valueWidth) << top[i].error << " |";
+        std::cout << '\n';
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    std::size_t topCount = 20;
+    std::size_t maxNames = 1000000;
+    int threadCount = 0;
+    std::size_t maxChunks = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            topCount = std::stoul(argv[++i]);
+        } else if (strcmp(argv[i], "--max-names") == 0 && i + 1 < argc) {
+            maxNames = std::stoul(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-chunks") == 0 && i + 1 < argc) {
+            maxChunks = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "srcnames: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (maxNames == 0 || maxNames >= UINT32_MAX) {
+        std::cerr << "srcnames: The option --max-names requires a positive count less than " << UINT32_MAX << '\n';
+        return 1;
+    }
+    if (threadCount < 0) {
+        std::cerr << "srcnames: The option --threads requires a positive count\n";
+        return 1;
+    }
+
+    // by default, each thread has a chunk being parsed and one waiting
+    if (maxChunks == 0)
+        maxChunks = 2 * static_cast<std::size_t>(threadCount);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    srcNamesHandler::setMaxNames(maxNames);
+    srcNamesHandler handler;
+    long totalBytes = 0;
+    if (threadCount > 0) {
+        // parse the units of standard input in parallel, with a table of names for each thread
+        totalBytes = parseParallel<NamesXMLParser>(handler, threadCount, maxChunks, validateUTF8, checkWellFormed);
+    } else {
+        NamesXMLParser parser(std::string_view{}, handler);
+        parser.setValidateUTF8(validateUTF8);
+        parser.setCheckWellFormed(checkWellFormed);
+        parser.parse();
+        totalBytes = parser.getTotalBytes();
+    }
+    const auto finishTime = std::chrono::steady_clock::now();
+    const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+    const auto& names = handler.getNames();
+    reportNames(handler.getUrl(), names, topCount);
+    std::clog.imbue(std::locale{""});
+    std::clog.precision(3);
+    std::clog << '\n';
+    std::clog << totalBytes  << " bytes\n";
+    std::clog << elapsedSeconds << " sec\n";
+    std::clog << names.getTotal() << " names, " << names.size() << " distinct"
+              << (names.isApproximate() ? ", more than --max-names, so the counts are approximate\n" : "\n");
+
+    return 0;
+}
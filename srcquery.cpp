@@ -0,0 +1,203 @@
+/*
+    srcquery.cpp
+
+    Client of the srcfactsd daemon, with a latency benchmark.
+
+    srcquery /tmp/srcfacts.socket demo.xml
+    srcquery /tmp/srcfacts.socket --send demo.xml < demo.xml
+
+    Without --send, the daemon reads the file itself. With --send, the srcML on
+    standard input is sent in the request. The response is the facts as a
+    partial result (see partialResult.hpp), which srcmerge reports.
+
+    srcquery /tmp/srcfacts.socket --bench 1000 --concurrency 4 demo.xml
+
+    The benchmark sends the request repeatedly from concurrent connections, and
+    reports the p50 and p99 latency per request. With --spawn, each request
+    instead runs a new process, e.g., srcfacts, for the comparison with the
+    startup of a process per input.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+
+    // connect to the daemon
+    int connectDaemon(const char* socketPath) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+            std::cerr << "srcquery: Unable to connect to " << socketPath << ", " << strerror(errno) << '\n';
+            exit(1);
+        }
+        return fd;
+    }
+
+    // send the request, and receive the response line
+    // @return false if the connection closed before the end of the response
+    bool query(int fd, std::string_view request, std::string& response) {
+        while (!request.empty()) {
+            const auto bytesWritten = ::send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+            if (bytesWritten <= 0)
+                return false;
+            request.remove_prefix(bytesWritten);
+        }
+        response.clear();
+        char buffer[4096];
+        while (response.empty() || response.back() != '\n') {
+            const auto bytesRead = ::read(fd, buffer, sizeof(buffer));
+            if (bytesRead <= 0)
+                return false;
+            response.append(buffer, bytesRead);
+        }
+        return true;
+    }
+
+    // run the program with the file as standard input, and wait for it
+    void spawnProgram(const char* program, const char* filename) {
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, filename, O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        char* const argv[] = { const_cast<char*>(program), nullptr };
+        pid_t pid;
+        if (posix_spawn(&pid, program, &actions, nullptr, argv, environ) != 0) {
+            std::cerr << "srcquery: Unable to run " << program << '\n';
+            exit(1);
+        }
+        posix_spawn_file_actions_destroy(&actions);
+        waitpid(pid, nullptr, 0);
+    }
+
+    // latency at the percentile of the sorted latencies
+    double percentile(const std::vector<double>& latencies, double percent) {
+        const auto index = static_cast<std::size_t>(percent / 100 * (latencies.size() - 1) + 0.5);
+        return latencies[index];
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    const char* socketPath = nullptr;
+    const char* filename = nullptr;
+    const char* spawnPath = nullptr;
+    bool sendContent = false;
+    int requestCount = 0;
+    int concurrency = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--send") == 0) {
+            sendContent = true;
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            requestCount = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--concurrency") == 0 && i + 1 < argc) {
+            concurrency = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--spawn") == 0 && i + 1 < argc) {
+            spawnPath = argv[++i];
+        } else if (argv[i][0] != '-' && !socketPath) {
+            socketPath = argv[i];
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            std::cerr << "srcquery: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (!socketPath || (!filename && !sendContent) || concurrency < 1 || (spawnPath && !filename)) {
+        std::cerr << "srcquery: Usage: srcquery socket [--send] [--bench N [--concurrency C] [--spawn program]] [file]\n";
+        return 1;
+    }
+
+    // the request is the same for every query
+    std::string request;
+    if (sendContent) {
+        std::string content(std::istreambuf_iterator<char>(std::cin), {});
+        request = "XML " + std::to_string(content.size()) + '\n' + content;
+    } else {
+        std::string path(filename);
+        if (path[0] != '/') {
+            char directory[4096];
+            if (getcwd(directory, sizeof(directory)))
+                path = std::string(directory) + '/' + path;
+        }
+        request = "FILE " + path + '\n';
+    }
+
+    // single query
+    if (requestCount == 0) {
+        const int fd = connectDaemon(socketPath);
+        std::string response;
+        const bool complete = query(fd, request, response);
+        std::cout << response;
+        close(fd);
+        return complete && response.front() == '{' ? 0 : 1;
+    }
+
+    // benchmark, with the requests divided among the concurrent connections
+    std::vector<std::vector<double>> threadLatencies(concurrency);
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed = false;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < concurrency; ++t) {
+        threads.emplace_back([&, t]() {
+            const int count = requestCount / concurrency + (t < requestCount % concurrency);
+            const int fd = spawnPath ? -1 : connectDaemon(socketPath);
+            std::string response;
+            for (int i = 0; i < count; ++i) {
+                const auto requestStart = std::chrono::steady_clock::now();
+                if (spawnPath) {
+                    spawnProgram(spawnPath, filename);
+                } else if (!query(fd, request, response) || response.front() != '{') {
+                    failed = true;
+                    break;
+                }
+                const std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - requestStart;
+                threadLatencies[t].push_back(latency.count());
+            }
+            if (fd != -1)
+                close(fd);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (failed) {
+        std::cerr << "srcquery: Request failed\n";
+        return 1;
+    }
+
+    std::vector<double> latencies;
+    for (const auto& oneLatencies : threadLatencies)
+        latencies.insert(latencies.end(), oneLatencies.begin(), oneLatencies.end());
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << (spawnPath ? spawnPath : "srcfactsd") << ": " << latencies.size() << " requests, "
+              << concurrency << " connections\n";
+    std::cout << "p50     " << std::setw(10) << percentile(latencies, 50) << " ms\n";
+    std::cout << "p99     " << std::setw(10) << percentile(latencies, 99) << " ms\n";
+    std::cout << "max     " << std::setw(10) << latencies.back() << " ms\n";
+    std::cout << std::setprecision(0);
+    std::cout << "rate    " << std::setw(10) << latencies.size() / elapsed.count() << " requests/s\n";
+
+    return 0;
+}
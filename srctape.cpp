@@ -0,0 +1,61 @@
+/*
+    srctape.cpp
+
+    Records the parsing events of the XML input to an event tape file. The
+    applications srcfacts, xmlstats, and identity replay the tape with the
+    option --tape, calling their handlers without parsing the XML again:
+
+    srctape archive.tape < archive.xml
+    srcfacts --tape archive.tape
+*/
+
+#include <iostream>
+#include <string_view>
+#include <chrono>
+#include <cstring>
+#include "XMLParser.hpp"
+#include "TapeWriterHandler.hpp"
+
+int main(int argc, char* argv[]) {
+
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    const char* tapeFilename = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else if (argv[i][0] != '-' && !tapeFilename) {
+            tapeFilename = argv[i];
+        } else {
+            std::cerr << "srctape: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (!tapeFilename) {
+        std::cerr << "srctape: Missing tape filename\n";
+        return 1;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::string_view content;
+    TapeWriterHandler handler(tapeFilename);
+    XMLParser parser(content, handler);
+    parser.setValidateUTF8(validateUTF8);
+    parser.setCheckWellFormed(checkWellFormed);
+
+    // parse XML
+    parser.parse();
+    handler.close(parser.getTotalBytes());
+
+    const auto finishTime = std::chrono::steady_clock::now();
+    const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+    std::clog.imbue(std::locale{""});
+    std::clog.precision(3);
+    std::clog << parser.getTotalBytes() << " bytes\n";
+    std::clog << handler.getEventCount() << " events recorded in " << tapeFilename << '\n';
+    std::clog << elapsedSeconds << " sec\n";
+
+    return 0;
+}
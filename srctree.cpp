@@ -0,0 +1,263 @@
+/*
+    srctree.cpp
+
+    Produces a report of the returns and the nesting depth of each function of
+    source code, an analysis with parent and child navigation. Input is an XML
+    file in the srcML format on standard input, and output is a markdown table
+    with the functions with the deepest nesting. Performance statistics are
+    output to standard error.
+
+    Each unit is built into a compact tree (see UnitTreeBuilder.hpp), one unit
+    at a time, and the functions of the unit are measured on the tree. The
+    returns of a function do not include the returns of a lambda, local class,
+    or nested function in it, and the nesting depth is of the control
+    statements, i.e., if, while, for, do, switch, and try.
+
+    The option --top K outputs the K functions with the deepest nesting, 10 by default:
+
+    srctree --top 20 < archive.xml
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <utility>
+#include <chrono>
+#include <cstring>
+#include "XMLParser.hpp"
+#include "UnitTreeBuilder.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// measures of a function
+struct FunctionMeasures {
+    int depth;
+    int returns;
+    std::string name;
+    std::string filename;
+};
+
+// analysis of the functions of each unit tree
+class FunctionAnalysis : public UnitTreeBuilder {
+public:
+    // constructor, with the number of functions with the deepest nesting to keep
+    FunctionAnalysis(std::size_t topCount);
+
+    // get the number of functions
+    long getFunctionCount() { return functionCount; }
+
+    // get the number of returns of all the functions
+    long getReturnCount() { return returnCount; }
+
+    // get the largest number of nodes of a unit tree
+    std::uint32_t getMaxNodes() { return maxNodes; }
+
+    // functions with the deepest nesting, deepest first
+    std::vector<FunctionMeasures> getTop();
+
+protected:
+    // measure the functions of the unit
+    void handleUnit(const UnitTree& tree) override;
+
+private:
+    // returns and nesting depth of the function, without its nested functions
+    std::pair<int, int> measure(const UnitTree& tree, std::uint32_t function);
+
+    // whether the element is a function
+    bool isFunction(std::uint32_t name) {
+        return name == functionName || name == constructorName || name == destructorName;
+    }
+
+    // whether the element has functions of its own in it
+    bool isNestedScope(std::uint32_t name) {
+        return isFunction(name) || name == lambdaName || name == className || name == structName;
+    }
+
+    // whether the element is a control statement
+    bool isControl(std::uint32_t name) {
+        return name == ifName || name == whileName || name == forName || name == doName
+            || name == switchName || name == tryName;
+    }
+
+    // data members
+    std::size_t topCount;
+    std::vector<FunctionMeasures> top;
+
+    long functionCount;
+    long returnCount;
+    std::uint32_t maxNodes;
+
+    // nodes to visit, with their nesting depth
+    std::vector<std::pair<std::uint32_t, int>> stack;
+
+    // numbers of the names
+    std::uint32_t functionName;
+    std::uint32_t constructorName;
+    std::uint32_t destructorName;
+    std::uint32_t lambdaName;
+    std::uint32_t className;
+    std::uint32_t structName;
+    std::uint32_t ifName;
+    std::uint32_t whileName;
+    std::uint32_t forName;
+    std::uint32_t doName;
+    std::uint32_t switchName;
+    std::uint32_t tryName;
+    std::uint32_t returnName;
+    std::uint32_t nameName;
+    std::uint32_t filenameName;
+};
+
+// the deeper nesting first, then the most returns
+bool deeper(const FunctionMeasures& a, const FunctionMeasures& b) {
+    return a.depth != b.depth ? a.depth > b.depth : a.returns > b.returns;
+}
+
+// constructor, with the number of functions with the deepest nesting to keep
+FunctionAnalysis::FunctionAnalysis(std::size_t topCount)
+    : topCount(topCount), functionCount(0), returnCount(0), maxNodes(0) {
+    auto& names = getNames();
+    functionName = names.intern("function"sv);
+    constructorName = names.intern("constructor"sv);
+    destructorName = names.intern("destructor"sv);
+    lambdaName = names.intern("lambda"sv);
+    className = names.intern("class"sv);
+    structName = names.intern("struct"sv);
+    ifName = names.intern("if_stmt"sv);
+    whileName = names.intern("while"sv);
+    forName = names.intern("for"sv);
+    doName = names.intern("do"sv);
+    switchName = names.intern("switch"sv);
+    tryName = names.intern("try"sv);
+    returnName = names.intern("return"sv);
+    nameName = names.intern("name"sv);
+    filenameName = names.intern("filename"sv);
+}
+
+// functions with the deepest nesting, deepest first
+std::vector<FunctionMeasures> FunctionAnalysis::getTop() {
+    std::sort(top.begin(), top.end(), deeper);
+    if (top.size() > topCount)
+        top.resize(topCount);
+    return top;
+}
+
+// measure the functions of the unit
+void FunctionAnalysis::handleUnit(const UnitTree& tree) {
+
+    maxNodes = std::max(maxNodes, tree.size());
+    const auto filename = tree.getAttribute(0, filenameName).value_or(""sv);
+
+    // the nodes are in document order, so a function is found before the functions in it
+    for (std::uint32_t node = 0; node < tree.size(); ++node) {
+        if (tree[node].kind != UnitNodeKind::ELEMENT || !isFunction(tree[node].name))
+            continue;
+
+        ++functionCount;
+        const auto [returns, depth] = measure(tree, node);
+        returnCount += returns;
+        if (topCount == 0)
+            continue;
+
+        // only the names of the functions that may be in the report are copied
+        if (top.size() == topCount && !deeper(FunctionMeasures{ depth, returns, {}, {} }, top.back()))
+            continue;
+        std::string name;
+        for (auto child = tree[node].firstChild; child != UnitTree::NONE; child = tree[child].nextSibling) {
+            if (tree[child].kind == UnitNodeKind::ELEMENT && tree[child].name == nameName) {
+                name = tree.getAllText(child);
+                break;
+            }
+        }
+        if (top.size() == topCount)
+            top.pop_back();
+        top.push_back(FunctionMeasures{ depth, returns, std::move(name), std::string(filename) });
+        std::sort(top.begin(), top.end(), deeper);
+    }
+}
+
+// returns and nesting depth of the function, without its nested functions
+std::pair<int, int> FunctionAnalysis::measure(const UnitTree& tree, std::uint32_t function) {
+
+    int returns = 0;
+    int maxDepth = 0;
+    stack.clear();
+    stack.emplace_back(function, 0);
+    while (!stack.empty()) {
+        const auto [node, depth] = stack.back();
+        stack.pop_back();
+        for (auto child = tree[node].firstChild; child != UnitTree::NONE; child = tree[child].nextSibling) {
+            const auto& each = tree[child];
+            if (each.kind != UnitNodeKind::ELEMENT || isNestedScope(each.name))
+                continue;
+            if (each.name == returnName)
+                ++returns;
+            const auto childDepth = isControl(each.name) ? depth + 1 : depth;
+            maxDepth = std::max(maxDepth, childDepth);
+            stack.emplace_back(child, childDepth);
+        }
+    }
+
+    return { returns, maxDepth };
+}
+
+int main(int argc, char* argv[]) {
+
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    std::size_t topCount = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            topCount = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "srctree: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    FunctionAnalysis analysis(topCount);
+    TreeXMLParser parser(std::string_view{}, analysis);
+    parser.setValidateUTF8(validateUTF8);
+    parser.setCheckWellFormed(checkWellFormed);
+    parser.parse();
+    const auto totalBytes = parser.getTotalBytes();
+    const auto finishTime = std::chrono::steady_clock::now();
+    const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
+
+    // report of the functions with the deepest nesting
+    const auto top = analysis.getTop();
+    std::size_t nameWidth = 8;
+    std::size_t filenameWidth = 4;
+    for (const auto& each : top) {
+        nameWidth = std::max(nameWidth, each.name.size());
+        filenameWidth = std::max(filenameWidth, each.filename.size());
+    }
+    std::cout.imbue(std::locale{""});
+    std::cout << "# srcTree: " << analysis.getFunctionCount() << " functions, " << analysis.getReturnCount() << " returns\n";
+    std::cout << "| Depth | Returns | " << std::left << std::setw(static_cast<int>(nameWidth)) << "Function" << " | "
+              << std::setw(static_cast<int>(filenameWidth)) << "File" << std::right << " |\n";
+    std::cout << "|------:|--------:|:" << std::setfill('-') << std::setw(static_cast<int>(nameWidth) + 2) << '|'
+              << ':' << std::setw(static_cast<int>(filenameWidth) + 2) << '|' << std::setfill(' ') << '\n';
+    for (const auto& each : top) {
+        std::cout << "| " << std::setw(5) << each.depth << " | " << std::setw(7) << each.returns << " | " << std::left
+                  << std::setw(static_cast<int>(nameWidth)) << each.name << " | " << std::setw(static_cast<int>(filenameWidth))
+                  << each.filename << std::right << " |\n";
+    }
+    std::clog.imbue(std::locale{""});
+    std::clog.precision(3);
+    std::clog << '\n';
+    std::clog << totalBytes  << " bytes\n";
+    std::clog << elapsedSeconds << " sec\n";
+    std::clog << analysis.getUnitCount() << " unit trees, at most " << analysis.getMaxNodes() << " nodes\n";
+
+    return 0;
+}
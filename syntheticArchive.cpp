@@ -0,0 +1,24 @@
+/*
+    syntheticArchive.cpp
+
+    Implementation file for the syntheticArchive function
+*/
+
+#include "syntheticArchive.hpp"
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+// synthetic srcML archive of at least the size from copies of the document
+std::string syntheticArchive(std::string_view document, std::size_t size) {
+
+    if (document.substr(0, "<?xml"sv.size()) == "<?xml"sv && document.find("?>"sv) != document.npos)
+        document.remove_prefix(document.find("?>"sv) + "?>"sv.size());
+    std::string archive(R"(<?xml version="1.0" encoding="UTF-8" standalone="yes"?>)" "\n"
+                        R"(<unit xmlns="http://www.srcML.org/srcML/src" revision="1.0.0">)");
+    archive.reserve(size + document.size() + "</unit>\n"sv.size());
+    while (archive.size() < size && !document.empty())
+        archive += document;
+    archive += "</unit>\n"sv;
+    return archive;
+}
@@ -0,0 +1,27 @@
+/*
+    syntheticArchive.hpp
+
+    Include file for the syntheticArchive function
+*/
+
+#ifndef INCLUDED_SYNTHETICARCHIVE_HPP
+#define INCLUDED_SYNTHETICARCHIVE_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/*
+    Synthetic srcML archive from copies of a document.
+
+    The copies, without their XML declaration, are the units of a root unit,
+    so the archive is the same for the same document and size, e.g., for a
+    benchmark.
+
+    @param[in] document Document to copy, e.g., a srcML unit
+    @param[in] size Size of the archive, at least
+    @return Archive with the copies of the document
+*/
+[[nodiscard]] std::string syntheticArchive(std::string_view document, std::size_t size);
+
+#endif
@@ -1,78 +1,640 @@
 /*
     xml_parser.hpp
 
-    Include file for low-level XML parse functions
+    Header-only tokenizer core of low-level XML parse functions.
+
+    Each function works on a view of the unparsed content, consumes the
+    token at the front of the view, and returns the parts of the token.
+    There is no global state, so any number of parsers may use these
+    functions concurrently. Refilling the content is left to the caller.
 */
 
 #ifndef INCLUDED_XML_PARSER_HPP
 #define INCLUDED_XML_PARSER_HPP
 
 #include <string_view>
+#include <optional>
 #include <utility>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
 
 namespace xml_parser {
 
-    // parse XML declaration
-    void parseXMLDeclaration(std::string_view& content);
+    // provides literal string operator""sv
+    using namespace std::literals::string_view_literals;
 
-    // parse required version
-    void parseVersion(std::string_view& content);
+    constexpr auto WHITESPACE = " \n\t\r"sv;
+    constexpr auto NAMEEND = "> /\":=\n\t\r"sv;
 
-    // parse optional encoding and standalone attributes
-    void parseEncodingAndStandalone(std::string_view& content);
+    // number of readable bytes guaranteed after the end of refilled content
+    constexpr int PADDING = 16;
 
-    //parse DOCTYPE
-    void parseDOCTYPE(std::string_view& content);
+    // character classes, as bits in the character class table
+    constexpr unsigned char NAME_CHARACTER = 1 << 0;
+    constexpr unsigned char WHITESPACE_CHARACTER = 1 << 1;
+    constexpr unsigned char NAMEEND_CHARACTER = 1 << 2;
+    constexpr unsigned char TEXTEND_CHARACTER = 1 << 3;
+    constexpr unsigned char QNAMEEND_CHARACTER = 1 << 4;
+    constexpr unsigned char TAGDELIMITER_CHARACTER = 1 << 5;
 
-    // refill content preserving unprocessed
-    int refillPreserve(std::string_view& content, bool& doneReading);
+    // character class table for all 256 byte values
+    constexpr std::array<unsigned char, 256> CHARACTER_CLASS = [] {
+        std::array<unsigned char, 256> table{};
+        for (int c = 0; c < 256; ++c) {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.' || c >= 0x80)
+                table[c] |= NAME_CHARACTER;
+        }
+        for (const auto c : WHITESPACE)
+            table[static_cast<unsigned char>(c)] |= WHITESPACE_CHARACTER;
+        for (const auto c : NAMEEND) {
+            table[static_cast<unsigned char>(c)] |= NAMEEND_CHARACTER;
+            if (c != ':')
+                table[static_cast<unsigned char>(c)] |= QNAMEEND_CHARACTER;
+        }
+        table[static_cast<unsigned char>('<')] |= TEXTEND_CHARACTER;
+        table[static_cast<unsigned char>('&')] |= TEXTEND_CHARACTER;
+        table[static_cast<unsigned char>('>')] |= TAGDELIMITER_CHARACTER;
+        table[static_cast<unsigned char>('"')] |= TAGDELIMITER_CHARACTER;
+        table[static_cast<unsigned char>('\'')] |= TAGDELIMITER_CHARACTER;
+        return table;
+    }();
 
-    // parse character entity references
-    void parseCharacterEntityReference(std::string_view& content);
+    // Accessor::predicate to check if a character is in a character class
+    constexpr bool isClass(char c, unsigned char characterClass) {
+        return CHARACTER_CLASS[static_cast<unsigned char>(c)] & characterClass;
+    }
 
-    // parse character non-entity references
-    std::string_view parseCharacterNotEntityReference(std::string_view& content);
+    // position of the first character in the character class, or npos
+    constexpr std::size_t findClass(std::string_view content, unsigned char characterClass, std::size_t pos = 0) {
+        for (; pos < content.size(); ++pos) {
+            if (isClass(content[pos], characterClass))
+                return pos;
+        }
+        return content.npos;
+    }
 
-    // parse XML comment
-    int parseComment(std::string_view& content, bool& doneReading);
+    // position of the first character not in the character class, or npos
+    constexpr std::size_t findNotClass(std::string_view content, unsigned char characterClass, std::size_t pos = 0) {
+        for (; pos < content.size(); ++pos) {
+            if (!isClass(content[pos], characterClass))
+                return pos;
+        }
+        return content.npos;
+    }
 
-    // parse CDATA
-    std::pair<int, std::string_view> parseCDATA(std::string_view& content, bool& doneReading);
+    // remove leading whitespace, including when the content is all whitespace
+    inline void skipWhitespace(std::string_view& content) {
+        const auto nonWhitespacePosition = findNotClass(content, WHITESPACE_CHARACTER);
+        content.remove_prefix(nonWhitespacePosition == content.npos ? content.size() : nonWhitespacePosition);
+    }
 
-    // parse processing instruction
-    void parseProcessing(std::string_view& content);
+    // load 8 bytes as a single word
+    inline std::uint64_t load8(const char* p) {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return word;
+    }
 
-    // parse end tag
-    void parseEndTag(std::string_view& content);
+    // load 4 bytes as a single word
+    inline std::uint32_t load4(const char* p) {
+        std::uint32_t word;
+        std::memcpy(&word, p, sizeof(word));
+        return word;
+    }
 
-    // parse start tag
-    std::size_t parseStartTag(std::string_view& content, std::string_view& qName, std::string_view& prefix, std::string_view& localName);
+    // Accessor::predicate to test if the content starts with a literal of 8 to 16 characters
+    // Compares two, possibly overlapping, 8-byte words instead of character by character
+    template <std::size_t N>
+    inline bool startsWith(std::string_view content, const char (&literal)[N]) {
+        constexpr std::size_t length = N - 1;
+        static_assert(length >= 8 && length <= 16, "SWAR compare is for literals of 8 to 16 characters");
+        return content.size() >= length
+            && load8(content.data()) == load8(literal)
+            && load8(content.data() + length - 8) == load8(literal + length - 8);
+    }
 
-    // parse XML namespace
-    void parseNamespace(std::string_view& content);
+    // position of the end of character content, i.e., the next '<' or '&', or npos
+    // Checks 8 bytes at a time for either character before locating it
+    inline std::size_t findTextEnd(std::string_view content) {
+        constexpr std::uint64_t ONES = 0x0101010101010101ULL;
+        constexpr std::uint64_t HIGHS = 0x8080808080808080ULL;
+        std::size_t pos = 0;
+        for (; pos + 8 <= content.size(); pos += 8) {
+            const auto word = load8(content.data() + pos);
+            const auto lessThan = word ^ (ONES * '<');
+            const auto ampersand = word ^ (ONES * '&');
+            if (((lessThan - ONES) & ~lessThan & HIGHS) | ((ampersand - ONES) & ~ampersand & HIGHS))
+                break;
+        }
+        return findClass(content, TEXTEND_CHARACTER, pos);
+    }
+
+    // position of the next delimiter in a tag, i.e., the end of the tag or the start of an attribute value: '>', '"', or '\'', or npos
+    // Checks 8 bytes at a time for any of the characters before locating it
+    inline std::size_t findTagDelimiter(std::string_view content, std::size_t pos = 0) {
+        constexpr std::uint64_t ONES = 0x0101010101010101ULL;
+        constexpr std::uint64_t HIGHS = 0x8080808080808080ULL;
+        for (; pos + 8 <= content.size(); pos += 8) {
+            const auto word = load8(content.data() + pos);
+            const auto greaterThan = word ^ (ONES * '>');
+            const auto doubleQuote = word ^ (ONES * '"');
+            const auto singleQuote = word ^ (ONES * '\'');
+            if (((greaterThan - ONES) & ~greaterThan & HIGHS) | ((doubleQuote - ONES) & ~doubleQuote & HIGHS)
+                | ((singleQuote - ONES) & ~singleQuote & HIGHS))
+                break;
+        }
+        return findClass(content, TAGDELIMITER_CHARACTER, pos);
+    }
+
+    // hash of a name, 8 bytes at a time
+    // The last 1 to 7 bytes are from overlapping fixed-size loads, as a copy of a
+    // variable size is a call. The size is in the hash, so the overlap is unambiguous
+    inline std::uint64_t hashName(std::string_view name) {
+        constexpr std::uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+        std::uint64_t hash = name.size() * MULTIPLIER;
+        std::size_t pos = 0;
+        for (; pos + 8 <= name.size(); pos += 8)
+            hash = (hash ^ load8(name.data() + pos)) * MULTIPLIER;
+        const auto rest = name.size() - pos;
+        if (rest != 0) {
+            const char* const last = name.data() + pos;
+            const auto word = rest >= 4 ? (static_cast<std::uint64_t>(load4(last)) << 32) | load4(last + rest - 4)
+                                        : (static_cast<std::uint64_t>(static_cast<unsigned char>(last[0])) << 16)
+                                          | (static_cast<std::uint64_t>(static_cast<unsigned char>(last[rest / 2])) << 8)
+                                          | static_cast<unsigned char>(last[rest - 1]);
+            hash = (hash ^ word) * MULTIPLIER;
+        }
+        return hash ^ (hash >> 32);
+    }
+
+    // kinds of tokens that can start at the front of the content
+    enum class Token : unsigned char { CHARACTERS, ENTITY_REFERENCE, START_TAG, END_TAG, PROCESSING_INSTRUCTION, DECLARATION };
 
-    // parse attribute
-    std::string_view parseAttribute(std::string_view& content);
+    // token kind by the first character
+    constexpr std::array<Token, 256> FIRST_CHARACTER_TOKEN = [] {
+        std::array<Token, 256> table{};
+        for (auto& token : table)
+            token = Token::CHARACTERS;
+        table[static_cast<unsigned char>('&')] = Token::ENTITY_REFERENCE;
+        table[static_cast<unsigned char>('<')] = Token::START_TAG;
+        return table;
+    }();
+
+    // token kind of markup by the character after the '<'
+    constexpr std::array<Token, 256> MARKUP_TOKEN = [] {
+        std::array<Token, 256> table{};
+        for (auto& token : table)
+            token = Token::START_TAG;
+        table[static_cast<unsigned char>('/')] = Token::END_TAG;
+        table[static_cast<unsigned char>('?')] = Token::PROCESSING_INSTRUCTION;
+        table[static_cast<unsigned char>('!')] = Token::DECLARATION;
+        return table;
+    }();
+
+    // kind of token at the front of the content
+    constexpr Token tokenKind(std::string_view content) {
+        const auto token = FIRST_CHARACTER_TOKEN[static_cast<unsigned char>(content[0])];
+        return token != Token::START_TAG ? token : MARKUP_TOKEN[static_cast<unsigned char>(content[1])];
+    }
+
+    // Accessor::predicate to check if content has a specific character at a specific index
+    constexpr bool isCharacter(std::string_view content, int index, char character) {
+        return content[index] == character;
+    }
 
     // Accessor::predicate to test if the tag is a XML declaration
-    bool isXML(std::string_view content);
+    constexpr bool isXML(std::string_view content) {
+        return content[0] == '<' && content[1] == '?' && content[2] == 'x' && content[3] == 'm' && content[4] == 'l' && content[5] == ' ';
+    }
 
     // Accessor::predicate to test if the tag is DOCTYPE
-    bool isDOCTYPE(std::string_view content);
+    inline bool isDOCTYPE(std::string_view content) {
+        return startsWith(content, "<!DOCTYPE ");
+    }
 
     // Accessor::predicate to test if the tag is CDATA
-    bool isCDATA(std::string_view content);
+    inline bool isCDATA(std::string_view content) {
+        return startsWith(content, "<![CDATA[");
+    }
 
     // Accessor::predicate to test if the tag is a comment tag
-    bool isComment(std::string_view content);
+    constexpr bool isComment(std::string_view content) {
+        return !content.empty() && content[0] == '<' && content[1] == '!' && content[2] == '-' && content[3] == '-';
+    }
 
     // Accessor::predicate to test if the tag is an XML namespace
-    bool isNamespace(std::string_view content);
+    constexpr bool isNamespace(std::string_view content) {
+        return content[0] == 'x' && content[1] == 'm' && content[2] == 'l' && content[3] == 'n' && content[4] == 's' && (content[5] == ':' || content[5] == '=');
+    }
 
-    // parse file from the start
-    int parseBegin(std::string_view& content);
+    // parse required version
+    inline void parseVersion(std::string_view& content, std::string_view& version) {
+        const auto nameEndPosition = content.find_first_of("= ");
+        const auto attr(content.substr(0, nameEndPosition));
+        content.remove_prefix(nameEndPosition);
+        skipWhitespace(content);
+        content.remove_prefix("="sv.size());
+        skipWhitespace(content);
+        const auto delimiter = content[0];
+        if (delimiter != '"' && delimiter != '\'') {
+            std::cerr << "parser error: Invalid start delimiter for version in XML declaration\n";
+            exit(1);
+        }
+        content.remove_prefix("\""sv.size());
+        const auto valueEndPosition = content.find(delimiter);
+        if (valueEndPosition == content.npos) {
+            std::cerr << "parser error: Invalid end delimiter for version in XML declaration\n";
+            exit(1);
+        }
+        if (attr != "version"sv) {
+            std::cerr << "parser error: Missing required first attribute version in XML declaration\n";
+            exit(1);
+        }
+        version = content.substr(0, valueEndPosition);
+        content.remove_prefix(valueEndPosition);
+        content.remove_prefix("\""sv.size());
+        skipWhitespace(content);
+    }
 
-    // Accessor::predicate to check if content has a specific character at a specific index
-    bool isCharacter(std::string_view& content, int index, char character);
+    // parse optional attribute of the XML declaration with the given name
+    inline void parseDeclarationAttribute(std::string_view& content, std::string_view name, std::optional<std::string_view>& value) {
+        if (content[0] == '?')
+            return;
+        const auto nameEndPosition = content.find_first_of("= ");
+        if (nameEndPosition == content.npos) {
+            std::cerr << "parser error: Incomplete attribute in XML declaration\n";
+            exit(1);
+        }
+        const auto attr(content.substr(0, nameEndPosition));
+        if (attr != name) {
+            // not this attribute, leave it for the next one
+            return;
+        }
+        content.remove_prefix(nameEndPosition);
+        skipWhitespace(content);
+        if (content[0] != '=') {
+            std::cerr << "parser error: Missing = for attribute " << attr << " in XML declaration\n";
+            exit(1);
+        }
+        content.remove_prefix("="sv.size());
+        skipWhitespace(content);
+        const auto delimiter = content[0];
+        if (delimiter != '"' && delimiter != '\'') {
+            std::cerr << "parser error: Invalid end delimiter for attribute " << attr << " in XML declaration\n";
+            exit(1);
+        }
+        content.remove_prefix("\""sv.size());
+        const auto valueEndPosition = content.find(delimiter);
+        if (valueEndPosition == content.npos) {
+            std::cerr << "parser error: Incomplete attribute " << attr << " in XML declaration\n";
+            exit(1);
+        }
+        value = content.substr(0, valueEndPosition);
+        content.remove_prefix(valueEndPosition + 1);
+        skipWhitespace(content);
+    }
+
+    // parse XML declaration
+    inline void parseXMLDeclaration(std::string_view& content, std::string_view& version, std::optional<std::string_view>& encoding, std::optional<std::string_view>& standalone) {
+        assert(content.compare(0, "<?xml "sv.size(), "<?xml "sv) == 0);
+        content.remove_prefix("<?xml"sv.size());
+        skipWhitespace(content);
+
+        // parse required version
+        parseVersion(content, version);
+
+        // parse optional encoding attribute
+        parseDeclarationAttribute(content, "encoding"sv, encoding);
+
+        // parse optional standalone attribute
+        parseDeclarationAttribute(content, "standalone"sv, standalone);
+
+        if (content.compare(0, "?>"sv.size(), "?>"sv) != 0) {
+            std::cerr << "parser error: Invalid attribute " << content.substr(0, content.find_first_of("= ")) << " in XML declaration\n";
+            exit(1);
+        }
+        content.remove_prefix("?>"sv.size());
+        skipWhitespace(content);
+    }
+
+    // position of the '>' that ends the DOCTYPE, after nested declarations, quoted
+    // literals, and comments, or npos if the end of the DOCTYPE is not in the content
+    inline std::size_t findDOCTYPEEnd(std::string_view content) {
+        assert(content.compare(0, "<!DOCTYPE "sv.size(), "<!DOCTYPE "sv) == 0);
+        int depthAngleBrackets = 1;
+        bool inSingleQuote = false;
+        bool inDoubleQuote = false;
+        bool inComment = false;
+        std::size_t p = "<!DOCTYPE"sv.size();
+        while ((p = content.find_first_of("<>'\"-"sv, p)) != content.npos) {
+            if (content.compare(p, "<!--"sv.size(), "<!--"sv) == 0) {
+                inComment = true;
+                p += "<!--"sv.size();
+                continue;
+            } else if (content.compare(p, "-->"sv.size(), "-->"sv) == 0) {
+                inComment = false;
+                p += "-->"sv.size();
+                continue;
+            }
+            if (inComment) {
+                ++p;
+                continue;
+            }
+            if (content[p] == '<' && !inSingleQuote && !inDoubleQuote) {
+                ++depthAngleBrackets;
+            } else if (content[p] == '>' && !inSingleQuote && !inDoubleQuote) {
+                --depthAngleBrackets;
+            } else if (content[p] == '\'') {
+                inSingleQuote = !inSingleQuote;
+            } else if (content[p] == '"') {
+                inDoubleQuote = !inDoubleQuote;
+            }
+            if (depthAngleBrackets == 0)
+                break;
+            ++p;
+        }
+        return p;
+    }
+
+    // parse DOCTYPE, returning the contents
+    inline std::string_view parseDOCTYPE(std::string_view& content) {
+        const auto tagEndPosition = findDOCTYPEEnd(content);
+        if (tagEndPosition == content.npos) {
+            std::cerr << "parser error : Unterminated DOCTYPE\n";
+            exit(1);
+        }
+        const auto contents(content.substr("<!DOCTYPE"sv.size(), tagEndPosition - "<!DOCTYPE"sv.size()));
+        content.remove_prefix(tagEndPosition);
+        assert(content[0] == '>');
+        content.remove_prefix(">"sv.size());
+        skipWhitespace(content);
+        return contents;
+    }
+
+    // parse character entity references
+    inline std::string_view parseCharacterEntityReference(std::string_view& content) {
+        std::string_view unescapedCharacter;
+        std::string_view escapedCharacter;
+        if (content[1] == 'l' && content[2] == 't' && content[3] == ';') {
+            unescapedCharacter = "<"sv;
+            escapedCharacter = "&lt;"sv;
+        } else if (content[1] == 'g' && content[2] == 't' && content[3] == ';') {
+            unescapedCharacter = ">"sv;
+            escapedCharacter = "&gt;"sv;
+        } else if (content[1] == 'a' && content[2] == 'm' && content[3] == 'p' && content[4] == ';') {
+            unescapedCharacter = "&"sv;
+            escapedCharacter = "&amp;"sv;
+        } else {
+            unescapedCharacter = "&"sv;
+            escapedCharacter = "&"sv;
+        }
+        assert(content.compare(0, escapedCharacter.size(), escapedCharacter) == 0);
+        content.remove_prefix(escapedCharacter.size());
+        return unescapedCharacter;
+    }
+
+    // parse character non-entity references
+    inline std::string_view parseCharacterNotEntityReference(std::string_view& content) {
+        assert(content[0] != '<' && content[0] != '&');
+        const auto characterEndPosition = findTextEnd(content);
+        const auto characters(content.substr(0, characterEndPosition));
+        content.remove_prefix(characters.size());
+        return characters;
+    }
+
+    // parse XML comment, or no value if the end of the comment is not in the content
+    inline std::optional<std::string_view> parseComment(std::string_view& content) {
+        assert(content.compare(0, "<!--"sv.size(), "<!--"sv) == 0);
+        const auto tagEndPosition = content.find("-->"sv, "<!--"sv.size());
+        if (tagEndPosition == content.npos)
+            return std::nullopt;
+        const auto comment(content.substr("<!--"sv.size(), tagEndPosition - "<!--"sv.size()));
+        content.remove_prefix(tagEndPosition + "-->"sv.size());
+        skipWhitespace(content);
+        return comment;
+    }
+
+    // parse CDATA, or no value if the end of the CDATA is not in the content
+    inline std::optional<std::string_view> parseCDATA(std::string_view& content) {
+        assert(content.compare(0, "<![CDATA["sv.size(), "<![CDATA["sv) == 0);
+        const auto tagEndPosition = content.find("]]>"sv, "<![CDATA["sv.size());
+        if (tagEndPosition == content.npos)
+            return std::nullopt;
+        const auto characters(content.substr("<![CDATA["sv.size(), tagEndPosition - "<![CDATA["sv.size()));
+        content.remove_prefix(tagEndPosition + "]]>"sv.size());
+        return characters;
+    }
+
+    // position of the "?>" that ends the processing instruction, or npos if the
+    // end of the processing instruction is not in the content
+    inline std::size_t findProcessingEnd(std::string_view content) {
+        assert(content.compare(0, "<?"sv.size(), "<?"sv) == 0);
+        return content.find("?>"sv, "<?"sv.size());
+    }
+
+    // parse processing instruction
+    inline std::pair<std::string_view, std::string_view> parseProcessing(std::string_view& content) {
+        assert(content.compare(0, "<?"sv.size(), "<?"sv) == 0);
+        content.remove_prefix("<?"sv.size());
+        const auto tagEndPosition = content.find("?>"sv);
+        if (tagEndPosition == content.npos) {
+            std::cerr << "parser error: Incomplete XML declaration\n";
+            exit(1);
+        }
+        auto nameEndPosition = findClass(content, NAMEEND_CHARACTER);
+        if (nameEndPosition == content.npos) {
+            std::cerr << "parser error : Unterminated processing instruction\n";
+            exit(1);
+        }
+        const auto target(content.substr(0, nameEndPosition));
+        const auto data(content.substr(nameEndPosition, tagEndPosition - nameEndPosition));
+        content.remove_prefix(tagEndPosition);
+        assert(content.compare(0, "?>"sv.size(), "?>"sv) == 0);
+        content.remove_prefix("?>"sv.size());
+        return std::pair(target, data);
+    }
+
+    // skip processing instruction
+    inline void skipProcessing(std::string_view& content) {
+        assert(content.compare(0, "<?"sv.size(), "<?"sv) == 0);
+        const auto tagEndPosition = content.find("?>"sv, "<?"sv.size());
+        if (tagEndPosition == content.npos) {
+            std::cerr << "parser error : Unterminated processing instruction\n";
+            exit(1);
+        }
+        content.remove_prefix(tagEndPosition + "?>"sv.size());
+    }
+
+    // parse a qualified name up to the end of the name
+    // Without splitting, the prefix is empty and the localName is the qName
+    template <bool splitQName = true>
+    inline void parseQName(std::string_view& content, std::string_view& qName, std::string_view& prefix, std::string_view& localName) {
+        if constexpr (!splitQName) {
+            qName = content.substr(0, findClass(content, QNAMEEND_CHARACTER));
+            prefix = std::string_view();
+            localName = qName;
+            content.remove_prefix(qName.size());
+            return;
+        }
+        auto nameEndPosition = findClass(content, NAMEEND_CHARACTER);
+        std::size_t colonPosition = 0;
+        if (nameEndPosition != content.npos && content[nameEndPosition] == ':') {
+            colonPosition = nameEndPosition;
+            nameEndPosition = findClass(content, NAMEEND_CHARACTER, nameEndPosition + 1);
+        }
+        qName = content.substr(0, nameEndPosition);
+        prefix = qName.substr(0, colonPosition);
+        localName = qName.substr(colonPosition ? colonPosition + 1 : 0);
+        content.remove_prefix(qName.size());
+    }
+
+    // parse end tag
+    template <bool splitQName = true>
+    inline void parseEndTag(std::string_view& content, std::string_view& qName, std::string_view& prefix, std::string_view& localName) {
+        assert(content.compare(0, "</"sv.size(), "</"sv) == 0);
+        content.remove_prefix("</"sv.size());
+        if (content[0] == ':') {
+            std::cerr << "parser error : Invalid end tag name\n";
+            exit(1);
+        }
+        parseQName<splitQName>(content, qName, prefix, localName);
+        if (content.empty()) {
+            std::cerr << "parser error : Unterminated end tag '" << qName << "'\n";
+            exit(1);
+        }
+        if (qName.empty()) {
+            std::cerr << "parser error: EndTag: invalid element name\n";
+            exit(1);
+        }
+        skipWhitespace(content);
+        assert(content.compare(0, ">"sv.size(), ">"sv) == 0);
+        content.remove_prefix(">"sv.size());
+    }
+
+    // skip end tag without parsing the name
+    inline void skipEndTag(std::string_view& content) {
+        assert(content.compare(0, "</"sv.size(), "</"sv) == 0);
+        const auto tagEndPosition = content.find('>', "</"sv.size());
+        if (tagEndPosition == content.npos) {
+            std::cerr << "parser error : Unterminated end tag\n";
+            exit(1);
+        }
+        content.remove_prefix(tagEndPosition + ">"sv.size());
+    }
+
+    // position of the '>' that ends the start tag, i.e., the first '>' outside of an
+    // attribute value, or npos if the end of the start tag is not in the content
+    inline std::size_t findStartTagEnd(std::string_view content) {
+        std::size_t pos = "<"sv.size();
+        while ((pos = findTagDelimiter(content, pos)) != content.npos && content[pos] != '>') {
+            pos = content.find(content[pos], pos + 1);
+            if (pos == content.npos)
+                break;
+            ++pos;
+        }
+        return pos;
+    }
+
+    // parse start tag
+    template <bool splitQName = true>
+    inline void parseStartTag(std::string_view& content, std::string_view& qName, std::string_view& prefix, std::string_view& localName) {
+        assert(content.compare(0, "<"sv.size(), "<"sv) == 0);
+        content.remove_prefix("<"sv.size());
+        if (content[0] == ':') {
+            std::cerr << "parser error : Invalid start tag name\n";
+            exit(1);
+        }
+        parseQName<splitQName>(content, qName, prefix, localName);
+        if (content.empty()) {
+            std::cerr << "parser error : Unterminated start tag '" << qName << "'\n";
+            exit(1);
+        }
+        if (qName.empty()) {
+            std::cerr << "parser error: StartTag: invalid element name\n";
+            exit(1);
+        }
+    }
+
+    // parse XML namespace
+    inline std::pair<std::string_view, std::string_view> parseNamespace(std::string_view& content) {
+        assert(content.compare(0, "xmlns"sv.size(), "xmlns"sv) == 0);
+        content.remove_prefix("xmlns"sv.size());
+        auto nameEndPosition = content.find('=');
+        if (nameEndPosition == content.npos) {
+            std::cerr << "parser error : incomplete namespace\n";
+            exit(1);
+        }
+        std::size_t prefixSize = 0;
+        if (content[0] == ':') {
+            content.remove_prefix(":"sv.size());
+            --nameEndPosition;
+            prefixSize = nameEndPosition;
+        }
+        const auto prefix(content.substr(0, prefixSize));
+        content.remove_prefix(nameEndPosition);
+        content.remove_prefix("="sv.size());
+        skipWhitespace(content);
+        if (content.empty()) {
+            std::cerr << "parser error : incomplete namespace\n";
+            exit(1);
+        }
+        const auto delimiter = content[0];
+        if (delimiter != '"' && delimiter != '\'') {
+            std::cerr << "parser error : incomplete namespace\n";
+            exit(1);
+        }
+        content.remove_prefix("\""sv.size());
+        const auto valueEndPosition = content.find(delimiter);
+        if (valueEndPosition == content.npos) {
+            std::cerr << "parser error : incomplete namespace\n";
+            exit(1);
+        }
+        const auto uri(content.substr(0, valueEndPosition));
+        content.remove_prefix(valueEndPosition);
+        assert(content.compare(0, "\""sv.size(), "\""sv) == 0);
+        content.remove_prefix("\""sv.size());
+        skipWhitespace(content);
+        return std::pair(prefix, uri);
+    }
+
+    // parse attribute, leaving the content at the end delimiter of the value
+    template <bool splitQName = true>
+    inline std::string_view parseAttribute(std::string_view& content, std::string_view& qName, std::string_view& prefix, std::string_view& localName) {
+        parseQName<splitQName>(content, qName, prefix, localName);
+        if (content.empty()) {
+            std::cerr << "parser error : Empty attribute name" << '\n';
+            exit(1);
+        }
+        skipWhitespace(content);
+        if (content.empty()) {
+            std::cerr << "parser error : attribute " << qName << " incomplete attribute\n";
+            exit(1);
+        }
+        if (content[0] != '=') {
+            std::cerr << "parser error : attribute " << qName << " missing =\n";
+            exit(1);
+        }
+        content.remove_prefix("="sv.size());
+        skipWhitespace(content);
+        const auto delimiter = content[0];
+        if (delimiter != '"' && delimiter != '\'') {
+            std::cerr << "parser error : attribute " << qName << " missing delimiter\n";
+            exit(1);
+        }
+        content.remove_prefix("\""sv.size());
+        const auto valueEndPosition = content.find(delimiter);
+        if (valueEndPosition == content.npos) {
+            std::cerr << "parser error : attribute " << qName << " missing delimiter\n";
+            exit(1);
+        }
+        const std::string_view value(content.substr(0, valueEndPosition));
+        content.remove_prefix(valueEndPosition);
+        return value;
+    }
 }
+
 #endif
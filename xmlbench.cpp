@@ -0,0 +1,503 @@
+/*
+    xmlbench.cpp
+
+    Benchmark of XMLParser against the XML parsers libxml2 (SAX), expat, and
+    pugixml (DOM), for the ones found when building (see CMakeLists.txt).
+
+    xmlbench [--repeat N] [--synthetic MB] file...
+
+    Each parser runs the same workloads on the same input in memory:
+    * elements, the count of the elements
+    * loc, the count of the newlines in the character content, as for srcFacts
+    * identity, a round trip of the content after the XML declaration to XML in memory
+
+    With the option --synthetic MB, a synthetic srcML archive of about MB
+    megabytes is made from copies of the first file and benchmarked after the files.
+
+    Each parser and workload runs in its own process, so the peak RSS is of
+    that parser, above the RSS of the inputs in memory. The throughput is of the fastest of
+    the repeated runs. The result, the count or the bytes of output, is
+    compared to that of XMLParser, so a parser that reads the input differently
+    shows up.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "XMLParser.hpp"
+#include "XMLParserHandler.hpp"
+#include "MappedFile.hpp"
+#include "xml_parser.hpp"
+#include "syntheticArchive.hpp"
+
+#ifdef HAVE_LIBXML2
+#include <libxml/parser.h>
+#include <libxml/SAX2.h>
+#endif
+
+#ifdef HAVE_EXPAT
+#include <expat.h>
+#endif
+
+#ifdef HAVE_PUGIXML
+#include <pugixml.hpp>
+#endif
+
+// provides literal string operator""sv
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+    // workloads, the same for each parser
+    enum class Workload { ELEMENTS, LOC, IDENTITY };
+
+    // names of the workloads
+    constexpr std::string_view WORKLOAD_NAMES[] = { "elements"sv, "loc"sv, "identity"sv };
+
+    // state of a workload, driven by the events of any parser
+    class BenchState {
+    public:
+        // constructor
+        BenchState(Workload workload) : workload(workload) {}
+
+        // start tag, with the attributes to follow
+        void startTag(std::string_view prefix, std::string_view localName) {
+            if (workload == Workload::ELEMENTS) {
+                ++count;
+            } else if (workload == Workload::IDENTITY) {
+                closeStartTag();
+                output += '<';
+                appendName(prefix, localName);
+                inStartTag = true;
+            }
+        }
+
+        // end tag
+        void endTag(std::string_view prefix, std::string_view localName) {
+            if (workload == Workload::IDENTITY) {
+                closeStartTag();
+                output += "</"sv;
+                appendName(prefix, localName);
+                output += '>';
+            }
+        }
+
+        // attribute of the start tag
+        void attribute(std::string_view prefix, std::string_view localName, std::string_view value) {
+            if (workload == Workload::IDENTITY) {
+                output += ' ';
+                appendName(prefix, localName);
+                output += "=\""sv;
+                appendEscaped(value);
+                output += '"';
+            }
+        }
+
+        // namespace declaration of the start tag
+        void xmlNamespace(std::string_view prefix, std::string_view uri) {
+            attribute(prefix.empty() ? ""sv : "xmlns"sv, prefix.empty() ? "xmlns"sv : prefix, uri);
+        }
+
+        // character content
+        void characters(std::string_view characters) {
+            if (workload == Workload::LOC) {
+                count += std::count(characters.begin(), characters.end(), '\n');
+            } else if (workload == Workload::IDENTITY) {
+                closeStartTag();
+                appendEscaped(characters);
+            }
+        }
+
+        // XML comment
+        void comment(std::string_view value) {
+            if (workload == Workload::IDENTITY) {
+                closeStartTag();
+                output += "<!--"sv;
+                output += value;
+                output += "-->"sv;
+            }
+        }
+
+        // processing instruction
+        void processingInstruction(std::string_view target, std::string_view data) {
+            if (workload == Workload::IDENTITY) {
+                closeStartTag();
+                output += "<?"sv;
+                output += target;
+                output += ' ';
+                output += data;
+                output += "?>"sv;
+            }
+        }
+
+        // result of the workload, a count, or the bytes of the output
+        long result() {
+            if (workload == Workload::IDENTITY) {
+                closeStartTag();
+                return static_cast<long>(output.size());
+            }
+            return count;
+        }
+
+        // clear for another run, keeping the output buffer
+        void clear() {
+            count = 0;
+            output.clear();
+            inStartTag = false;
+        }
+
+    private:
+        // end the start tag before any content
+        void closeStartTag() {
+            if (inStartTag) {
+                output += '>';
+                inStartTag = false;
+            }
+        }
+
+        // append the qualified name
+        void appendName(std::string_view prefix, std::string_view localName) {
+            if (!prefix.empty()) {
+                output += prefix;
+                output += ':';
+            }
+            output += localName;
+        }
+
+        // append the text with markup characters escaped
+        void appendEscaped(std::string_view text) {
+            while (!text.empty()) {
+                const auto pos = text.find_first_of("<>&\""sv);
+                output += text.substr(0, pos);
+                if (pos == text.npos)
+                    break;
+                switch (text[pos]) {
+                case '<':  output += "&lt;"sv;   break;
+                case '>':  output += "&gt;"sv;   break;
+                case '&':  output += "&amp;"sv;  break;
+                default:   output += "&quot;"sv; break;
+                }
+                text.remove_prefix(pos + 1);
+            }
+        }
+
+        Workload workload;
+        long count = 0;
+        std::string output;
+        bool inStartTag = false;
+    };
+
+    // handler of XMLParser events for the workload
+    class BenchHandler : public XMLParserHandler {
+    public:
+        // constructor
+        BenchHandler(BenchState& state) : state(state) {}
+
+        void handleStartTag(std::string_view qName, std::string_view prefix, std::string_view localName) override {
+            state.startTag(prefix, localName);
+        }
+
+        void handleEndTag(std::string_view qName, std::string_view prefix, std::string_view localName) override {
+            state.endTag(prefix, localName);
+        }
+
+        void handleCharacter(std::string_view characters) override {
+            state.characters(characters);
+        }
+
+        void handleAttribute(std::string_view qName, std::string_view prefix, std::string_view localName, std::string_view value) override {
+            state.attribute(prefix, localName, value);
+        }
+
+        void handleXMLNamespace(std::string_view prefix, std::string_view uri) override {
+            state.xmlNamespace(prefix, uri);
+        }
+
+        void handleXMLComment(std::string_view value) override {
+            state.comment(value);
+        }
+
+        void handleCDATA(std::string_view characters) override {
+            state.characters(characters);
+        }
+
+        void handleProcessingInstruction(std::string_view target, std::string_view data) override {
+            state.processingInstruction(target, data);
+        }
+
+    private:
+        BenchState& state;
+    };
+
+    // parse with XMLParser, or FactsXMLParser
+    template <class Parser>
+    bool parseXMLParser(std::string_view document, BenchState& state) {
+        BenchHandler handler(state);
+        Parser parser(document, handler);
+        parser.parse();
+        return true;
+    }
+
+#ifdef HAVE_LIBXML2
+    // view of a libxml2 string
+    std::string_view view(const xmlChar* s) {
+        return s ? std::string_view(reinterpret_cast<const char*>(s)) : ""sv;
+    }
+
+    // parse with the libxml2 SAX2 interface
+    bool parseLibxml2(std::string_view document, BenchState& state) {
+        xmlSAXHandler sax;
+        memset(&sax, 0, sizeof(sax));
+        sax.initialized = XML_SAX2_MAGIC;
+        sax.startElementNs = [](void* context, const xmlChar* localName, const xmlChar* prefix, const xmlChar*,
+                                int namespaceCount, const xmlChar** namespaces, int attributeCount, int,
+                                const xmlChar** attributes) {
+            auto& state = *static_cast<BenchState*>(context);
+            state.startTag(view(prefix), view(localName));
+            for (int i = 0; i < namespaceCount; ++i)
+                state.xmlNamespace(view(namespaces[2 * i]), view(namespaces[2 * i + 1]));
+
+            // localname, prefix, URI, value, and end of value of each attribute
+            for (int i = 0; i < attributeCount; ++i) {
+                const auto attribute = attributes + 5 * i;
+                const auto value = reinterpret_cast<const char*>(attribute[3]);
+                state.attribute(view(attribute[1]), view(attribute[0]),
+                                std::string_view(value, reinterpret_cast<const char*>(attribute[4]) - value));
+            }
+        };
+        sax.endElementNs = [](void* context, const xmlChar* localName, const xmlChar* prefix, const xmlChar*) {
+            static_cast<BenchState*>(context)->endTag(view(prefix), view(localName));
+        };
+        sax.characters = [](void* context, const xmlChar* characters, int length) {
+            static_cast<BenchState*>(context)->characters(std::string_view(reinterpret_cast<const char*>(characters), length));
+        };
+        sax.ignorableWhitespace = sax.characters;
+        sax.cdataBlock = sax.characters;
+        sax.comment = [](void* context, const xmlChar* value) {
+            static_cast<BenchState*>(context)->comment(view(value));
+        };
+        sax.processingInstruction = [](void* context, const xmlChar* target, const xmlChar* data) {
+            static_cast<BenchState*>(context)->processingInstruction(view(target), view(data));
+        };
+        return xmlSAXUserParseMemory(&sax, &state, document.data(), static_cast<int>(document.size())) == 0;
+    }
+#endif
+
+#ifdef HAVE_EXPAT
+    // parse with expat, without namespace processing, so namespace declarations are attributes
+    bool parseExpat(std::string_view document, BenchState& state) {
+        const auto parser = XML_ParserCreate(nullptr);
+        XML_SetUserData(parser, &state);
+        XML_SetElementHandler(parser,
+            [](void* context, const XML_Char* name, const XML_Char** attributes) {
+                auto& state = *static_cast<BenchState*>(context);
+                state.startTag(""sv, name);
+                for (int i = 0; attributes[i]; i += 2)
+                    state.attribute(""sv, attributes[i], attributes[i + 1]);
+            },
+            [](void* context, const XML_Char* name) {
+                static_cast<BenchState*>(context)->endTag(""sv, name);
+            });
+        XML_SetCharacterDataHandler(parser, [](void* context, const XML_Char* characters, int length) {
+            static_cast<BenchState*>(context)->characters(std::string_view(characters, length));
+        });
+        XML_SetCommentHandler(parser, [](void* context, const XML_Char* value) {
+            static_cast<BenchState*>(context)->comment(value);
+        });
+        XML_SetProcessingInstructionHandler(parser, [](void* context, const XML_Char* target, const XML_Char* data) {
+            static_cast<BenchState*>(context)->processingInstruction(target, data);
+        });
+        const auto status = XML_Parse(parser, document.data(), static_cast<int>(document.size()), 1);
+        XML_ParserFree(parser);
+        return status == XML_STATUS_OK;
+    }
+#endif
+
+#ifdef HAVE_PUGIXML
+    // visit the nodes of the pugixml document
+    void visit(const pugi::xml_node& node, BenchState& state) {
+        for (auto child = node.first_child(); child; child = child.next_sibling()) {
+            switch (child.type()) {
+            case pugi::node_element:
+                state.startTag(""sv, child.name());
+                for (auto attribute = child.first_attribute(); attribute; attribute = attribute.next_attribute())
+                    state.attribute(""sv, attribute.name(), attribute.value());
+                visit(child, state);
+                state.endTag(""sv, child.name());
+                break;
+            case pugi::node_pcdata:
+            case pugi::node_cdata:
+                state.characters(child.value());
+                break;
+            case pugi::node_comment:
+                state.comment(child.value());
+                break;
+            case pugi::node_pi:
+                state.processingInstruction(child.name(), child.value());
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    // parse into a pugixml document, and visit its nodes
+    bool parsePugixml(std::string_view document, BenchState& state) {
+        pugi::xml_document tree;
+        const auto options = pugi::parse_default | pugi::parse_ws_pcdata | pugi::parse_comments | pugi::parse_pi;
+        if (!tree.load_buffer(document.data(), document.size(), options, pugi::encoding_utf8))
+            return false;
+        visit(tree, state);
+        return true;
+    }
+#endif
+
+    // parser in the benchmark
+    struct BenchParser {
+        std::string_view name;
+        bool (*parse)(std::string_view document, BenchState& state);
+        bool identity;
+    };
+
+    // parsers in the benchmark, with XMLParser first as the reference result
+    const BenchParser PARSERS[] = {
+        { "XMLParser"sv,      parseXMLParser<XMLParser>,      true  },
+        { "FactsXMLParser"sv, parseXMLParser<FactsXMLParser>, false },
+#ifdef HAVE_LIBXML2
+        { "libxml2 SAX"sv,    parseLibxml2,                   true  },
+#endif
+#ifdef HAVE_EXPAT
+        { "expat"sv,          parseExpat,                     true  },
+#endif
+#ifdef HAVE_PUGIXML
+        { "pugixml DOM"sv,    parsePugixml,                   true  },
+#endif
+    };
+
+    // measurement of a parser on a workload
+    struct Measurement {
+        bool ok;
+        double seconds;
+        long result;
+        long peakRSS;
+    };
+
+    // peak RSS of this process
+    long peakRSS() {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<long>(usage.ru_maxrss) * 1024;
+    }
+
+    // run the parser on the workload in a child process, with the fastest of the repeats
+    // The peak RSS is above that at the start of the child, so it leaves out the inputs
+    Measurement measure(const BenchParser& parser, Workload workload, std::string_view document, int repeatCount) {
+        Measurement measurement{ false, 0, 0, 0 };
+        int results[2];
+        if (pipe(results) == -1)
+            return measurement;
+        const auto pid = fork();
+        if (pid == 0) {
+            close(results[0]);
+            const auto startRSS = peakRSS();
+            BenchState state(workload);
+            for (int i = 0; i < repeatCount; ++i) {
+                state.clear();
+                const auto startTime = std::chrono::steady_clock::now();
+                measurement.ok = parser.parse(document, state);
+                const auto result = state.result();
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+                if (!measurement.ok)
+                    break;
+                if (i == 0 || elapsed.count() < measurement.seconds)
+                    measurement.seconds = elapsed.count();
+                measurement.result = result;
+            }
+            measurement.peakRSS = peakRSS() - startRSS;
+            [[maybe_unused]] const auto written = write(results[1], &measurement, sizeof(measurement));
+            _exit(0);
+        }
+        close(results[1]);
+        if (pid == -1 || read(results[0], &measurement, sizeof(measurement)) != sizeof(measurement))
+            measurement.ok = false;
+        close(results[0]);
+        if (pid != -1)
+            waitpid(pid, nullptr, 0);
+        return measurement;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    int repeatCount = 5;
+    long syntheticMB = 0;
+    std::vector<std::string> filenames;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeatCount = std::stoi(argv[++i]);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            syntheticMB = std::stol(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            filenames.emplace_back(argv[i]);
+        } else {
+            std::cerr << "xmlbench: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    if (filenames.empty() || repeatCount < 1) {
+        std::cerr << "xmlbench: Usage: xmlbench [--repeat N] [--synthetic MB] file...\n";
+        return 1;
+    }
+
+    // inputs in memory, with padding after the content for XMLParser
+    std::vector<std::pair<std::string, std::string>> inputs;
+    for (const auto& filename : filenames) {
+        MappedFile file(filename);
+        inputs.emplace_back(filename.substr(filename.find_last_of('/') + 1), std::string(file.getContent()));
+    }
+    if (syntheticMB > 0)
+        inputs.emplace_back("synthetic-" + std::to_string(syntheticMB) + "MB", syntheticArchive(inputs.front().second, syntheticMB * 1000000));
+
+    std::cout << "# xmlbench\n";
+    std::cout << "| Input              |      MB | Workload |     Parser     |     MB/sec | Parse RSS MB |       Result |\n";
+    std::cout << "|:-------------------|--------:|:---------|:---------------|-----------:|-------------:|-------------:|\n";
+    std::cout << std::fixed;
+    for (auto& [name, content] : inputs) {
+        const auto size = content.size();
+        content.append(xml_parser::PADDING, '\0');
+        const std::string_view document(content.data(), size);
+        const auto megabytes = size / 1e6;
+        for (const auto workload : { Workload::ELEMENTS, Workload::LOC, Workload::IDENTITY }) {
+            long reference = 0;
+            for (const auto& parser : PARSERS) {
+                if (workload == Workload::IDENTITY && !parser.identity)
+                    continue;
+                const auto measurement = measure(parser, workload, document, repeatCount);
+                if (&parser == &PARSERS[0])
+                    reference = measurement.result;
+                std::cout << "| " << std::setw(18) << std::left << name
+                          << " | " << std::setw(7) << std::right << std::setprecision(2) << megabytes
+                          << " | " << std::setw(8) << std::left << WORKLOAD_NAMES[static_cast<int>(workload)]
+                          << " | " << std::setw(14) << parser.name << std::right;
+                if (!measurement.ok) {
+                    std::cout << " | " << std::setw(10) << "error" << " | " << std::setw(12) << "" << " | " << std::setw(12) << "" << " |\n";
+                    continue;
+                }
+                std::cout << " | " << std::setw(10) << std::setprecision(1) << megabytes / measurement.seconds
+                          << " | " << std::setw(12) << measurement.peakRSS / 1e6
+                          << " | " << std::setw(12) << measurement.result << " |"
+                          << (measurement.result != reference ? " differs from XMLParser" : "") << '\n';
+            }
+        }
+    }
+
+    return 0;
+}
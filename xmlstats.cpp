@@ -6,54 +6,140 @@
     number of each part of XML. E.g., the number of start
     tags, end tags, attributes, character sections, etc.
 
+    The option --partial outputs the counts as a partial result in JSON
+    instead of the report, e.g., to sum the stats of several files with srcmerge.
+
+    The option --profile outputs the counts, bytes, and time of each kind of
+    parse event after the performance statistics (see ParseProfile.hpp).
+
+    The option --perf-counters outputs the hardware performance counters of the
+    parse and of the report, e.g., cycles and cache misses (see PerfCounters.hpp).
+
+    The option --memory outputs the memory usage, i.e., peak RSS, the input
+    buffer, and the heap allocations of the parse (see memoryUsage.hpp).
+
+    The option --multiple-documents parses a stream of documents one after the
+    other, e.g., srcML documents written back to back to a pipe, with the stats
+    of all of them and a start and end document for each.
+
 */
 
 #include <iostream>
 #include <algorithm>
-#include <iomanip>
 #include <string_view>
-#include <cmath>
 #include <chrono>
+#include <cstring>
+#include <optional>
 #include "XMLStatsHandler.hpp"
 #include "XMLParser.hpp"
+#include "TapeReplayer.hpp"
+#include "partialResult.hpp"
+#include "reportXMLStats.hpp"
+#include "ParseProfile.hpp"
+#include "PerfCounters.hpp"
+#include "memoryUsage.hpp"
 
 // provides literal string operator""sv
 using namespace std::literals::string_view_literals;
 
-int main() {
+int main(int argc, char* argv[]) {
+    bool validateUTF8 = false;
+    bool checkWellFormed = false;
+    const char* tapeFilename = nullptr;
+    bool profile = false;
+    bool perfCounters = false;
+    bool memory = false;
+    bool partial = false;
+    bool multipleDocuments = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--validate-utf8") == 0) {
+            validateUTF8 = true;
+        } else if (strcmp(argv[i], "--wellformed") == 0) {
+            checkWellFormed = true;
+        } else if (strcmp(argv[i], "--tape") == 0 && i + 1 < argc) {
+            tapeFilename = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (strcmp(argv[i], "--perf-counters") == 0) {
+            perfCounters = true;
+        } else if (strcmp(argv[i], "--memory") == 0) {
+            memory = true;
+        } else if (strcmp(argv[i], "--partial") == 0) {
+            partial = true;
+        } else if (strcmp(argv[i], "--multiple-documents") == 0) {
+            multipleDocuments = true;
+        } else {
+            std::cerr << "xmlstats: Unknown option " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    if (profile && (!ParseProfile::compiledIn || tapeFilename)) {
+        std::cerr << "xmlstats: The option --profile requires profiling compiled in, cmake -DPROFILE=ON, and a parse\n";
+        return 1;
+    }
+
+    if (multipleDocuments && tapeFilename) {
+        std::cerr << "xmlstats: The option --multiple-documents requires a parse\n";
+        return 1;
+    }
+
+    std::optional<PerfCounters> counters;
+    if (perfCounters)
+        counters.emplace();
+
+    const auto startAllocations = getAllocationCounts();
     const auto startTime = std::chrono::steady_clock::now();
+    if (counters)
+        counters->start();
     std::string_view content;
     XMLStatsHandler handler;
-    XMLParser parser(content, handler);
+    ParseProfile parseProfile;
+    long totalBytes = 0;
+    if (tapeFilename) {
+        // replay the events of the tape
+        TapeReplayer tape(tapeFilename);
+        tape.replay(handler);
+        totalBytes = tape.getTotalBytes();
+    } else {
+        XMLParser parser(content, handler);
+        parser.setValidateUTF8(validateUTF8);
+        parser.setCheckWellFormed(checkWellFormed);
+        parser.setMultipleDocuments(multipleDocuments);
+        if (profile)
+            parser.setProfile(&parseProfile);
 
-    // parse XML
-    parser.parse();
+        // parse XML
+        parser.parse();
+        totalBytes = parser.getTotalBytes();
+    }
 
+    if (counters)
+        counters->stop("Parse"sv, totalBytes);
     const auto finishTime = std::chrono::steady_clock::now();
+    const auto finishAllocations = getAllocationCounts();
     const auto elapsedSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(finishTime - startTime).count();
     const auto MLOCPerSecond = handler.getLoc() / elapsedSeconds / 1000000;
-    std::cout.imbue(std::locale{""});
-    const auto valueWidth = std::max(5, static_cast<int>(log10(parser.getTotalBytes()) * 1.3 + 1));
-    std::cout << "# xmlStats: " << '\n';
-    std::cout << "| Measure                 | " << std::setw(valueWidth + 3) << "Value |\n";
-    std::cout << "|:------------------------|-" << std::setw(valueWidth + 3) << std::setfill('-')       << ":|\n" << std::setfill(' ');
-    std::cout << "| Start Document          | " << std::setw(valueWidth) << handler.getStartDocumentCount()          << " |\n";
-    std::cout << "| XML Declarations        | " << std::setw(valueWidth) << handler.getXMLDeclarationCount()         << " |\n";
-    std::cout << "| Start Tags              | " << std::setw(valueWidth) << handler.getStartTagCount()               << " |\n";
-    std::cout << "| End Tags                | " << std::setw(valueWidth) << handler.getEndTagCount()                 << " |\n";
-    std::cout << "| Characters              | " << std::setw(valueWidth) << handler.getCharactersCount()             << " |\n";
-    std::cout << "| Attributes              | " << std::setw(valueWidth) << handler.getAttributeCount()              << " |\n";
-    std::cout << "| XML Namespaces          | " << std::setw(valueWidth) << handler.getXMLNamespaceCount()           << " |\n";
-    std::cout << "| XML Comments            | " << std::setw(valueWidth) << handler.getXMLCommentCount()             << " |\n";
-    std::cout << "| CDATA                   | " << std::setw(valueWidth) << handler.getCDATACount()                  << " |\n";
-    std::cout << "| Processing Instructions | " << std::setw(valueWidth) << handler.getProcessingInstructionCount()  << " |\n";
-    std::cout << "| End Document            | " << std::setw(valueWidth) << handler.getEndDocumentCount()            << " |\n";
+    if (counters)
+        counters->start();
+    if (partial)
+        writePartialResult(std::cout, makePartialResult("xmlstats"sv, ""sv, totalBytes, handler));
+    else
+        reportXMLStats(handler, totalBytes);
+    if (counters)
+        counters->stop("Report"sv, totalBytes);
     std::clog.imbue(std::locale{""});
     std::clog.precision(3);
     std::clog << '\n';
-    std::clog << parser.getTotalBytes()  << " bytes\n";
+    std::clog << totalBytes  << " bytes\n";
     std::clog << elapsedSeconds << " sec\n";
     std::clog << MLOCPerSecond << " MLOC/sec\n";
+    if (profile)
+        parseProfile.report(std::clog);
+    if (counters)
+        counters->report(std::clog);
+    if (memory)
+        reportMemory(std::clog, { finishAllocations.count - startAllocations.count, finishAllocations.bytes - startAllocations.bytes }, totalBytes);
 
     return 0;
 }